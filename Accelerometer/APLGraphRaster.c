@@ -0,0 +1,134 @@
+/**
+ * APLGraphRaster.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "APLGraphRaster.h"
+#include <math.h>
+#include <string.h>
+
+uint32_t APLGraphRasterColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	const uint8_t bytes[4] = { r, g, b, a };
+	uint32_t color;
+	
+	memcpy(&color, bytes, sizeof(color));
+	return color;
+}
+
+void APLGraphRasterFill(APLGraphRaster *raster, uint32_t color)
+{
+	size_t row, x;
+	
+	for(x = 0; x < raster->width; ++x)
+		raster->pixels[x] = color;
+	for(row = 1; row < raster->height; ++row)
+		memcpy(raster->pixels + row * raster->stride, raster->pixels, raster->width * sizeof(uint32_t));
+}
+
+// Clip a pixel coordinate into [0, limit), reporting whether it was inside.
+static inline long ClampRow(double y, size_t limit)
+{
+	double row = floor(y);
+	
+	if(row < 0.0)
+		return -1;
+	if(row >= (double)limit)
+		return (long)limit;
+	return (long)row;
+}
+
+void APLGraphRasterHorizontalLine(APLGraphRaster *raster, double y, size_t x0, size_t x1, uint32_t color)
+{
+	long row = ClampRow(y, raster->height);
+	uint32_t *pixel;
+	size_t x;
+	
+	if(row < 0 || row >= (long)raster->height)
+		return;
+	if(x1 > raster->width)
+		x1 = raster->width;
+	pixel = raster->pixels + row * raster->stride;
+	for(x = x0; x < x1; ++x)
+		pixel[x] = color;
+}
+
+static inline void Run(APLGraphRaster *raster, size_t x, long top, long bottom, uint32_t color)
+{
+	uint32_t *pixel;
+	long row;
+	
+	// Both ends on the same side of the buffer means nothing is visible.
+	if(bottom < 0 || top >= (long)raster->height)
+		return;
+	if(top < 0)
+		top = 0;
+	if(bottom >= (long)raster->height)
+		bottom = (long)raster->height - 1;
+	pixel = raster->pixels + top * raster->stride + x;
+	for(row = top; row <= bottom; ++row, pixel += raster->stride)
+		*pixel = color;
+}
+
+void APLGraphRasterVerticalLine(APLGraphRaster *raster, size_t x, double y0, double y1, uint32_t color)
+{
+	long a = ClampRow(y0, raster->height), b = ClampRow(y1, raster->height);
+	
+	if(x >= raster->width)
+		return;
+	if(a > b)
+		Run(raster, x, b, a, color);
+	else
+		Run(raster, x, a, b, color);
+}
+
+void APLGraphRasterPolyline(APLGraphRaster *raster, const float *ys, size_t count, uint32_t color)
+{
+	size_t x, columns = count > 1 ? count - 1 : 0;
+	long previous, next;
+	
+	if(columns > raster->width)
+		columns = raster->width;
+	if(!columns)
+		return;
+	previous = ClampRow(ys[0], raster->height);
+	for(x = 0; x < columns; ++x)
+	{
+		next = ClampRow(ys[x + 1], raster->height);
+		if(previous > next)
+			Run(raster, x, next, previous, color);
+		else
+			Run(raster, x, previous, next, color);
+		previous = next;
+	}
+}
@@ -0,0 +1,78 @@
+/**
+ * APLGraphRaster.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Software rasterizer behind the APLGraphView segment layers.
+ 
+ Segments are drawn into a plain RGBA pixel buffer without any CoreGraphics state, so the same code
+ runs on any platform. Every primitive is axis aligned or steps one pixel column at a time, which is
+ all a scrolling plot needs: a polyline through one value per column is drawn as a vertical run per
+ column between neighbouring values, so each pixel is written once and nothing is antialiased.
+ Coordinates are in pixels with row 0 at the top, anything outside the buffer is clipped.
+ */
+
+#ifndef APLGraphRaster_h
+#define APLGraphRaster_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	// Pixels as R, G, B, A bytes in memory order.
+	uint32_t *pixels;
+	size_t width, height;
+	// Pixels from the start of one row to the start of the next.
+	size_t stride;
+} APLGraphRaster;
+
+uint32_t APLGraphRasterColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+
+void APLGraphRasterFill(APLGraphRaster *raster, uint32_t color);
+// Row floor(y) from column x0 up to but not including x1.
+void APLGraphRasterHorizontalLine(APLGraphRaster *raster, double y, size_t x0, size_t x1, uint32_t color);
+// Column x from row floor(y0) to row floor(y1), in either order.
+void APLGraphRasterVerticalLine(APLGraphRaster *raster, size_t x, double y0, double y1, uint32_t color);
+// Polyline through (i, ys[i]) for i < count, covering columns 0 to count - 2.
+void APLGraphRasterPolyline(APLGraphRaster *raster, const float *ys, size_t count, uint32_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
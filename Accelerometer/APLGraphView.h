@@ -52,9 +52,41 @@
 #import <UIKit/UIKit.h>
 #import <QuartzCore/QuartzCore.h>
 
+// Colors shared by every graph view.
+CGColorRef graphBackgroundColor(void);
+CGColorRef graphLineColor(void);
+CGColorRef graphChannelColor(NSUInteger channel);
+// A color as a pixel for APLGraphRaster.
+uint32_t graphRasterColor(CGColorRef color);
+
+/*
+ A scrolling plot of channelCount traces. Every graph has its own scale and layout, segments are drawn in layers segmentWidth pixels wide that are shared with other graphs through a pool once a graph no longer needs them, and one display link drives every graph.
+ */
 @interface APLGraphView : UIView
 
-@property float fullScale;
+// The value drawn at the top of the graph, its negation at the bottom.
+@property (nonatomic) float fullScale;
+// Number of traces, 3 by default. Changing it clears the graph.
+@property (nonatomic) NSUInteger channelCount;
+// Width in pixels of the layers the graph is drawn in, 32 by default. Changing it clears the graph.
+@property (nonatomic) NSUInteger segmentWidth;
+// One UIColor per channel. Channels without one are drawn red, green, blue and then in further hues.
+@property (nonatomic, copy) NSArray *channelColors;
+
+-(UIColor *)colorForChannel:(NSUInteger)channel;
+
+/*
+ Columns can be added from any thread. They wait in a ring until the next display frame, which draws all of them at once on the main thread.
+ */
+// Adds one pixel column for channels 0, 1 and 2, any further channels get 0.
 -(void)addX:(double)x y:(double)y z:(double)z;
+// Adds one pixel column drawn as an envelope between the lowest and highest value of each axis, see AccelerometerDecimator.
+-(void)addMinX:(double)minX maxX:(double)maxX minY:(double)minY maxY:(double)maxY minZ:(double)minZ maxZ:(double)maxZ;
+// Adds one pixel column from channelCount values, or channelCount lowest and highest values.
+-(void)addValues:(const double *)values;
+-(void)addMin:(const double *)min max:(const double *)max;
+
+// Remove everything drawn so far.
+-(void)clear;
 
 @end
@@ -50,6 +50,9 @@
  */
 
 #import "APLGraphView.h"
+#import "APLGraphRaster.h"
+#import <Accelerate/Accelerate.h>
+#import <pthread.h>
 
 #pragma mark - Quartz Helpers
 
@@ -73,7 +76,7 @@ CGColorRef CreateDeviceRGBColor(CGFloat r, CGFloat g, CGFloat b, CGFloat a)
     return color;
 }
 
-CGColorRef graphBackgroundColor()
+CGColorRef graphBackgroundColor(void)
 {
     static CGColorRef c = NULL;
     if (c == NULL)
@@ -83,7 +86,7 @@ CGColorRef graphBackgroundColor()
     return c;
 }
 
-CGColorRef graphLineColor()
+CGColorRef graphLineColor(void)
 {
     static CGColorRef c = NULL;
     if (c == NULL)
@@ -123,11 +126,26 @@ CGColorRef graphZColor()
     return c;
 }
 
-float scaleFactor = 16.0;
+CGColorRef graphChannelColor(NSUInteger channel)
+{
+    // X, Y and Z keep their original colors, further channels cycle through evenly spaced hues.
+    static CGColorRef c[8] = { NULL };
+    channel %= 8;
+    if (c[channel] == NULL)
+    {
+        CGFloat hue = channel < 3 ? 0.0 : (channel - 3) / 5.0 + 0.1;
+        c[channel] = channel == 0 ? graphXColor() : channel == 1 ? graphYColor() : channel == 2 ? graphZColor() :
+                     CGColorRetain([UIColor colorWithHue:hue saturation:1.0 brightness:0.8 alpha:1.0].CGColor);
+    }
+    return c[channel];
+}
 
-void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
+/*
+ Draws one grid line per unit of the full scale range, where scale is the number of pixels per unit and halfHeight the pixels between 0 and full scale.
+ */
+void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width, CGFloat scale, CGFloat halfHeight)
 {
-    for (CGFloat y = -48.5; y <= 48.5; y += scaleFactor)
+    for (CGFloat y = -halfHeight - 0.5; scale > 0.0 && y <= halfHeight + 0.5; y += scale)
     {
         CGContextMoveToPoint(context, x, y);
         CGContextAddLineToPoint(context, x + width, y);
@@ -136,60 +154,122 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
     CGContextStrokePath(context);
 }
 
+
+#pragma mark - APLGraphView internals
+
+@class APLGraphViewSegment;
+
+@interface APLGraphView()
+
+// Internal accessors
+@property (nonatomic) NSMutableArray *segments;
+@property (nonatomic, weak) APLGraphViewSegment *current;
+@property (nonatomic, weak) UIView *textView;
+// Holds every segment layer so that scrolling moves one layer per frame instead of each segment per value.
+@property (nonatomic) CALayer *segmentContainer;
+// Pixels per unit, full scale maps to the top of the graph less a small margin.
+@property (nonatomic, readonly) CGFloat scale;
+
+-(void)drawPendingValues;
+-(BOOL)hasPendingValues;
+
+@end
+
+
 #pragma mark - GraphViewSegment
 
 /*
- The GraphViewSegment manages up to 32 values and a CALayer that it updates with the segment of the graph that those values represent.
+ The GraphViewSegment manages up to width values per channel and a CALayer that it updates with the segment of the graph that those values represent. The scale and colors come from the graph currently using the segment.
  */
 
 @interface APLGraphViewSegment : NSObject
 
+-(id)initWithChannelCount:(NSUInteger)channelCount width:(NSUInteger)width;
 
-// Returns true if adding this value fills the segment, which is necessary for properly updating the segments.
--(BOOL)addX:(double)x y:(double)y z:(double)z;
+/*
+ Adds one pixel column, given as the lowest and highest value of each channel it covers. Returns true if adding this column fills the segment, which is necessary for properly updating the segments.
+ */
+-(BOOL)addMin:(const double *)min max:(const double *)max;
 
 /*
  When this object gets recycled (when it falls off the end of the graph) -reset is sent to clear values and prepare for reuse.
 */
 -(void)reset;
 
-// Returns true if this segment has consumed 32 values.
+// Returns true if this segment has consumed width values.
 -(BOOL)isFull;
 
 // Returns true if the layer for this segment is visible in the given rect.
 -(BOOL)isVisibleInRect:(CGRect)r;
 
+// Size the layer for a graph of the given height.
+-(void)setHeight:(CGFloat)height;
+
 // The layer that this segment is drawing into.
 @property(nonatomic, readonly) CALayer *layer;
+@property(nonatomic, readonly) NSUInteger channelCount;
+@property(nonatomic, readonly) NSUInteger width;
+@property(nonatomic, weak) APLGraphView *graph;
 
 @end
 
 
+/*
+ Rows -displayLayer: computes the channel values in. Segments are only drawn on the main thread, so every segment of every graph shares them.
+ */
+static float *drawRows;
+static NSUInteger drawCapacity;
+
+static void ReserveDrawBuffers(NSUInteger values)
+{
+    if (values > drawCapacity)
+    {
+        drawRows = realloc(drawRows, values * sizeof(float));
+        drawCapacity = values;
+    }
+}
+
+uint32_t graphRasterColor(CGColorRef color)
+{
+    CGFloat r = 0.0, g = 0.0, b = 0.0, a = 1.0;
+    [[UIColor colorWithCGColor:color] getRed:&r green:&g blue:&b alpha:&a];
+    return APLGraphRasterColor(lround(r * 255.0), lround(g * 255.0), lround(b * 255.0), 255);
+}
+
+static void ReleasePixels(void *info, const void *data, size_t size)
+{
+    free((void *)data);
+}
+
+
 @implementation APLGraphViewSegment
 {
-    // Need 33 values to fill 32 pixel width.
-    double xhistory[33];
-    double yhistory[33];
-    double zhistory[33];
+    /*
+     Need width + 1 values to fill width pixels. Columns of a single sample have the same min and max.
+     All channels live in one buffer, every channel's minimums followed by every channel's maximums, so they can be scaled in a single pass.
+     */
+    float *history;
     int index;
 }
 
 
--(id)init
+-(id)initWithChannelCount:(NSUInteger)channelCount width:(NSUInteger)width
 {
     self = [super init];
     if (self != nil)
     {
+        _channelCount = channelCount;
+        _width = width;
+        history = calloc(2 * channelCount * (width + 1), sizeof(float));
         _layer = [[CALayer alloc] init];
         /*
-         The layer will call our -drawLayer:inContext: method to provide content and our -actionForLayer:forKey: for implicit animations.
+         The layer will call our -displayLayer: method to provide content and our -actionForLayer:forKey: for implicit animations.
          */
         _layer.delegate = self;
         /*
-         This sets our coordinate system such that it has an origin of 0.0,-56 and a size of 32,112.
-         This would need to be changed if you change either the number of pixel values that a segment represented, or if you changed the size of the graph view.
+         This sets our coordinate system such that it has an origin of 0.0,-56 and a size of width,112 until the graph sets its own height.
          */
-        _layer.bounds = CGRectMake(0.0, -56.0, 32.0, 112.0);
+        [self setHeight:112.0];
         /*
          Disable blending as this layer consists of non-transperant content. Unlike UIView, a CALayer defaults to opaque=NO
          */
@@ -197,19 +277,29 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
         /*
          Index represents how many slots are left to be filled in the graph, which is also +1 compared to the array index that a new entry will be added.
          */
-        index = 33;
+        index = (int)width + 1;
     }
     return self;
 }
 
 
+-(void)dealloc
+{
+    free(history);
+}
+
+
+-(void)setHeight:(CGFloat)height
+{
+    self.layer.bounds = CGRectMake(0.0, -height / 2.0, self.width, height);
+}
+
+
 -(void)reset
 {
-    // Clear out our components and reset the index to 33 to start filling values again.
-    memset(xhistory, 0, sizeof(xhistory));
-    memset(yhistory, 0, sizeof(yhistory));
-    memset(zhistory, 0, sizeof(zhistory));
-    index = 33;
+    // Clear out our components and reset the index to width + 1 to start filling values again.
+    memset(history, 0, 2 * self.channelCount * (self.width + 1) * sizeof(float));
+    index = (int)self.width + 1;
     // Inform Core Animation that this layer needs to be redrawn.
     [self.layer setNeedsDisplay];
 }
@@ -229,79 +319,207 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 }
 
 
--(BOOL)addX:(double)x y:(double)y z:(double)z
+-(BOOL)addMin:(const double *)min max:(const double *)max
 {
     // If this segment is not full, add a new value to the history.
     if (index > 0)
     {
         // First decrement, both to get to a zero-based index and to flag one fewer position left.
         --index;
-        xhistory[index] = x;
-        yhistory[index] = y;
-        zhistory[index] = z;
-        // And inform Core Animation to redraw the layer.
-        [self.layer setNeedsDisplay];
+        NSUInteger columns = self.width + 1, channels = self.channelCount;
+        for (NSUInteger channel = 0; channel < channels; ++channel)
+        {
+            history[channel * columns + index] = min[channel];
+            history[(channels + channel) * columns + index] = max[channel];
+        }
+        // The graph view asks Core Animation to redraw the layer once per frame rather than once per value.
     }
     // And return if we are now full or not (really just avoids needing to call isFull after adding a value).
     return index == 0;
 }
 
 
--(void)drawLayer:(CALayer*)l inContext:(CGContextRef)context
+/*
+ The segment renders itself with the software rasterizer and hands Core Animation the finished image, so the layer never needs a CoreGraphics context.
+ */
+-(void)displayLayer:(CALayer *)layer
 {
+    APLGraphView *graph = self.graph;
+    // Pooled segments have nothing to draw until a graph takes them.
+    if (graph == nil)
+    {
+        return;
+    }
+    size_t width = self.width, height = lround(self.layer.bounds.size.height);
+    if (height == 0)
+    {
+        return;
+    }
+    uint32_t *pixels = malloc(width * height * sizeof(uint32_t));
+    APLGraphRaster raster = { pixels, width, height, width };
+    float half = height / 2.0;
+    
     // Fill in the background.
-    CGContextSetFillColorWithColor(context, graphBackgroundColor());
-    CGContextFillRect(context, self.layer.bounds);
+    APLGraphRasterFill(&raster, graphRasterColor(graphBackgroundColor()));
 
     // Draw the grid lines.
-    DrawGridlines(context, 0.0, 32.0);
+    uint32_t lineColor = graphRasterColor(graphLineColor());
+    for (CGFloat y = -(half - 8.0) - 0.5; graph.scale > 0.0 && y <= half - 8.0 + 0.5; y += graph.scale)
+    {
+        APLGraphRasterHorizontalLine(&raster, y + half, 0, width, lineColor);
+    }
 
     // Draw the graph.
-    CGPoint lines[64];
-    int i;
+    NSUInteger columns = width + 1, channels = self.channelCount, values = 2 * channels * columns;
+    ReserveDrawBuffers(values);
     
-    // X
-    for (i = 0; i < 32; ++i)
+    // Turn every channel into pixel rows at once, values grow upwards from the middle row.
+    float scale = -graph.scale;
+    vDSP_vsmsa(history, 1, &scale, &half, drawRows, 1, values);
+    
+    // Each channel is a polyline through its minimums, one through its maximums and a bar spanning each column.
+    for (NSUInteger channel = 0; channel < channels; ++channel)
     {
-        lines[i*2].x = i;
-        lines[i*2].y = -xhistory[i] * scaleFactor;
-        lines[i*2+1].x = i + 1;
-        lines[i*2+1].y = -xhistory[i+1] * scaleFactor;
+        const float *low = history + channel * columns, *high = history + (channels + channel) * columns;
+        const float *lowRows = drawRows + channel * columns, *highRows = drawRows + (channels + channel) * columns;
+        uint32_t color = graphRasterColor([graph colorForChannel:channel].CGColor);
+        APLGraphRasterPolyline(&raster, lowRows, columns, color);
+        APLGraphRasterPolyline(&raster, highRows, columns, color);
+        for (NSUInteger i = 0; i < columns; ++i)
+        {
+            // Single sample columns have nothing to span.
+            if (high[i] > low[i])
+            {
+                APLGraphRasterVerticalLine(&raster, MIN(i, width - 1), lowRows[i], highRows[i], color);
+            }
+        }
     }
-    CGContextSetStrokeColorWithColor(context, graphXColor());
-    CGContextStrokeLineSegments(context, lines, 64);
+    
+    CGDataProviderRef provider = CGDataProviderCreateWithData(NULL, pixels, width * height * sizeof(uint32_t), ReleasePixels);
+    CGColorSpaceRef rgb = CGColorSpaceCreateDeviceRGB();
+    CGImageRef image = CGImageCreate(width, height, 8, 32, width * sizeof(uint32_t), rgb, kCGImageAlphaNoneSkipLast | kCGBitmapByteOrderDefault,
+                                     provider, NULL, false, kCGRenderingIntentDefault);
+    layer.contents = (__bridge id)image;
+    CGImageRelease(image);
+    CGColorSpaceRelease(rgb);
+    CGDataProviderRelease(provider);
+}
 
-    // Y
-    for (i = 0; i < 32; ++i)
+
+-(id)actionForLayer:(CALayer *)layer forKey :(NSString *)key
+{
+    // We disable all actions for the layer, so no content cross fades, no implicit animation on moves, etc.
+    return [NSNull null];
+}
+
+
+// The accessibilityValue of this segment should be the channel values last added.
+- (NSString *)accessibilityValue
+{
+    NSUInteger columns = self.width + 1, channels = self.channelCount, last = MIN((NSUInteger)index, self.width);
+    NSMutableArray *values = [NSMutableArray arrayWithCapacity:channels];
+    for (NSUInteger channel = 0; channel < channels; ++channel)
     {
-        lines[i*2].y = -yhistory[i] * scaleFactor;
-        lines[i*2+1].y = -yhistory[i+1] * scaleFactor;
+        [values addObject:[NSString stringWithFormat:@"%.2f", history[(channels + channel) * columns + last]]];
     }
-    CGContextSetStrokeColorWithColor(context, graphYColor());
-    CGContextStrokeLineSegments(context, lines, 64);
+    return [values componentsJoinedByString:@", "];
+}
+
+@end
+
 
-    // Z
-    for (i = 0; i < 32; ++i)
+#pragma mark - Segment Pool
+
+/*
+ Segments that no graph is using, kept so graphs created later or cleared graphs do not need to create new layers. Segments are matched on channel count and width.
+ */
+#define kSegmentPoolLimit 64
+
+static NSMutableArray *segmentPool;
+
+static APLGraphViewSegment *DequeueSegment(NSUInteger channelCount, NSUInteger width)
+{
+    for (NSUInteger i = segmentPool.count; i > 0; --i)
     {
-        lines[i*2].y = -zhistory[i] * scaleFactor;
-        lines[i*2+1].y = -zhistory[i+1] * scaleFactor;
+        APLGraphViewSegment *segment = segmentPool[i - 1];
+        if (segment.channelCount == channelCount && segment.width == width)
+        {
+            [segmentPool removeObjectAtIndex:i - 1];
+            return segment;
+        }
     }
-    CGContextSetStrokeColorWithColor(context, graphZColor());
-    CGContextStrokeLineSegments(context, lines, 64);
+    return [[APLGraphViewSegment alloc] initWithChannelCount:channelCount width:width];
 }
 
+static void EnqueueSegment(APLGraphViewSegment *segment)
+{
+    [segment.layer removeFromSuperlayer];
+    segment.graph = nil;
+    if (segmentPool == nil)
+    {
+        segmentPool = [[NSMutableArray alloc] init];
+    }
+    if (segmentPool.count < kSegmentPoolLimit)
+    {
+        [segment reset];
+        [segmentPool addObject:segment];
+    }
+}
 
--(id)actionForLayer:(CALayer *)layer forKey :(NSString *)key
+
+#pragma mark - Shared Display Link
+
+/*
+ One display link drives every graph. Graphs in a window with pending values register themselves and are drained once per frame, the link is paused while no graph has anything to draw. A graph that leaves its window is dropped from the link, its columns wait in its ring until it is back in one.
+ */
+
+@interface APLGraphDisplayLink : NSObject
++(void)scheduleGraph:(APLGraphView *)graph;
++(void)unscheduleGraph:(APLGraphView *)graph;
+@end
+
+
+static CADisplayLink *sharedDisplayLink;
+static NSHashTable *scheduledGraphs;
+
+
+@implementation APLGraphDisplayLink
+
++(void)scheduleGraph:(APLGraphView *)graph
 {
-    // We disable all actions for the layer, so no content cross fades, no implicit animation on moves, etc.
-    return [NSNull null];
+    if (graph.window == nil)
+    {
+        return;
+    }
+    if (sharedDisplayLink == nil)
+    {
+        scheduledGraphs = [NSHashTable weakObjectsHashTable];
+        sharedDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkFired:)];
+        [sharedDisplayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    }
+    [scheduledGraphs addObject:graph];
+    sharedDisplayLink.paused = NO;
 }
 
 
-// The accessibilityValue of this segment should be the x,y,z values last added.
-- (NSString *)accessibilityValue
++(void)unscheduleGraph:(APLGraphView *)graph
+{
+    [scheduledGraphs removeObject:graph];
+    sharedDisplayLink.paused = scheduledGraphs.count == 0;
+}
+
+
++(void)displayLinkFired:(CADisplayLink *)link
 {
-    return [NSString stringWithFormat:NSLocalizedString(@"graphSegmentFormat", @"Format string for accessibility text for last x, y, z values added"), xhistory[index], yhistory[index], zhistory[index]];
+    for (APLGraphView *graph in scheduledGraphs.allObjects)
+    {
+        [graph drawPendingValues];
+        if (![graph hasPendingValues])
+        {
+            [scheduledGraphs removeObject:graph];
+        }
+    }
+    link.paused = scheduledGraphs.count == 0;
 }
 
 @end
@@ -324,12 +542,13 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 -(void)drawRect:(CGRect)rect
 {
     CGContextRef context = UIGraphicsGetCurrentContext();
+    CGFloat half = self.bounds.size.height / 2.0;
 
     // Fill in the background.
     CGContextSetFillColorWithColor(context, graphBackgroundColor());
     CGContextFillRect(context, self.bounds);
 
-    CGContextTranslateCTM(context, 0.0, 56.0);
+    CGContextTranslateCTM(context, 0.0, half);
 
     // Draw the grid lines.
     //DrawGridlines(context, 26.0, 6.0);
@@ -344,9 +563,9 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
     NSDictionary *attributes = @{ NSFontAttributeName:systemFont,
                                   NSParagraphStyleAttributeName:paragraphStyle };
     
-    [@"+F" drawInRect:CGRectMake(2.0, -56.0, 24.0, 16.0) withAttributes:attributes];
+    [@"+F" drawInRect:CGRectMake(2.0, -half, 24.0, 16.0) withAttributes:attributes];
     [@"0.0" drawInRect:CGRectMake(2.0,  -8.0, 24.0, 16.0) withAttributes:attributes];
-    [@"-F" drawInRect:CGRectMake(2.0,  40.0, 24.0, 16.0) withAttributes:attributes];
+    [@"-F" drawInRect:CGRectMake(2.0,  half - 16.0, 24.0, 16.0) withAttributes:attributes];
 }
 
 @end
@@ -359,18 +578,36 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
  GraphView handles the public interface as well as arranging the subviews and sublayers to produce the intended effect.
 */
 
-@interface APLGraphView()
-
-// Internal accessors
-@property (nonatomic) NSMutableArray *segments;
-@property (nonatomic, weak) APLGraphViewSegment *current;
-@property (nonatomic, weak) APLGraphTextView *textView;
+/*
+ Columns waiting for the next display frame. Only the newest columns can still be on screen once a frame is drawn, so when more than kPendingCapacity columns arrive between two frames the oldest ones are dropped. Keep this above the widest graph.
+ */
+#define kPendingCapacity 2048
 
-@end
+// Rebase segment positions once the scroll offset gets this large so CGFloat keeps whole pixel precision.
+#define kMaximumScrollOffset 1048576.0
 
+#define kDefaultChannelCount 3
+#define kDefaultSegmentWidth 32
 
 
 @implementation APLGraphView
+{
+    // Columns may be added from any thread, the ring of pending columns is guarded by pendingLock.
+    pthread_mutex_t pendingLock;
+    // Ring buffers of pending columns, pendingChannels values per column, pendingStart is the oldest.
+    double *pendingMin;
+    double *pendingMax;
+    NSUInteger pendingChannels;
+    NSUInteger pendingStart;
+    NSUInteger pendingCount;
+    // Main thread only, the columns of one frame once they are out of the ring.
+    double *drainMin;
+    double *drainMax;
+    // Number of values the graph has scrolled by, which is the x position of the segment container.
+    CGFloat scrollOffset;
+    // Height the segments are currently sized for.
+    CGFloat height;
+}
 
 // Designated initializer.
 -(id)initWithFrame:(CGRect)frame
@@ -398,54 +635,342 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 
 -(void)commonInit
 {
+    pthread_mutex_init(&pendingLock, NULL);
+    _channelCount = kDefaultChannelCount;
+    _segmentWidth = kDefaultSegmentWidth;
+    _fullScale = 3.0;
+    height = self.bounds.size.height > 0.0 ? self.bounds.size.height : 112.0;
+    _scale = (height / 2.0 - 8.0) / _fullScale;
+    
     // Create a mutable array to store segments, which is required by -addSegment.
     _segments = [[NSMutableArray alloc] init];
     
     /*
      Create the text view and add it as a subview. We keep a weak reference to that view afterwards for laying out the segment layers.
      */
-    APLGraphTextView *text = [[APLGraphTextView alloc] initWithFrame:CGRectMake(0.0, 0.0, 32.0, 112.0)];
+    APLGraphTextView *text = [[APLGraphTextView alloc] initWithFrame:CGRectMake(0.0, 0.0, 32.0, height)];
     [self addSubview:text];
     _textView = text;
     
+    // The container sits below the text view, segment layers are positioned inside it relative to scrollOffset.
+    _segmentContainer = [[CALayer alloc] init];
+    _segmentContainer.anchorPoint = CGPointZero;
+    _segmentContainer.frame = self.layer.bounds;
+    _segmentContainer.masksToBounds = NO;
+    _segmentContainer.actions = @{ @"position" : [NSNull null], @"bounds" : [NSNull null] };
+    [self.layer insertSublayer:_segmentContainer below:text.layer];
+    
+    [self clear];
+}
+
+
+-(void)dealloc
+{
+    free(pendingMin);
+    free(pendingMax);
+    free(drainMin);
+    free(drainMax);
+    pthread_mutex_destroy(&pendingLock);
+    for (APLGraphViewSegment *segment in _segments)
+    {
+        EnqueueSegment(segment);
+    }
+}
+
+
+-(void)clear
+{
+    // Hand every segment back to the pool and start over with a single segment.
+    for (APLGraphViewSegment *segment in self.segments)
+    {
+        EnqueueSegment(segment);
+    }
+    [self.segments removeAllObjects];
+    
+    NSUInteger values = kPendingCapacity * self.channelCount;
+    pthread_mutex_lock(&pendingLock);
+    free(pendingMin);
+    free(pendingMax);
+    pendingMin = malloc(values * sizeof(double));
+    pendingMax = malloc(values * sizeof(double));
+    pendingChannels = self.channelCount;
+    pendingStart = 0;
+    pendingCount = 0;
+    pthread_mutex_unlock(&pendingLock);
+    free(drainMin);
+    free(drainMax);
+    drainMin = malloc(values * sizeof(double));
+    drainMax = malloc(values * sizeof(double));
+    
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    scrollOffset = 0.0;
+    self.segmentContainer.position = CGPointZero;
+    [CATransaction commit];
+    
     /*
-     Create a new current segment, which is required by -addX:y:z and other methods.
+     Create a new current segment, which is required by -addMin:max: and other methods.
      This is also a weak reference (we assume that the 'segments' array will keep the strong reference).
      */
-    _current = [self addSegment];
+    self.current = [self addSegment];
+}
+
+
+-(void)setChannelCount:(NSUInteger)channelCount
+{
+    if (channelCount != _channelCount && channelCount > 0)
+    {
+        _channelCount = channelCount;
+        [self clear];
+    }
+}
+
+
+-(void)setSegmentWidth:(NSUInteger)segmentWidth
+{
+    if (segmentWidth != _segmentWidth && segmentWidth > 0)
+    {
+        _segmentWidth = segmentWidth;
+        [self clear];
+    }
+}
+
+
+-(void)setFullScale:(float)fullScale
+{
+    if (fullScale == _fullScale || fullScale <= 0.0)
+    {
+        return;
+    }
+    _fullScale = fullScale;
+    [self updateScale];
+}
+
+
+-(void)setChannelColors:(NSArray *)channelColors
+{
+    _channelColors = [channelColors copy];
+    [self setNeedsDisplayOnSegments];
+}
+
+
+-(UIColor *)colorForChannel:(NSUInteger)channel
+{
+    if (channel < self.channelColors.count)
+    {
+        return self.channelColors[channel];
+    }
+    return [UIColor colorWithCGColor:graphChannelColor(channel)];
+}
+
+
+-(void)updateScale
+{
+    _scale = (height / 2.0 - 8.0) / self.fullScale;
+    [self setNeedsDisplay];
+    [self setNeedsDisplayOnSegments];
+}
+
+
+-(void)setNeedsDisplayOnSegments
+{
+    for (APLGraphViewSegment *segment in self.segments)
+    {
+        [segment.layer setNeedsDisplay];
+    }
 }
 
 
 -(void)addX:(double)x y:(double)y z:(double)z
 {
-    scaleFactor = 48.0 / self.fullScale;
+    [self addMinX:x maxX:x minY:y maxY:y minZ:z maxZ:z];
+}
+
+
+-(void)addMinX:(double)minX maxX:(double)maxX minY:(double)minY maxY:(double)maxY minZ:(double)minZ maxZ:(double)maxZ
+{
+    // Channels past z stay at 0, and only x, y and z are kept on graphs with fewer channels.
+    double min[3] = { minX, minY, minZ }, max[3] = { maxX, maxY, maxZ };
+    [self addMin:min max:max channels:3];
+}
+
+
+-(void)addValues:(const double *)values
+{
+    [self addMin:values max:values];
+}
+
+
+-(void)addMin:(const double *)min max:(const double *)max
+{
+    [self addMin:min max:max channels:self.channelCount];
+}
+
+
+/*
+ Queue the column, it is drawn on the next display frame together with everything else that arrived. The channel count is taken under the lock, so a column added from another thread while the main thread changes channelCount is cut or padded with 0 to fit the ring.
+ */
+-(void)addMin:(const double *)min max:(const double *)max channels:(NSUInteger)count
+{
+    pthread_mutex_lock(&pendingLock);
+    if (pendingCount == kPendingCapacity)
+    {
+        pendingStart = (pendingStart + 1) % kPendingCapacity;
+        --pendingCount;
+    }
+    NSUInteger channels = pendingChannels, copied = MIN(count, channels);
+    double *slotMin = pendingMin + (pendingStart + pendingCount) % kPendingCapacity * channels;
+    double *slotMax = pendingMax + (pendingStart + pendingCount) % kPendingCapacity * channels;
+    memcpy(slotMin, min, copied * sizeof(double));
+    memcpy(slotMax, max, copied * sizeof(double));
+    memset(slotMin + copied, 0, (channels - copied) * sizeof(double));
+    memset(slotMax + copied, 0, (channels - copied) * sizeof(double));
+    BOOL schedule = pendingCount++ == 0;
+    pthread_mutex_unlock(&pendingLock);
     
-    // First, add the new value to the current segment.
-    if ([self.current addX:x y:y z:z])
+    if (schedule)
     {
-        /*
-         If after doing that we've filled up the current segment, then we need to determine the next current segment.
-         */
-        [self recycleSegment];
-        // To keep the graph looking continuous, add the value to the new segment as well.
-        [self.current addX:x y:y z:z];
+        if ([NSThread isMainThread])
+        {
+            [APLGraphDisplayLink scheduleGraph:self];
+        }
+        else
+        {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [APLGraphDisplayLink scheduleGraph:self];
+            });
+        }
+    }
+}
+
+
+-(void)didMoveToWindow
+{
+    [super didMoveToWindow];
+    if (self.window == nil)
+    {
+        [APLGraphDisplayLink unscheduleGraph:self];
     }
+    else if ([self hasPendingValues])
+    {
+        [APLGraphDisplayLink scheduleGraph:self];
+    }
+}
+
+
+-(BOOL)hasPendingValues
+{
+    pthread_mutex_lock(&pendingLock);
+    BOOL pending = pendingCount > 0;
+    pthread_mutex_unlock(&pendingLock);
+    return pending;
+}
+
+
+// Feed every pending column into the segments, then redraw and scroll once.
+-(void)drawPendingValues
+{
     /*
-     After adding a new data point, advance the x-position of all the segment layers by 1 to create the illusion that the graph is advancing.
-    */
+     Once this frame is drawn only the newest columns that fit across the graph can be on screen, everything older would scroll off before it is seen. Dropping those keeps the work of a frame bounded by the width of the graph rather than by how fast columns arrive.
+     */
+    NSUInteger visible = (NSUInteger)ceil(self.bounds.size.width) + self.segmentWidth;
+    
+    // Take the columns out of the ring so other threads can keep adding while they are drawn.
+    pthread_mutex_lock(&pendingLock);
+    NSUInteger channels = pendingChannels, count = MIN(pendingCount, visible);
+    NSUInteger first = (pendingStart + pendingCount - count) % kPendingCapacity;
+    NSUInteger head = MIN(count, kPendingCapacity - first);
+    memcpy(drainMin, pendingMin + first * channels, head * channels * sizeof(double));
+    memcpy(drainMax, pendingMax + first * channels, head * channels * sizeof(double));
+    memcpy(drainMin + head * channels, pendingMin, (count - head) * channels * sizeof(double));
+    memcpy(drainMax + head * channels, pendingMax, (count - head) * channels * sizeof(double));
+    pendingStart = 0;
+    pendingCount = 0;
+    pthread_mutex_unlock(&pendingLock);
+    if (count == 0)
+    {
+        return;
+    }
+    
+    NSMutableSet *dirty = [NSMutableSet set];
+    [dirty addObject:self.current];
+    for (NSUInteger i = 0; i < count; ++i)
+    {
+        const double *min = drainMin + i * channels, *max = drainMax + i * channels;
+        // First, add the new value to the current segment.
+        if ([self.current addMin:min max:max])
+        {
+            /*
+             If after doing that we've filled up the current segment, then we need to determine the next current segment.
+             */
+            [self recycleSegment];
+            // To keep the graph looking continuous, add the value to the new segment as well.
+            [self.current addMin:min max:max];
+            [dirty addObject:self.current];
+        }
+        // Every value advances the graph by 1, which is applied to the container below.
+        scrollOffset += 1.0;
+    }
+    if (scrollOffset > kMaximumScrollOffset)
+    {
+        [self rebaseSegments];
+    }
+    
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    for (APLGraphViewSegment *segment in dirty)
+    {
+        [segment.layer setNeedsDisplay];
+    }
+    self.segmentContainer.position = CGPointMake(scrollOffset, 0.0);
+    [CATransaction commit];
+}
+
+
+// Move the scroll offset back to 0 without changing where any segment is on screen.
+-(void)rebaseSegments
+{
     for (APLGraphViewSegment *segment in self.segments)
     {
         CGPoint position = segment.layer.position;
-        position.x += 1.0;
+        position.x += scrollOffset;
         segment.layer.position = position;
     }
+    scrollOffset = 0.0;
+}
+
+
+-(void)layoutSubviews
+{
+    [super layoutSubviews];
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    self.segmentContainer.bounds = self.layer.bounds;
+    
+    // Resize every segment when the graph changes height, keeping them centered on the 0 line.
+    CGFloat newHeight = self.bounds.size.height;
+    if (newHeight > 0.0 && newHeight != height)
+    {
+        height = newHeight;
+        self.textView.frame = CGRectMake(0.0, 0.0, 32.0, height);
+        [self.textView setNeedsDisplay];
+        for (APLGraphViewSegment *segment in self.segments)
+        {
+            [segment setHeight:height];
+            CGPoint position = segment.layer.position;
+            position.y = height / 2.0;
+            segment.layer.position = position;
+        }
+        [self updateScale];
+    }
+    [CATransaction commit];
 }
 
 /*
  kSegmentInitialPosition defines the initial position of a segment that is meant to be displayed on the left side of the graph.
  This positioning is meant so that a few entries must be added to the segment's history before it becomes visible to the user. This value could be tweaked a little bit with varying results, but the X coordinate should never be larger than 16 (the center of the text view) or the zero values in the segment's history will be exposed to the user.
  */
-#define kSegmentInitialPosition CGPointMake(14.0, 56.0);
+#define kSegmentInitialPosition CGPointMake(14.0, height / 2.0);
 
 
 /*
@@ -453,8 +978,10 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
  */
 -(APLGraphViewSegment*)addSegment
 {
-    // Create a new segment and add it to the segments array.
-    APLGraphViewSegment * segment = [[APLGraphViewSegment alloc] init];
+    // Take a segment from the shared pool, or create one, and add it to the segments array.
+    APLGraphViewSegment * segment = DequeueSegment(self.channelCount, self.segmentWidth);
+    segment.graph = self;
+    [segment setHeight:height];
     
     /*
      Add the new segment at the front of the array because -recycleSegment expects the oldest segment to be at the end of the array. As long as we always insert the youngest segment at the front this will be true.
@@ -463,15 +990,24 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 
     /* Ensure that newly added segment layers are placed after the text view's layer so that the text view always renders above the segment layer.
      */
-    [self.layer insertSublayer:segment.layer below:self.textView.layer];
+    [self.segmentContainer addSublayer:segment.layer];
     
     // Position the segment properly (see the comment for kSegmentInitialPosition).
-    segment.layer.position = kSegmentInitialPosition;
+    segment.layer.position = [self initialSegmentPosition];
 
     return segment;
 }
 
 
+// kSegmentInitialPosition in the coordinates of the segment container, which has scrolled by scrollOffset.
+-(CGPoint)initialSegmentPosition
+{
+    CGPoint position = kSegmentInitialPosition;
+    position.x -= scrollOffset;
+    return position;
+}
+
+
 // Recycles a segment from 'segments' into 'current'.
 -(void)recycleSegment
 {
@@ -479,7 +1015,7 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
      Start with the last object in the segments array, because it should either be visible onscreen (which indicates that we need more segments) or pushed offscreen (which makes it eligible for recycling).
      */
     APLGraphViewSegment * last = [self.segments lastObject];
-    if ([last isVisibleInRect:self.layer.bounds])
+    if ([last isVisibleInRect:CGRectOffset(self.layer.bounds, -scrollOffset, 0.0)])
     {
         // The last segment is still visible, so create a new segment, which is now the current segment.
         self.current = [self addSegment];
@@ -489,7 +1025,7 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
         // The last segment is no longer visible, so reset it in preperation for being recycled.
         [last reset];
         // Position the segment properly (see the comment for kSegmentInitialPosition).
-        last.layer.position = kSegmentInitialPosition;
+        last.layer.position = [self initialSegmentPosition];
         /*
          Move the segment from the last position in the array to the first position in the array because it is now the youngest segment,
          */
@@ -513,8 +1049,8 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 
     // Draw the grid lines.
     CGFloat width = self.bounds.size.width;
-    CGContextTranslateCTM(context, 0.0, 56.0);
-    DrawGridlines(context, 0.0, width);
+    CGContextTranslateCTM(context, 0.0, height / 2.0);
+    DrawGridlines(context, 0.0, width, self.scale, height / 2.0 - 8.0);
 }
 
 
@@ -533,4 +1069,3 @@ void DrawGridlines(CGContextRef context, CGFloat x, CGFloat width)
 
 
 @end
-
@@ -0,0 +1,191 @@
+/**
+ * APLHistoryGraphView.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "APLHistoryGraphView.h"
+#import "APLGraphRaster.h"
+#import "APLGraphView.h"
+
+// Deepest zoom, in columns per sample.
+#define kMaximumColumnsPerSample 8.0
+
+@implementation APLHistoryGraphView
+{
+    AccelerometerEnvelope *envelopes;
+    NSUInteger envelopeCapacity;
+    double pinchStartLength;
+}
+
+- (id)initWithFrame:(CGRect)frame
+{
+    self = [super initWithFrame:frame];
+    if (self != nil) {
+        _fullScale = 2.0;
+        self.opaque = YES;
+        self.contentMode = UIViewContentModeRedraw;
+        [self addGestureRecognizer:[[UIPinchGestureRecognizer alloc] initWithTarget:self action:@selector(pinched:)]];
+        [self addGestureRecognizer:[[UIPanGestureRecognizer alloc] initWithTarget:self action:@selector(panned:)]];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(envelopes);
+}
+
+- (void)setPyramid:(AccelerometerLODPyramid *)pyramid
+{
+    _pyramid = pyramid;
+    _visibleStart = 0.0;
+    _visibleLength = MAX(pyramid.count, 1);
+    [self setNeedsDisplay];
+}
+
+- (void)setFullScale:(float)fullScale
+{
+    _fullScale = fullScale;
+    [self setNeedsDisplay];
+}
+
+- (void)setVisibleStart:(double)start length:(double)length
+{
+    double width = MAX(self.bounds.size.width, 1.0);
+    double count = MAX(self.pyramid.count, 1);
+    _visibleLength = MIN(MAX(length, width / kMaximumColumnsPerSample), count);
+    _visibleStart = MIN(MAX(start, 0.0), count - _visibleLength);
+    [self setNeedsDisplay];
+}
+
+- (void)setVisibleStart:(double)visibleStart
+{
+    [self setVisibleStart:visibleStart length:self.visibleLength];
+}
+
+- (void)setVisibleLength:(double)visibleLength
+{
+    [self setVisibleStart:self.visibleStart length:visibleLength];
+}
+
+- (void)pinched:(UIPinchGestureRecognizer *)pinch
+{
+    if (pinch.state == UIGestureRecognizerStateBegan) {
+        pinchStartLength = self.visibleLength;
+    }
+    if (pinch.state == UIGestureRecognizerStateChanged && pinch.scale > 0.0) {
+        // Keep the sample under the pinch where it is.
+        double fraction = [pinch locationInView:self].x / MAX(self.bounds.size.width, 1.0);
+        double anchor = self.visibleStart + fraction * self.visibleLength;
+        double length = pinchStartLength / pinch.scale;
+        [self setVisibleStart:anchor - fraction * length length:length];
+    }
+}
+
+- (void)panned:(UIPanGestureRecognizer *)pan
+{
+    CGFloat dx = [pan translationInView:self].x;
+    [pan setTranslation:CGPointZero inView:self];
+    [self setVisibleStart:self.visibleStart - dx * self.visibleLength / MAX(self.bounds.size.width, 1.0)];
+}
+
+- (void)drawRect:(CGRect)rect
+{
+    // Rasterize at the resolution of the screen, every column of pixels gets its own envelope.
+    CGFloat contentScale = self.contentScaleFactor;
+    size_t width = (size_t)lround(self.bounds.size.width * contentScale), height = (size_t)lround(self.bounds.size.height * contentScale);
+    if (!width || !height) {
+        return;
+    }
+    // Out of memory skips the frame, the old envelopes stay until a larger buffer is in hand.
+    if (self.pyramid.count && width > envelopeCapacity) {
+        AccelerometerEnvelope *grown = realloc(envelopes, width * sizeof(AccelerometerEnvelope));
+        if (!grown) {
+            return;
+        }
+        envelopes = grown;
+        envelopeCapacity = width;
+    }
+    uint32_t *pixels = malloc(width * height * sizeof(uint32_t));
+    if (!pixels) {
+        return;
+    }
+    APLGraphRaster raster = { pixels, width, height, width };
+    double half = height / 2.0, range = half - 8.0 * contentScale;
+    double scale = range / self.fullScale;
+    
+    APLGraphRasterFill(&raster, graphRasterColor(graphBackgroundColor()));
+    uint32_t lineColor = graphRasterColor(graphLineColor());
+    for (double y = -range - 0.5; scale > 0.0 && y <= range + 0.5; y += scale) {
+        APLGraphRasterHorizontalLine(&raster, y + half, 0, width, lineColor);
+    }
+    
+    if (self.pyramid.count) {
+        [self.pyramid getEnvelopes:envelopes columns:width start:self.visibleStart length:self.visibleLength];
+        
+        // Milli-G to rows, each column a run between the lowest and highest value joined to its neighbour.
+        const uint32_t colors[3] = { graphRasterColor(graphChannelColor(0)), graphRasterColor(graphChannelColor(1)), graphRasterColor(graphChannelColor(2)) };
+        double rowsPerMilliG = -scale / 1000.0;
+        for (int axis = 0; axis < 3; axis++) {
+            double previousTop = 0.0, previousBottom = 0.0;
+            BOOL hasPrevious = NO;
+            for (size_t x = 0; x < width; x++) {
+                if (envelopes[x].min[axis] > envelopes[x].max[axis]) {
+                    hasPrevious = NO;
+                    continue;
+                }
+                double top = half + envelopes[x].max[axis] * rowsPerMilliG;
+                double bottom = half + envelopes[x].min[axis] * rowsPerMilliG;
+                if (hasPrevious) {
+                    APLGraphRasterVerticalLine(&raster, x, MIN(top, previousBottom), MAX(bottom, previousTop), colors[axis]);
+                } else {
+                    APLGraphRasterVerticalLine(&raster, x, top, bottom, colors[axis]);
+                }
+                previousTop = top;
+                previousBottom = bottom;
+                hasPrevious = YES;
+            }
+        }
+    }
+    
+    CGColorSpaceRef rgb = CGColorSpaceCreateDeviceRGB();
+    CGContextRef bitmap = CGBitmapContextCreate(pixels, width, height, 8, width * sizeof(uint32_t), rgb, kCGImageAlphaNoneSkipLast | kCGBitmapByteOrderDefault);
+    CGImageRef image = CGBitmapContextCreateImage(bitmap);
+    [[UIImage imageWithCGImage:image scale:contentScale orientation:UIImageOrientationUp] drawInRect:self.bounds];
+    CGImageRelease(image);
+    CGContextRelease(bitmap);
+    CGColorSpaceRelease(rgb);
+    free(pixels);
+}
+
+@end
@@ -0,0 +1,82 @@
+/**
+ * AccelerometerCSVExporter.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerCSVExporter.h"
+#import "AccelerometerCSVFormat.h"
+
+@implementation AccelerometerCSVExporter
+
++ (NSData *)CSVDataWithSampleStore:(AccelerometerSampleStore *)store
+{
+    NSUInteger total = store.count;
+    if (total == 0) {
+        return [NSData data];
+    }
+    
+    // Collect the spans up front so every one can be formatted independently.
+    NSUInteger spanCount = 0;
+    AccelerometerSampleSpan *spans = malloc((total / kAccelerometerSampleStoreChunkSize + 2) * sizeof(AccelerometerSampleSpan));
+    size_t *lengths = malloc((total / kAccelerometerSampleStoreChunkSize + 2) * sizeof(size_t));
+    NSMutableData *data = total <= SIZE_MAX / kAccelerometerCSVMaxLineLength ? [NSMutableData dataWithLength:total * kAccelerometerCSVMaxLineLength] : nil;
+    if (!spans || !lengths || !data) {
+        free(spans);
+        free(lengths);
+        return nil;
+    }
+    for (NSUInteger index = 0; index < total; index += spans[spanCount++].count) {
+        [store getSpan:&spans[spanCount] atIndex:index];
+    }
+    
+    // A span formats at the offset of its longest possible lines, so no two spans overlap.
+    char *bytes = data.mutableBytes;
+    uint64_t epochMicros = llround(store.epoch * kAccelerometerSampleStoreTicksPerSecond);
+    dispatch_apply(spanCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        lengths[i] = AccelerometerCSVFormat(bytes + spans[i].start * kAccelerometerCSVMaxLineLength, spans[i].tick,
+                                            spans[i].x, spans[i].y, spans[i].z, spans[i].count, epochMicros);
+    });
+    
+    // Every span ends up at or before where it was formatted, so moving them in order is safe.
+    size_t length = 0;
+    for (NSUInteger i = 0; i < spanCount; i++) {
+        memmove(bytes + length, bytes + spans[i].start * kAccelerometerCSVMaxLineLength, lengths[i]);
+        length += lengths[i];
+    }
+    data.length = length;
+    free(lengths);
+    free(spans);
+    return data;
+}
+
+@end
@@ -0,0 +1,93 @@
+/**
+ * AccelerometerCSVFormat.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerCSVFormat.h"
+
+static inline char *WriteUnsigned(char *out, uint64_t value)
+{
+	char digits[20];
+	int n = 0;
+	
+	do
+	{
+		digits[n++] = (char)('0' + value % 10);
+		value /= 10;
+	} while(value);
+	while(n)
+		*out++ = digits[--n];
+	return out;
+}
+
+static inline char *WriteInt(char *out, int value)
+{
+	if(value < 0)
+	{
+		*out++ = '-';
+		return WriteUnsigned(out, (uint64_t)-(int64_t)value);
+	}
+	return WriteUnsigned(out, (uint64_t)value);
+}
+
+// Microseconds since 1970 as seconds with exactly 6 decimals, the same text "%f" produces.
+static inline char *WriteTimestamp(char *out, uint64_t micros)
+{
+	uint64_t fraction = micros % 1000000, scale;
+	
+	out = WriteUnsigned(out, micros / 1000000);
+	*out++ = '.';
+	for(scale = 100000; scale; scale /= 10)
+		*out++ = (char)('0' + (fraction / scale) % 10);
+	return out;
+}
+
+size_t AccelerometerCSVFormat(char *out, const uint64_t *ticks, const int16_t *x, const int16_t *y, const int16_t *z,
+							  size_t count, uint64_t epochMicros)
+{
+	char *start = out;
+	size_t i;
+	
+	for(i = 0; i < count; ++i)
+	{
+		out = WriteTimestamp(out, epochMicros + ticks[i]);
+		*out++ = ',';
+		out = WriteInt(out, x[i]);
+		*out++ = ',';
+		out = WriteInt(out, y[i]);
+		*out++ = ',';
+		out = WriteInt(out, z[i]);
+		*out++ = '\n';
+	}
+	return (size_t)(out - start);
+}
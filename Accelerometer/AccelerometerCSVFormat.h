@@ -0,0 +1,69 @@
+/**
+ * AccelerometerCSVFormat.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ The "timestamp,x,y,z" text format of AccelerometerCSVExporter. Plain C, so the formatter is shared by
+ the app and the Linux tests.
+ 
+ Numbers are formatted by hand straight into a byte buffer, each line is byte for byte what
+ printf("%f,%d,%d,%d\n") gives for the timestamp in seconds since 1970 and x, y, z in milli-G.
+ */
+
+#ifndef AccelerometerCSVFormat_h
+#define AccelerometerCSVFormat_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest possible line: 20 digit seconds, 6 decimals, three int16 values, separators and newline.
+#define kAccelerometerCSVMaxLineLength		64
+
+/*
+ Write count lines into out, which must hold count * kAccelerometerCSVMaxLineLength bytes. The
+ timestamp of line i is epochMicros + ticks[i] microseconds. Returns the number of bytes written, no
+ terminating zero is added.
+ */
+size_t AccelerometerCSVFormat(char *out, const uint64_t *ticks, const int16_t *x, const int16_t *y, const int16_t *z,
+							  size_t count, uint64_t epochMicros);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
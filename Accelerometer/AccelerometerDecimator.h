@@ -0,0 +1,74 @@
+/**
+ * AccelerometerDecimator.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Streaming min/max decimation of accelerometer samples for display.
+ 
+ Samples are grouped into columns of columnDuration seconds and every completed column is reported
+ as the minimum and maximum of each axis. A graph fed with columns instead of samples scrolls at a
+ fixed rate and draws a fixed number of points per second whatever the sample frequency, without
+ losing spikes that fall between columns. Reductions run through vDSP.
+ 
+ Column boundaries are tracked as a fraction of a sample, so at 2.5 samples per column columns
+ alternate between 3 and 2 samples. At low rates where a sample lasts longer than a column, the
+ sample is reported once for every column it spans.
+ */
+
+typedef struct {
+    float min[3];
+    float max[3];
+} AccelerometerEnvelope;
+
+typedef void (^AccelerometerDecimatorHandler)(AccelerometerEnvelope envelope);
+
+@interface AccelerometerDecimator : NSObject
+
+// Both must be positive.
+- (id)initWithSampleRate:(double)rate columnDuration:(NSTimeInterval)duration;
+
+- (void)addX:(float)x y:(float)y z:(float)z;
+- (void)addSamplesX:(const float *)xs y:(const float *)ys z:(const float *)zs count:(NSUInteger)count;
+
+// Drop a partially filled column.
+- (void)reset;
+
+@property (nonatomic, copy) AccelerometerDecimatorHandler handler;
+
+@property (nonatomic, readonly) double sampleRate;
+@property (nonatomic, readonly) double samplesPerColumn;
+
+@end
@@ -0,0 +1,133 @@
+/**
+ * AccelerometerDecimator.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerDecimator.h"
+#import <Accelerate/Accelerate.h>
+
+// A column boundary this close to a whole sample falls on it, absorbs rounding in the accumulator.
+#define kAccelerometerDecimatorEpsilon 1e-9
+
+@implementation AccelerometerDecimator
+{
+    float *column[3];
+    NSUInteger filled;
+    // Samples, possibly fractional, still to come before the current column closes.
+    double remaining;
+    AccelerometerEnvelope last;
+}
+
+- (id)initWithSampleRate:(double)rate columnDuration:(NSTimeInterval)duration
+{
+    self = [super init];
+    if (self != nil) {
+        _sampleRate = rate;
+        _samplesPerColumn = rate * duration;
+        remaining = _samplesPerColumn;
+        NSUInteger capacity = (NSUInteger)ceil(_samplesPerColumn) + 1;
+        for (int axis = 0; axis < 3; axis++) {
+            column[axis] = malloc(capacity * sizeof(float));
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (int axis = 0; axis < 3; axis++) {
+        free(column[axis]);
+    }
+}
+
+- (void)emitX:(const float *)xs y:(const float *)ys z:(const float *)zs count:(NSUInteger)count
+{
+    const float *axes[3] = { xs, ys, zs };
+    for (int axis = 0; axis < 3; axis++) {
+        vDSP_minv(axes[axis], 1, &last.min[axis], count);
+        vDSP_maxv(axes[axis], 1, &last.max[axis], count);
+    }
+    if (self.handler) {
+        self.handler(last);
+    }
+}
+
+- (void)addX:(float)x y:(float)y z:(float)z
+{
+    [self addSamplesX:&x y:&y z:&z count:1];
+}
+
+- (void)addSamplesX:(const float *)xs y:(const float *)ys z:(const float *)zs count:(NSUInteger)count
+{
+    NSUInteger done = 0;
+    while (done < count) {
+        // Whole samples that close the current column, at least one.
+        NSUInteger need = (NSUInteger)ceil(remaining - kAccelerometerDecimatorEpsilon);
+        NSUInteger run = MIN(count - done, need);
+        remaining -= run;
+        if (run < need) {
+            memcpy(column[0] + filled, xs + done, run * sizeof(float));
+            memcpy(column[1] + filled, ys + done, run * sizeof(float));
+            memcpy(column[2] + filled, zs + done, run * sizeof(float));
+            filled += run;
+            break;
+        }
+        // Whole columns are reduced straight from the input.
+        if (filled == 0) {
+            [self emitX:xs + done y:ys + done z:zs + done count:run];
+        } else {
+            memcpy(column[0] + filled, xs + done, run * sizeof(float));
+            memcpy(column[1] + filled, ys + done, run * sizeof(float));
+            memcpy(column[2] + filled, zs + done, run * sizeof(float));
+            [self emitX:column[0] y:column[1] z:column[2] count:filled + run];
+            filled = 0;
+        }
+        done += run;
+        remaining += _samplesPerColumn;
+        // A sample longer than a column fills the columns it spans.
+        while (remaining < kAccelerometerDecimatorEpsilon) {
+            if (self.handler) {
+                self.handler(last);
+            }
+            remaining += _samplesPerColumn;
+        }
+    }
+}
+
+- (void)reset
+{
+    filled = 0;
+    remaining = _samplesPerColumn;
+}
+
+@end
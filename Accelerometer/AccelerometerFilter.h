@@ -47,22 +47,42 @@
 
 #import <UIKit/UIKit.h>
 #import <MetaWear/MetaWear.h>
+#import "AccelerometerFilterKernels.h"
 
 // Basic filter object. 
 @interface AccelerometerFilter : NSObject
 {
 	BOOL adaptive;
-	UIAccelerationValue x, y, z;
+	BOOL fastAdaptive;
+	AccelerometerFilterState state;
 }
 
 // Add a UIAcceleration to the filter.
 - (void)addAcceleration:(MBLAccelerometerData*)accel;
 
+// Add a batch of samples, one array per axis, to the filter.
+- (void)addSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count;
+
+// Add a batch of samples and write the filter output after each one into outX, outY and outZ.
+- (void)filterSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+			   outputX:(double *)outX y:(double *)outY z:(double *)outZ;
+
+/*
+ Zero phase filter a recorded buffer in place, one array per axis. The axes are processed in
+ parallel and the running filter state is left untouched. Adaptive filtering does not apply here.
+ */
+- (void)filtfiltX:(double *)xs y:(double *)ys z:(double *)zs count:(NSUInteger)count;
+
+// Describe the filter as a biquad cascade and return the section count, 0 means pass through.
+- (size_t)getSections:(AccelerometerBiquad *)sections;
+
 @property (nonatomic, readonly) UIAccelerationValue x;
 @property (nonatomic, readonly) UIAccelerationValue y;
 @property (nonatomic, readonly) UIAccelerationValue z;
 
 @property (nonatomic, getter=isAdaptive) BOOL adaptive;
+// Adaptive filtering on squared magnitudes, see AccelerometerAdaptiveMode.
+@property (nonatomic, getter=isFastAdaptive) BOOL fastAdaptive;
 @property (unsafe_unretained, nonatomic, readonly) NSString *name;
 
 @end
@@ -73,7 +93,6 @@
 @interface LowpassFilter : AccelerometerFilter
 {
 	double filterConstant;
-	UIAccelerationValue lastX, lastY, lastZ;
 }
 
 - (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq;
@@ -86,9 +105,32 @@
 @interface HighpassFilter : AccelerometerFilter
 {
 	double filterConstant;
-	UIAccelerationValue lastX, lastY, lastZ;
 }
 
 - (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq;
 
+@end
+
+#pragma mark -
+
+// A filter class to represent a higher order Butterworth or Chebyshev filter built from a cascade of biquad sections.
+@interface BiquadFilter : AccelerometerFilter
+{
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	AccelerometerBiquadState sectionStates[kAccelerometerBiquadMaxSections];
+	size_t sectionCount;
+	AccelerometerBiquadResponse response;
+	double ripple;
+}
+
+// Butterworth design, order may be 1 through kAccelerometerBiquadMaxOrder.
+- (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq order:(NSUInteger)order response:(AccelerometerBiquadResponse)response;
+// Chebyshev type I design with the given passband ripple in dB.
+- (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq order:(NSUInteger)order response:(AccelerometerBiquadResponse)response ripple:(double)rippleDB;
+
+// Clear the delay lines, for example before filtering an unrelated recording.
+- (void)reset;
+
+@property (nonatomic, readonly) NSUInteger order;
+
 @end
\ No newline at end of file
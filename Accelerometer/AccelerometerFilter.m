@@ -51,41 +51,92 @@
 
 @implementation AccelerometerFilter
 
-@synthesize x, y, z, adaptive;
+@synthesize adaptive, fastAdaptive;
 
 - (void)addAcceleration:(MBLAccelerometerData *)accel
 {
-	x = accel.x;
-	y = accel.y;
-	z = accel.z;
+	state.x = accel.x;
+	state.y = accel.y;
+	state.z = accel.z;
 }
 
-- (NSString *)name
+- (void)addSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
 {
-	return @"You should not see this";
+	[self filterSamplesX:xs y:ys z:zs count:count outputX:NULL y:NULL z:NULL];
 }
 
-@end
+- (void)filterSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+			   outputX:(double *)outX y:(double *)outY z:(double *)outZ
+{
+	if(count == 0)
+		return;
+	
+	if(outX)
+	{
+		for(NSUInteger i = 0; i < count; ++i)
+		{
+			outX[i] = xs[i];
+			outY[i] = ys[i];
+			outZ[i] = zs[i];
+		}
+	}
+	state.x = xs[count - 1];
+	state.y = ys[count - 1];
+	state.z = zs[count - 1];
+}
 
+- (void)filtfiltX:(double *)xs y:(double *)ys z:(double *)zs count:(NSUInteger)count
+{
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	size_t sectionCount = [self getSections:sections];
+	
+	if(sectionCount == 0 || count == 0)
+		return;
+	
+	// Blocks cannot capture arrays, dispatch_apply is synchronous so pointers to the stack are fine.
+	const AccelerometerBiquad *cascade = sections;
+	double *axes[3] = { xs, ys, zs };
+	double **axis = axes;
+	dispatch_apply(3, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+		AccelerometerBiquadFiltfilt(cascade, sectionCount, axis[i], count);
+	});
+}
 
-#pragma mark -
+- (size_t)getSections:(AccelerometerBiquad *)sections
+{
+	return 0;
+}
 
-#define kAccelerometerMinStep				0.02
-#define kAccelerometerNoiseAttenuation		3.0
+- (UIAccelerationValue)x
+{
+	return state.x;
+}
 
-double Norm(double x, double y, double z)
+- (UIAccelerationValue)y
 {
-	return sqrt(x * x + y * y + z * z);
+	return state.y;
 }
 
-double Clamp(double v, double min, double max)
+- (UIAccelerationValue)z
 {
-	if(v > max)
-		return max;
-	else if(v < min)
-		return min;
-	else
-		return v;
+	return state.z;
+}
+
+- (NSString *)name
+{
+	return @"You should not see this";
+}
+
+@end
+
+
+#pragma mark -
+
+static AccelerometerAdaptiveMode AdaptiveMode(BOOL adaptive, BOOL fastAdaptive)
+{
+	if(!adaptive)
+		return AccelerometerAdaptiveOff;
+	return fastAdaptive ? AccelerometerAdaptiveFast : AccelerometerAdaptiveExact;
 }
 
 
@@ -108,17 +159,21 @@ double Clamp(double v, double min, double max)
 
 - (void)addAcceleration:(MBLAccelerometerData *)accel
 {
-	double alpha = filterConstant;
-	
-	if(adaptive)
-	{
-		double d = Clamp(fabs(Norm(x, y, z) - Norm(accel.x, accel.y, accel.z)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
-		alpha = (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
-	}
-	
-	x = accel.x * alpha + x * (1.0 - alpha);
-	y = accel.y * alpha + y * (1.0 - alpha);
-	z = accel.z * alpha + z * (1.0 - alpha);
+	AccelerometerLowpassStep(&state, filterConstant, AdaptiveMode(adaptive, fastAdaptive), accel.x, accel.y, accel.z);
+}
+
+- (void)filterSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+			   outputX:(double *)outX y:(double *)outY z:(double *)outZ
+{
+	AccelerometerLowpassRun(&state, filterConstant, AdaptiveMode(adaptive, fastAdaptive), xs, ys, zs, outX, outY, outZ, count);
+}
+
+- (size_t)getSections:(AccelerometerBiquad *)sections
+{
+	// y[n] = alpha x[n] + (1 - alpha) y[n-1]
+	AccelerometerBiquad c = { filterConstant, 0.0, 0.0, filterConstant - 1.0, 0.0 };
+	sections[0] = c;
+	return 1;
 }
 
 - (NSString *)name
@@ -148,26 +203,86 @@ double Clamp(double v, double min, double max)
 
 - (void)addAcceleration:(MBLAccelerometerData *)accel
 {
-	double alpha = filterConstant;
-	
-	if (adaptive)
+	AccelerometerHighpassStep(&state, filterConstant, AdaptiveMode(adaptive, fastAdaptive), accel.x, accel.y, accel.z);
+}
+
+- (void)filterSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+			   outputX:(double *)outX y:(double *)outY z:(double *)outZ
+{
+	AccelerometerHighpassRun(&state, filterConstant, AdaptiveMode(adaptive, fastAdaptive), xs, ys, zs, outX, outY, outZ, count);
+}
+
+- (size_t)getSections:(AccelerometerBiquad *)sections
+{
+	// y[n] = alpha (y[n-1] + x[n] - x[n-1])
+	AccelerometerBiquad c = { filterConstant, -filterConstant, 0.0, -filterConstant, 0.0 };
+	sections[0] = c;
+	return 1;
+}
+
+- (NSString *)name
+{
+	return adaptive ? @"Adaptive Highpass Filter" : @"Highpass Filter";
+}
+
+@end
+
+
+#pragma mark -
+
+// See http://en.wikipedia.org/wiki/Butterworth_filter and http://en.wikipedia.org/wiki/Chebyshev_filter
+@implementation BiquadFilter
+
+@synthesize order;
+
+- (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq order:(NSUInteger)anOrder response:(AccelerometerBiquadResponse)aResponse
+{
+	return [self initWithSampleRate:rate cutoffFrequency:freq order:anOrder response:aResponse ripple:0.0];
+}
+
+- (id)initWithSampleRate:(double)rate cutoffFrequency:(double)freq order:(NSUInteger)anOrder response:(AccelerometerBiquadResponse)aResponse ripple:(double)rippleDB
+{
+	self = [super init];
+	if(self != nil)
 	{
-		double d = Clamp(fabs(Norm(x, y, z) - Norm(accel.x, accel.y, accel.z)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
-		alpha = d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+		sectionCount = AccelerometerBiquadDesign(sections, (unsigned)anOrder, aResponse, rate, freq, rippleDB);
+		if(sectionCount == 0)
+			return nil;
+		order = anOrder;
+		response = aResponse;
+		ripple = rippleDB;
 	}
-	
-	x = alpha * (x + accel.x - lastX);
-	y = alpha * (y + accel.y - lastY);
-	z = alpha * (z + accel.z - lastZ);
-	
-	lastX = accel.x;
-	lastY = accel.y;
-	lastZ = accel.z;
+	return self;
+}
+
+- (void)reset
+{
+	memset(sectionStates, 0, sizeof(sectionStates));
+	memset(&state, 0, sizeof(state));
+}
+
+- (void)addAcceleration:(MBLAccelerometerData *)accel
+{
+	AccelerometerBiquadStep(sections, sectionStates, sectionCount, &state, accel.x, accel.y, accel.z);
+}
+
+- (void)filterSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+			   outputX:(double *)outX y:(double *)outY z:(double *)outZ
+{
+	AccelerometerBiquadRun(sections, sectionStates, sectionCount, &state, xs, ys, zs, outX, outY, outZ, count);
+}
+
+- (size_t)getSections:(AccelerometerBiquad *)sectionsOut
+{
+	memcpy(sectionsOut, sections, sectionCount * sizeof(AccelerometerBiquad));
+	return sectionCount;
 }
 
 - (NSString *)name
 {
-	return adaptive ? @"Adaptive Highpass Filter" : @"Highpass Filter";
+	NSString *design = ripple > 0.0 ? @"Chebyshev" : @"Butterworth";
+	NSString *kind = response == AccelerometerBiquadLowpass ? @"Lowpass" : @"Highpass";
+	return [NSString stringWithFormat:@"%@ %@ Filter (Order %lu)", design, kind, (unsigned long)order];
 }
 
-@end
\ No newline at end of file
+@end
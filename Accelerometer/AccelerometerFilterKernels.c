@@ -0,0 +1,738 @@
+/**
+ * AccelerometerFilterKernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerFilterKernels.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ The one pole recurrences without adaptation and the biquad sections do the same arithmetic on every
+ axis, so x and y share a two lane vector while z runs alongside in a scalar register. Each lane sees
+ exactly the scalar operations in the same order, so the results stay bit-exact. SSE2 is part of every
+ x86-64 target and AArch64 always has NEON. ACCELEROMETER_FILTER_SCALAR builds the plain loops
+ instead, the tests build both.
+ */
+#if !defined(ACCELEROMETER_FILTER_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define ACCELEROMETER_FILTER_VECTOR	1
+
+typedef __m128d FilterVector;
+
+static inline FilterVector VectorMake(double x, double y) { return _mm_set_pd(y, x); }
+static inline FilterVector VectorSplat(double v) { return _mm_set1_pd(v); }
+static inline FilterVector VectorAdd(FilterVector a, FilterVector b) { return _mm_add_pd(a, b); }
+static inline FilterVector VectorSub(FilterVector a, FilterVector b) { return _mm_sub_pd(a, b); }
+static inline FilterVector VectorMul(FilterVector a, FilterVector b) { return _mm_mul_pd(a, b); }
+static inline void VectorStore(FilterVector v, double *x, double *y) { _mm_storel_pd(x, v); _mm_storeh_pd(y, v); }
+#elif !defined(ACCELEROMETER_FILTER_SCALAR) && (defined(__ARM_NEON__) || defined(__ARM_NEON)) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ACCELEROMETER_FILTER_VECTOR	1
+
+typedef float64x2_t FilterVector;
+
+static inline FilterVector VectorMake(double x, double y) { return vsetq_lane_f64(y, vdupq_n_f64(x), 1); }
+static inline FilterVector VectorSplat(double v) { return vdupq_n_f64(v); }
+static inline FilterVector VectorAdd(FilterVector a, FilterVector b) { return vaddq_f64(a, b); }
+static inline FilterVector VectorSub(FilterVector a, FilterVector b) { return vsubq_f64(a, b); }
+static inline FilterVector VectorMul(FilterVector a, FilterVector b) { return vmulq_f64(a, b); }
+static inline void VectorStore(FilterVector v, double *x, double *y) { vst1q_lane_f64(x, v, 0); vst1q_lane_f64(y, v, 1); }
+#else
+#define ACCELEROMETER_FILTER_VECTOR	0
+#endif
+
+// M_PI is an extension of math.h, not part of C99.
+static const double kPi = 3.14159265358979323846;
+
+double Norm(double x, double y, double z)
+{
+	return sqrt(x * x + y * y + z * z);
+}
+
+double Clamp(double v, double min, double max)
+{
+	if(v > max)
+		return max;
+	else if(v < min)
+		return min;
+	else
+		return v;
+}
+
+
+// Block kernels
+
+/*
+ The block kernels run the recurrence over n samples that have already been converted to double.
+ Outputs are always written, the drivers below hand in scratch space when the caller passed NULL.
+ */
+
+/*
+ The adaptive weight d only depends on how |a - b| compares to kAccelerometerMinStep and twice that,
+ where a is the magnitude of the filter output and b the magnitude of the new sample. Nearly every
+ sample gets d == 0 or d == 1, and mostly the same as the sample before, so AccelerometerAdaptiveFast
+ runs the recurrence with the weight of the sample before and only checks that the guess holds. The
+ check works on squared magnitudes and takes no square root, and its branch is almost always
+ predicted, so the serial dependency chain is as short as without adaptation. Only a sample whose
+ guess fails takes the exact formula.
+ 
+ The steps are moved kAdaptiveGuard * (1 + b * b) into the band where d is 0 or 1. Rounding in the
+ squares, in the check and in the exact |a - b| / kAccelerometerMinStep - 1 moves the outcome by a few
+ ulps of b, many orders of magnitude below that margin for samples of any size, so a sample that
+ passes the check gets exactly the guessed weight from the exact formula as well, and both modes are
+ bit-exact with each other.
+ */
+#define kAdaptiveGuard	1e-12
+
+static inline double ExactAlpha(double filterConstant, int lowpass, double x, double y, double z, double ax, double ay, double az)
+{
+	double d = Clamp(fabs(Norm(x, y, z) - Norm(ax, ay, az)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+	
+	if(lowpass)
+		return (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
+	return d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+}
+
+/*
+ Whether a sample of squared magnitude squaredSample surely gets d == 0 (quiet) or d == 1 (not quiet)
+ after an output of squared magnitude squaredNorm. For a step t, |a - b| against t is the same as
+ |a * a - b * b - t * t| against 2 t b, and squaring both sides leaves no square root at all. It also
+ leaves no branch that goes either way as the output swings around the sample. The squared test
+ would also count outputs near zero as loud when the sample is smaller than the step, those take the
+ exact formula instead.
+ */
+static inline int GuessHolds(int quiet, double squaredNorm, double squaredSample)
+{
+	double guard = kAdaptiveGuard * (1.0 + squaredSample);
+	double step = quiet ? kAccelerometerMinStep - guard : 2.0 * kAccelerometerMinStep + guard;
+	double offset = squaredNorm - squaredSample - step * step;
+	double bound = 4.0 * step * step * squaredSample;
+	
+	if(quiet)
+		return (step > 0.0) & (offset * offset <= bound);
+	return (squaredSample > step * step) & (offset * offset >= bound);
+}
+
+static void AdaptiveFastBlock(AccelerometerFilterState *state, double filterConstant, int lowpass,
+							  const double *restrict ax, const double *restrict ay, const double *restrict az,
+							  double *restrict outX, double *restrict outY, double *restrict outZ, size_t n)
+{
+	double x = state->x, y = state->y, z = state->z;
+	double lastX = state->lastX, lastY = state->lastY, lastZ = state->lastZ;
+	double quietAlpha = lowpass ? filterConstant / kAccelerometerNoiseAttenuation : filterConstant;
+	double loudAlpha = lowpass ? filterConstant : filterConstant / kAccelerometerNoiseAttenuation;
+	double alpha = loudAlpha;
+	int quiet = 0;
+	size_t i;
+	
+	for(i = 0; i < n; ++i)
+	{
+		double squaredSample = ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i];
+		double squaredNorm = x * x + y * y + z * z;
+		
+		if(__builtin_expect(GuessHolds(quiet, squaredNorm, squaredSample), 1))
+			alpha = quiet ? quietAlpha : loudAlpha;
+		else if(GuessHolds(!quiet, squaredNorm, squaredSample))
+		{
+			quiet = !quiet;
+			alpha = quiet ? quietAlpha : loudAlpha;
+		}
+		else
+			alpha = ExactAlpha(filterConstant, lowpass, x, y, z, ax[i], ay[i], az[i]);
+		
+		if(lowpass)
+		{
+			x = ax[i] * alpha + x * (1.0 - alpha);
+			y = ay[i] * alpha + y * (1.0 - alpha);
+			z = az[i] * alpha + z * (1.0 - alpha);
+		}
+		else
+		{
+			x = alpha * (x + ax[i] - lastX);
+			y = alpha * (y + ay[i] - lastY);
+			z = alpha * (z + az[i] - lastZ);
+			lastX = ax[i];
+			lastY = ay[i];
+			lastZ = az[i];
+		}
+		outX[i] = x;
+		outY[i] = y;
+		outZ[i] = z;
+	}
+	
+	state->x = x;
+	state->y = y;
+	state->z = z;
+	if(n > 0)
+	{
+		state->lastX = ax[n - 1];
+		state->lastY = ay[n - 1];
+		state->lastZ = az[n - 1];
+	}
+}
+
+static void LowpassBlock(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+						 const double *restrict ax, const double *restrict ay, const double *restrict az,
+						 double *restrict outX, double *restrict outY, double *restrict outZ, size_t n)
+{
+	double x = state->x, y = state->y, z = state->z;
+	size_t i;
+	
+	if(adaptive == AccelerometerAdaptiveFast)
+	{
+		AdaptiveFastBlock(state, filterConstant, 1, ax, ay, az, outX, outY, outZ, n);
+		return;
+	}
+	if(adaptive)
+	{
+		for(i = 0; i < n; ++i)
+		{
+			double d = Clamp(fabs(Norm(x, y, z) - Norm(ax[i], ay[i], az[i])) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+			double alpha = (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
+			
+			x = ax[i] * alpha + x * (1.0 - alpha);
+			y = ay[i] * alpha + y * (1.0 - alpha);
+			z = az[i] * alpha + z * (1.0 - alpha);
+			outX[i] = x;
+			outY[i] = y;
+			outZ[i] = z;
+		}
+	}
+	else
+	{
+		double alpha = filterConstant;
+#if ACCELEROMETER_FILTER_VECTOR
+		FilterVector va = VectorSplat(alpha), vb = VectorSplat(1.0 - alpha);
+		FilterVector v = VectorMake(x, y);
+		
+		for(i = 0; i < n; ++i)
+		{
+			v = VectorAdd(VectorMul(VectorMake(ax[i], ay[i]), va), VectorMul(v, vb));
+			z = az[i] * alpha + z * (1.0 - alpha);
+			VectorStore(v, &outX[i], &outY[i]);
+			outZ[i] = z;
+		}
+		VectorStore(v, &x, &y);
+#else
+		for(i = 0; i < n; ++i)
+		{
+			x = ax[i] * alpha + x * (1.0 - alpha);
+			y = ay[i] * alpha + y * (1.0 - alpha);
+			z = az[i] * alpha + z * (1.0 - alpha);
+			outX[i] = x;
+			outY[i] = y;
+			outZ[i] = z;
+		}
+#endif
+	}
+	
+	state->x = x;
+	state->y = y;
+	state->z = z;
+	if(n > 0)
+	{
+		state->lastX = ax[n - 1];
+		state->lastY = ay[n - 1];
+		state->lastZ = az[n - 1];
+	}
+}
+
+static void HighpassBlock(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+						  const double *restrict ax, const double *restrict ay, const double *restrict az,
+						  double *restrict outX, double *restrict outY, double *restrict outZ, size_t n)
+{
+	double x = state->x, y = state->y, z = state->z;
+	double lastX = state->lastX, lastY = state->lastY, lastZ = state->lastZ;
+	size_t i;
+	
+	if(adaptive == AccelerometerAdaptiveFast)
+	{
+		AdaptiveFastBlock(state, filterConstant, 0, ax, ay, az, outX, outY, outZ, n);
+		return;
+	}
+	if(adaptive)
+	{
+		for(i = 0; i < n; ++i)
+		{
+			double d = Clamp(fabs(Norm(x, y, z) - Norm(ax[i], ay[i], az[i])) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+			double alpha = d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+			
+			x = alpha * (x + ax[i] - lastX);
+			y = alpha * (y + ay[i] - lastY);
+			z = alpha * (z + az[i] - lastZ);
+			lastX = ax[i];
+			lastY = ay[i];
+			lastZ = az[i];
+			outX[i] = x;
+			outY[i] = y;
+			outZ[i] = z;
+		}
+	}
+	else
+	{
+		double alpha = filterConstant;
+#if ACCELEROMETER_FILTER_VECTOR
+		FilterVector va = VectorSplat(alpha);
+		FilterVector v = VectorMake(x, y), last = VectorMake(lastX, lastY);
+		
+		for(i = 0; i < n; ++i)
+		{
+			FilterVector a = VectorMake(ax[i], ay[i]);
+			
+			v = VectorMul(va, VectorSub(VectorAdd(v, a), last));
+			z = alpha * (z + az[i] - lastZ);
+			last = a;
+			lastZ = az[i];
+			VectorStore(v, &outX[i], &outY[i]);
+			outZ[i] = z;
+		}
+		VectorStore(v, &x, &y);
+		VectorStore(last, &lastX, &lastY);
+#else
+		for(i = 0; i < n; ++i)
+		{
+			x = alpha * (x + ax[i] - lastX);
+			y = alpha * (y + ay[i] - lastY);
+			z = alpha * (z + az[i] - lastZ);
+			lastX = ax[i];
+			lastY = ay[i];
+			lastZ = az[i];
+			outX[i] = x;
+			outY[i] = y;
+			outZ[i] = z;
+		}
+#endif
+	}
+	
+	state->x = x;
+	state->y = y;
+	state->z = z;
+	state->lastX = lastX;
+	state->lastY = lastY;
+	state->lastZ = lastZ;
+}
+
+
+// Drivers
+
+/*
+ Each driver converts kAccelerometerFilterBlockSize samples at a time from the packed integer input
+ into double scratch buffers and hands them to a block kernel. The conversion loop has no loop
+ carried dependency so the compiler turns it into SSE/AVX or NEON code, the recurrences in the block
+ kernels are vectorized across the axes by hand above.
+ */
+#define ACCELEROMETER_FILTER_DRIVER(name, kernel, type)													\
+void name(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,							\
+		  const type *x, const type *y, const type *z,													\
+		  double *outX, double *outY, double *outZ, size_t count)										\
+{																										\
+	double bx[kAccelerometerFilterBlockSize], by[kAccelerometerFilterBlockSize], bz[kAccelerometerFilterBlockSize]; \
+	double sx[kAccelerometerFilterBlockSize], sy[kAccelerometerFilterBlockSize], sz[kAccelerometerFilterBlockSize]; \
+	size_t done, n, i;																					\
+																										\
+	for(done = 0; done < count; done += n)																\
+	{																									\
+		n = count - done;																				\
+		if(n > kAccelerometerFilterBlockSize)															\
+			n = kAccelerometerFilterBlockSize;															\
+		for(i = 0; i < n; ++i)																			\
+		{																								\
+			bx[i] = x[done + i];																		\
+			by[i] = y[done + i];																		\
+			bz[i] = z[done + i];																		\
+		}																								\
+		if(outX)																						\
+			kernel(state, filterConstant, adaptive, bx, by, bz, outX + done, outY + done, outZ + done, n); \
+		else																							\
+			kernel(state, filterConstant, adaptive, bx, by, bz, sx, sy, sz, n);							\
+	}																									\
+}
+
+ACCELEROMETER_FILTER_DRIVER(AccelerometerLowpassRun, LowpassBlock, int16_t)
+ACCELEROMETER_FILTER_DRIVER(AccelerometerLowpassRun32, LowpassBlock, int32_t)
+ACCELEROMETER_FILTER_DRIVER(AccelerometerHighpassRun, HighpassBlock, int16_t)
+ACCELEROMETER_FILTER_DRIVER(AccelerometerHighpassRun32, HighpassBlock, int32_t)
+
+
+// Single samples
+
+/*
+ The per-sample recurrences without the block machinery. AccelerometerAdaptiveFast only pays off
+ when the bounds of a whole block are computed up front, for one sample the exact formula is cheaper
+ and gives the same result.
+ */
+static inline double AdaptiveWeight(const AccelerometerFilterState *state, double ax, double ay, double az)
+{
+	return Clamp(fabs(Norm(state->x, state->y, state->z) - Norm(ax, ay, az)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+}
+
+void AccelerometerLowpassStep(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							  double ax, double ay, double az)
+{
+	double alpha = filterConstant;
+	
+	if(adaptive)
+	{
+		double d = AdaptiveWeight(state, ax, ay, az);
+		alpha = (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
+	}
+	state->x = ax * alpha + state->x * (1.0 - alpha);
+	state->y = ay * alpha + state->y * (1.0 - alpha);
+	state->z = az * alpha + state->z * (1.0 - alpha);
+	state->lastX = ax;
+	state->lastY = ay;
+	state->lastZ = az;
+}
+
+void AccelerometerHighpassStep(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							   double ax, double ay, double az)
+{
+	double alpha = filterConstant;
+	
+	if(adaptive)
+	{
+		double d = AdaptiveWeight(state, ax, ay, az);
+		alpha = d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+	}
+	state->x = alpha * (state->x + ax - state->lastX);
+	state->y = alpha * (state->y + ay - state->lastY);
+	state->z = alpha * (state->z + az - state->lastZ);
+	state->lastX = ax;
+	state->lastY = ay;
+	state->lastZ = az;
+}
+
+
+// Biquad cascades
+
+/*
+ The analog prototype is normalized to a cutoff of 1 rad/s. Each conjugate pole pair p, p* gives a
+ section w0^2 / (s^2 + (w0 / Q) s + w0^2) with w0 = |p| and Q = w0 / (-2 Re p), the real pole of an
+ odd order gives a / (s + a). Highpass sections come from the lowpass ones through s -> 1 / s, which
+ turns w0 into 1 / w0 and keeps Q. The bilinear transform with K = tan(pi * cutoff / rate) then maps
+ each section to the z domain.
+ */
+static AccelerometerBiquad SecondOrderSection(double K, double w0, double Q, AccelerometerBiquadResponse response)
+{
+	AccelerometerBiquad c;
+	double k = response == AccelerometerBiquadLowpass ? K * w0 : K / w0;
+	double norm = 1.0 / (1.0 + k / Q + k * k);
+	
+	if(response == AccelerometerBiquadLowpass)
+	{
+		c.b0 = k * k * norm;
+		c.b1 = 2.0 * c.b0;
+	}
+	else
+	{
+		c.b0 = norm;
+		c.b1 = -2.0 * c.b0;
+	}
+	c.b2 = c.b0;
+	c.a1 = 2.0 * (k * k - 1.0) * norm;
+	c.a2 = (1.0 - k / Q + k * k) * norm;
+	return c;
+}
+
+static AccelerometerBiquad FirstOrderSection(double K, double a, AccelerometerBiquadResponse response)
+{
+	AccelerometerBiquad c;
+	double k = response == AccelerometerBiquadLowpass ? K * a : K / a;
+	
+	if(response == AccelerometerBiquadLowpass)
+	{
+		c.b0 = k / (1.0 + k);
+		c.b1 = c.b0;
+	}
+	else
+	{
+		c.b0 = 1.0 / (1.0 + k);
+		c.b1 = -c.b0;
+	}
+	c.b2 = 0.0;
+	c.a1 = (k - 1.0) / (k + 1.0);
+	c.a2 = 0.0;
+	return c;
+}
+
+size_t AccelerometerBiquadDesign(AccelerometerBiquad *sections, unsigned order, AccelerometerBiquadResponse response,
+								 double rate, double cutoff, double rippleDB)
+{
+	double K, sinhV = 1.0, coshV = 1.0, gain = 1.0;
+	size_t count = 0;
+	unsigned k;
+	
+	if(order < 1 || order > kAccelerometerBiquadMaxOrder || cutoff <= 0.0 || cutoff >= rate / 2.0)
+		return 0;
+	
+	K = tan(kPi * cutoff / rate);
+	if(rippleDB > 0.0)
+	{
+		// Chebyshev type I poles lie on an ellipse, Butterworth is the limit of zero ripple.
+		double epsilon = sqrt(pow(10.0, rippleDB / 10.0) - 1.0);
+		double v = asinh(1.0 / epsilon) / order;
+		sinhV = sinh(v);
+		coshV = cosh(v);
+		// Even orders start the passband at the bottom of the ripple.
+		if(order % 2 == 0)
+			gain = 1.0 / sqrt(1.0 + epsilon * epsilon);
+	}
+	
+	for(k = 0; k < order / 2; ++k)
+	{
+		double theta = kPi * (2.0 * k + 1.0) / (2.0 * order);
+		double re = -sinhV * sin(theta);
+		double im = coshV * cos(theta);
+		double w0 = sqrt(re * re + im * im);
+		sections[count++] = SecondOrderSection(K, w0, w0 / (-2.0 * re), response);
+	}
+	if(order % 2)
+		sections[count++] = FirstOrderSection(K, sinhV, response);
+	
+	sections[0].b0 *= gain;
+	sections[0].b1 *= gain;
+	sections[0].b2 *= gain;
+	return count;
+}
+
+/*
+ One sample of one section on one axis in transposed direct form II. The sum for s1 is grouped so
+ only the a1 product waits on the output. Every path through the cascade goes through here, so
+ blocks and single steps round identically.
+ */
+static inline double SectionSample(const AccelerometerBiquad *c, double v, double *s1, double *s2)
+{
+	double o = c->b0 * v + *s1;
+	
+	*s1 = (c->b1 * v + *s2) - c->a1 * o;
+	*s2 = c->b2 * v - c->a2 * o;
+	return o;
+}
+
+#if ACCELEROMETER_FILTER_VECTOR
+// SectionSample on the x and y lanes at once.
+static inline FilterVector SectionVector(const AccelerometerBiquad *c, FilterVector v, FilterVector *s1, FilterVector *s2)
+{
+	FilterVector o = VectorAdd(VectorMul(VectorSplat(c->b0), v), *s1);
+	
+	*s1 = VectorSub(VectorAdd(VectorMul(VectorSplat(c->b1), v), *s2), VectorMul(VectorSplat(c->a1), o));
+	*s2 = VectorSub(VectorMul(VectorSplat(c->b2), v), VectorMul(VectorSplat(c->a2), o));
+	return o;
+}
+#endif
+
+/*
+ Runs the sections over the whole block two at a time, with the delay lines of both sections in
+ registers. Within a section every sample waits on the one before, but the second section of a pair
+ only waits on the first, so it works on sample i while the first is already on sample i + 1. The
+ three axes add independent chains on top of that.
+ */
+static void BiquadBlock(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+						double *restrict bx, double *restrict by, double *restrict bz, size_t n)
+{
+	size_t k, i;
+	
+	for(k = 0; k + 1 < sectionCount; k += 2)
+	{
+		const AccelerometerBiquad c = sections[k], d = sections[k + 1];
+		double s1[3] = { states[k].s1[0], states[k].s1[1], states[k].s1[2] };
+		double s2[3] = { states[k].s2[0], states[k].s2[1], states[k].s2[2] };
+		double t1[3] = { states[k + 1].s1[0], states[k + 1].s1[1], states[k + 1].s1[2] };
+		double t2[3] = { states[k + 1].s2[0], states[k + 1].s2[1], states[k + 1].s2[2] };
+		
+#if ACCELEROMETER_FILTER_VECTOR
+		FilterVector vs1 = VectorMake(s1[0], s1[1]), vs2 = VectorMake(s2[0], s2[1]);
+		FilterVector vt1 = VectorMake(t1[0], t1[1]), vt2 = VectorMake(t2[0], t2[1]);
+		
+		for(i = 0; i < n; ++i)
+		{
+			FilterVector v = SectionVector(&d, SectionVector(&c, VectorMake(bx[i], by[i]), &vs1, &vs2), &vt1, &vt2);
+			
+			VectorStore(v, &bx[i], &by[i]);
+			bz[i] = SectionSample(&d, SectionSample(&c, bz[i], &s1[2], &s2[2]), &t1[2], &t2[2]);
+		}
+		VectorStore(vs1, &s1[0], &s1[1]);
+		VectorStore(vs2, &s2[0], &s2[1]);
+		VectorStore(vt1, &t1[0], &t1[1]);
+		VectorStore(vt2, &t2[0], &t2[1]);
+#else
+		for(i = 0; i < n; ++i)
+		{
+			bx[i] = SectionSample(&d, SectionSample(&c, bx[i], &s1[0], &s2[0]), &t1[0], &t2[0]);
+			by[i] = SectionSample(&d, SectionSample(&c, by[i], &s1[1], &s2[1]), &t1[1], &t2[1]);
+			bz[i] = SectionSample(&d, SectionSample(&c, bz[i], &s1[2], &s2[2]), &t1[2], &t2[2]);
+		}
+#endif
+		
+		memcpy(states[k].s1, s1, sizeof(s1));
+		memcpy(states[k].s2, s2, sizeof(s2));
+		memcpy(states[k + 1].s1, t1, sizeof(t1));
+		memcpy(states[k + 1].s2, t2, sizeof(t2));
+	}
+	if(k < sectionCount)
+	{
+		const AccelerometerBiquad c = sections[k];
+		double s1[3] = { states[k].s1[0], states[k].s1[1], states[k].s1[2] };
+		double s2[3] = { states[k].s2[0], states[k].s2[1], states[k].s2[2] };
+		
+#if ACCELEROMETER_FILTER_VECTOR
+		FilterVector vs1 = VectorMake(s1[0], s1[1]), vs2 = VectorMake(s2[0], s2[1]);
+		
+		for(i = 0; i < n; ++i)
+		{
+			VectorStore(SectionVector(&c, VectorMake(bx[i], by[i]), &vs1, &vs2), &bx[i], &by[i]);
+			bz[i] = SectionSample(&c, bz[i], &s1[2], &s2[2]);
+		}
+		VectorStore(vs1, &s1[0], &s1[1]);
+		VectorStore(vs2, &s2[0], &s2[1]);
+#else
+		for(i = 0; i < n; ++i)
+		{
+			bx[i] = SectionSample(&c, bx[i], &s1[0], &s2[0]);
+			by[i] = SectionSample(&c, by[i], &s1[1], &s2[1]);
+			bz[i] = SectionSample(&c, bz[i], &s1[2], &s2[2]);
+		}
+#endif
+		
+		memcpy(states[k].s1, s1, sizeof(s1));
+		memcpy(states[k].s2, s2, sizeof(s2));
+	}
+}
+
+#define ACCELEROMETER_BIQUAD_DRIVER(name, type)															\
+void name(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,	\
+		  AccelerometerFilterState *state,																\
+		  const type *x, const type *y, const type *z,													\
+		  double *outX, double *outY, double *outZ, size_t count)										\
+{																										\
+	double bx[kAccelerometerFilterBlockSize], by[kAccelerometerFilterBlockSize], bz[kAccelerometerFilterBlockSize]; \
+	size_t done, n, i;																					\
+																										\
+	for(done = 0; done < count; done += n)																\
+	{																									\
+		n = count - done;																				\
+		if(n > kAccelerometerFilterBlockSize)															\
+			n = kAccelerometerFilterBlockSize;															\
+		for(i = 0; i < n; ++i)																			\
+		{																								\
+			bx[i] = x[done + i];																		\
+			by[i] = y[done + i];																		\
+			bz[i] = z[done + i];																		\
+		}																								\
+		BiquadBlock(sections, states, sectionCount, bx, by, bz, n);										\
+		if(outX)																						\
+		{																								\
+			memcpy(outX + done, bx, n * sizeof(double));												\
+			memcpy(outY + done, by, n * sizeof(double));												\
+			memcpy(outZ + done, bz, n * sizeof(double));												\
+		}																								\
+		state->x = bx[n - 1];																			\
+		state->y = by[n - 1];																			\
+		state->z = bz[n - 1];																			\
+	}																									\
+}
+
+ACCELEROMETER_BIQUAD_DRIVER(AccelerometerBiquadRun, int16_t)
+ACCELEROMETER_BIQUAD_DRIVER(AccelerometerBiquadRun32, int32_t)
+
+void AccelerometerBiquadStep(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							 AccelerometerFilterState *state, double x, double y, double z)
+{
+	double v[3] = { x, y, z };
+	size_t k;
+	int axis;
+	
+	for(k = 0; k < sectionCount; ++k)
+	{
+		for(axis = 0; axis < 3; ++axis)
+			v[axis] = SectionSample(&sections[k], v[axis], &states[k].s1[axis], &states[k].s2[axis]);
+	}
+	state->x = v[0];
+	state->y = v[1];
+	state->z = v[2];
+}
+
+
+// Zero phase filtering
+
+// Delay line of one section for a constant input u, returns the matching constant output.
+static double SectionSettle(const AccelerometerBiquad *c, double u, double *s1, double *s2)
+{
+	double y = u * (c->b0 + c->b1 + c->b2) / (1.0 + c->a1 + c->a2);
+	
+	*s2 = c->b2 * u - c->a2 * y;
+	*s1 = c->b1 * u - c->a1 * y + *s2;
+	return y;
+}
+
+void AccelerometerBiquadSettle(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							   double x, double y, double z)
+{
+	double v[3] = { x, y, z };
+	size_t k;
+	int axis;
+	
+	for(k = 0; k < sectionCount; ++k)
+	{
+		for(axis = 0; axis < 3; ++axis)
+			v[axis] = SectionSettle(&sections[k], v[axis], &states[k].s1[axis], &states[k].s2[axis]);
+	}
+}
+
+// Run one section over a single channel, stepping by stride so the backward pass needs no copy.
+static void BiquadChannelPass(AccelerometerBiquad c, double *samples, size_t count, ptrdiff_t stride)
+{
+	// Delay line for a constant input equal to the first sample, so the output starts settled.
+	double s1, s2;
+	double *p = samples;
+	size_t i;
+	
+	SectionSettle(&c, samples[0], &s1, &s2);
+	
+	for(i = 0; i < count; ++i, p += stride)
+		*p = SectionSample(&c, *p, &s1, &s2);
+}
+
+void AccelerometerBiquadFiltfilt(const AccelerometerBiquad *sections, size_t sectionCount, double *samples, size_t count)
+{
+	size_t k;
+	
+	if(count == 0)
+		return;
+	
+	for(k = 0; k < sectionCount; ++k)
+		BiquadChannelPass(sections[k], samples, count, 1);
+	for(k = 0; k < sectionCount; ++k)
+		BiquadChannelPass(sections[k], samples + count - 1, count, -1);
+}
@@ -0,0 +1,176 @@
+/**
+ * AccelerometerFilterKernels.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Block processing kernels behind AccelerometerFilter.
+ 
+ The kernels are plain C so they can be shared by the Objective-C filter classes and run on any
+ platform. The Run functions take samples in structure-of-arrays form (one array per axis) and
+ convert them to double in blocks of kAccelerometerFilterBlockSize before the recurrence runs, so the
+ integer conversion and output stores vectorize while the three axes keep independent dependency
+ chains. Where the recurrence is the same on every axis, x and y also share SSE2 or NEON registers.
+ The Step functions take one sample straight through the recurrence with no scratch space, for
+ -addAcceleration:. Both evaluate the recurrences in exactly the same order as the original
+ per-sample code, so results are bit-exact with it and with each other.
+ */
+
+#ifndef AccelerometerFilterKernels_h
+#define AccelerometerFilterKernels_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerFilterBlockSize		256
+
+#define kAccelerometerMinStep				0.02
+#define kAccelerometerNoiseAttenuation		3.0
+
+// Running state of a one pole filter. x, y, z is the last output and lastX, lastY, lastZ the last input.
+typedef struct {
+	double x, y, z;
+	double lastX, lastY, lastZ;
+} AccelerometerFilterState;
+
+/*
+ How the adaptive filters measure the change in magnitude between the filter output and a new
+ sample. AccelerometerAdaptiveExact calls Norm twice per sample, which means two square roots on
+ the serial dependency chain. AccelerometerAdaptiveFast guesses that a sample gets the same weight as
+ the one before and checks the guess on squared magnitudes without a square root, so only samples
+ whose change is not clearly below kAccelerometerMinStep or clearly above twice that go through the
+ exact formula. "Clearly" is a margin far above rounding error, so both modes are bit-exact with
+ each other.
+ */
+typedef enum {
+	AccelerometerAdaptiveOff = 0,
+	AccelerometerAdaptiveExact,
+	AccelerometerAdaptiveFast
+} AccelerometerAdaptiveMode;
+
+double Norm(double x, double y, double z);
+double Clamp(double v, double min, double max);
+
+/*
+ Run count samples through the filter, updating state. The output arrays are optional, pass NULL
+ for all three if only the final state is of interest.
+ */
+void AccelerometerLowpassRun(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							 const int16_t *x, const int16_t *y, const int16_t *z,
+							 double *outX, double *outY, double *outZ, size_t count);
+void AccelerometerLowpassRun32(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							   const int32_t *x, const int32_t *y, const int32_t *z,
+							   double *outX, double *outY, double *outZ, size_t count);
+
+void AccelerometerHighpassRun(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							  const int16_t *x, const int16_t *y, const int16_t *z,
+							  double *outX, double *outY, double *outZ, size_t count);
+void AccelerometerHighpassRun32(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+								const int32_t *x, const int32_t *y, const int32_t *z,
+								double *outX, double *outY, double *outZ, size_t count);
+
+// One sample, the output is left in state->x, y, z. AccelerometerAdaptiveFast takes the exact path.
+void AccelerometerLowpassStep(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							  double x, double y, double z);
+void AccelerometerHighpassStep(AccelerometerFilterState *state, double filterConstant, AccelerometerAdaptiveMode adaptive,
+							   double x, double y, double z);
+
+
+// Biquad cascades
+
+#define kAccelerometerBiquadMaxOrder		8
+#define kAccelerometerBiquadMaxSections		(kAccelerometerBiquadMaxOrder / 2)
+
+typedef enum {
+	AccelerometerBiquadLowpass = 0,
+	AccelerometerBiquadHighpass
+} AccelerometerBiquadResponse;
+
+/*
+ One second order section, y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2].
+ First order sections have b2 == a2 == 0.
+ */
+typedef struct {
+	double b0, b1, b2, a1, a2;
+} AccelerometerBiquad;
+
+// Transposed direct form II delay line of one section, one entry per axis.
+typedef struct {
+	double s1[3], s2[3];
+} AccelerometerBiquadState;
+
+/*
+ Design a Butterworth (rippleDB <= 0) or Chebyshev type I (rippleDB > 0, passband ripple in dB)
+ filter of the given order with the bilinear transform, prewarped so the cutoff lands exactly at
+ cutoff Hz. Writes (order + 1) / 2 sections and returns that count, or 0 if the order is outside
+ 1...kAccelerometerBiquadMaxOrder or the cutoff is not below the Nyquist frequency.
+ */
+size_t AccelerometerBiquadDesign(AccelerometerBiquad *sections, unsigned order, AccelerometerBiquadResponse response,
+								 double rate, double cutoff, double rippleDB);
+
+/*
+ Run count samples through a cascade of sectionCount sections, see AccelerometerLowpassRun for the
+ meaning of the arguments. The last output is also stored in state->x, y, z.
+ */
+void AccelerometerBiquadRun(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							AccelerometerFilterState *state,
+							const int16_t *x, const int16_t *y, const int16_t *z,
+							double *outX, double *outY, double *outZ, size_t count);
+void AccelerometerBiquadRun32(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							  AccelerometerFilterState *state,
+							  const int32_t *x, const int32_t *y, const int32_t *z,
+							  double *outX, double *outY, double *outZ, size_t count);
+// Set the delay lines to the steady state for a constant input, so a causal run starts settled.
+void AccelerometerBiquadSettle(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							   double x, double y, double z);
+// One sample through the cascade, the output is left in state->x, y, z.
+void AccelerometerBiquadStep(const AccelerometerBiquad *sections, AccelerometerBiquadState *states, size_t sectionCount,
+							 AccelerometerFilterState *state, double x, double y, double z);
+
+/*
+ Zero phase filtering of one axis of a recorded buffer in place. The cascade runs forward and then
+ backward over the samples, which squares the magnitude response and cancels the phase lag. Each
+ pass starts from the steady state for its first sample to keep edge transients small. Nothing is
+ allocated, so this works on buffers of any length.
+ */
+void AccelerometerBiquadFiltfilt(const AccelerometerBiquad *sections, size_t sectionCount, double *samples, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
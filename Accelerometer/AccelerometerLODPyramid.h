@@ -0,0 +1,69 @@
+/**
+ * AccelerometerLODPyramid.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import "AccelerometerSampleStore.h"
+#import "AccelerometerDecimator.h"
+
+/*
+ Level of detail min/max pyramid over a recorded session.
+ 
+ Level 1 holds the minimum and maximum of every axis over buckets of kAccelerometerLODFactor samples,
+ and every further level combines kAccelerometerLODFactor buckets of the level below, so all levels
+ together take about a third of the memory of the samples themselves. Level 0 is the sample source.
+ A query for a number of pixel columns reads the coarsest level whose buckets are no wider than a
+ column, which touches at most kAccelerometerLODFactor + 2 entries per column. Drawing the recording
+ at any zoom costs O(columns) rather than O(samples).
+ */
+
+#define kAccelerometerLODFactor 4
+
+@interface AccelerometerLODPyramid : NSObject
+
+// The source is kept for the raw samples and must not be modified or used elsewhere afterwards. Returns
+// nil when the levels cannot be allocated.
+- (id)initWithSampleSource:(id<AccelerometerSampleSource>)source;
+
+/*
+ One envelope per column over samples [start, start + length), in milli-G. Columns past the end of
+ the recording get min > max.
+ */
+- (void)getEnvelopes:(AccelerometerEnvelope *)envelopes columns:(NSUInteger)columns start:(double)start length:(double)length;
+
+@property (nonatomic, readonly) id<AccelerometerSampleSource> source;
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSUInteger levelCount;
+
+@end
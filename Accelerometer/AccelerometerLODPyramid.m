@@ -0,0 +1,208 @@
+/**
+ * AccelerometerLODPyramid.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerLODPyramid.h"
+
+typedef struct {
+    // Samples covered by one bucket.
+    NSUInteger bucketSize;
+    NSUInteger count;
+    int16_t *min[3];
+    int16_t *max[3];
+} AccelerometerLODLevel;
+
+#define kAccelerometerLODMaxLevels 32
+
+@implementation AccelerometerLODPyramid
+{
+    AccelerometerLODLevel levels[kAccelerometerLODMaxLevels];
+}
+
+- (id)initWithSampleSource:(id<AccelerometerSampleSource>)source
+{
+    self = [super init];
+    if (self != nil) {
+        _source = source;
+        _count = source.count;
+        _levelCount = 1;
+        levels[0].bucketSize = 1;
+        levels[0].count = _count;
+        if (![self buildFirstLevel]) {
+            return nil;
+        }
+        while (levels[_levelCount - 1].count > 1 && _levelCount < kAccelerometerLODMaxLevels) {
+            if (![self buildLevelFrom:&levels[_levelCount - 1] into:&levels[_levelCount]]) {
+                return nil;
+            }
+            _levelCount++;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    // Past levelCount a level is either zeroed or what a failed build left behind.
+    for (NSUInteger level = 1; level < kAccelerometerLODMaxLevels; level++) {
+        for (int axis = 0; axis < 3; axis++) {
+            free(levels[level].min[axis]);
+            free(levels[level].max[axis]);
+        }
+    }
+}
+
+// NO when any of the buffers could not be allocated, the ones that were are freed with the pyramid.
+static BOOL AllocateLevel(AccelerometerLODLevel *level, NSUInteger bucketSize, NSUInteger count)
+{
+    BOOL allocated = YES;
+    level->bucketSize = bucketSize;
+    level->count = count;
+    for (int axis = 0; axis < 3; axis++) {
+        level->min[axis] = malloc(MAX(count, 1) * sizeof(int16_t));
+        level->max[axis] = malloc(MAX(count, 1) * sizeof(int16_t));
+        allocated = allocated && level->min[axis] && level->max[axis];
+    }
+    return allocated;
+}
+
+- (BOOL)buildFirstLevel
+{
+    if (_count < 2) {
+        return YES;
+    }
+    AccelerometerLODLevel *level = &levels[1];
+    if (!AllocateLevel(level, kAccelerometerLODFactor, (_count + kAccelerometerLODFactor - 1) / kAccelerometerLODFactor)) {
+        return NO;
+    }
+    _levelCount = 2;
+    
+    // Buckets can straddle two spans of a ring store, the second part merges with what the first part left.
+    [_source enumerateSpansInRange:NSMakeRange(0, _count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        const int16_t *axes[3] = { span.x, span.y, span.z };
+        NSUInteger index = span.start, end = span.start + span.count;
+        while (index < end) {
+            NSUInteger bucket = index / kAccelerometerLODFactor;
+            NSUInteger bucketEnd = MIN((bucket + 1) * kAccelerometerLODFactor, end);
+            for (int axis = 0; axis < 3; axis++) {
+                const int16_t *values = axes[axis];
+                int16_t low = values[index - span.start], high = low;
+                for (NSUInteger i = index + 1; i < bucketEnd; i++) {
+                    low = MIN(low, values[i - span.start]);
+                    high = MAX(high, values[i - span.start]);
+                }
+                if (index % kAccelerometerLODFactor) {
+                    low = MIN(low, level->min[axis][bucket]);
+                    high = MAX(high, level->max[axis][bucket]);
+                }
+                level->min[axis][bucket] = low;
+                level->max[axis][bucket] = high;
+            }
+            index = bucketEnd;
+        }
+    }];
+    return YES;
+}
+
+- (BOOL)buildLevelFrom:(const AccelerometerLODLevel *)source into:(AccelerometerLODLevel *)level
+{
+    if (!AllocateLevel(level, source->bucketSize * kAccelerometerLODFactor, (source->count + kAccelerometerLODFactor - 1) / kAccelerometerLODFactor)) {
+        return NO;
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        const int16_t *sourceMin = source->min[axis], *sourceMax = source->max[axis];
+        for (NSUInteger bucket = 0; bucket < level->count; bucket++) {
+            NSUInteger first = bucket * kAccelerometerLODFactor, end = MIN(first + kAccelerometerLODFactor, source->count);
+            int16_t low = sourceMin[first], high = sourceMax[first];
+            for (NSUInteger i = first + 1; i < end; i++) {
+                low = MIN(low, sourceMin[i]);
+                high = MAX(high, sourceMax[i]);
+            }
+            level->min[axis][bucket] = low;
+            level->max[axis][bucket] = high;
+        }
+    }
+    return YES;
+}
+
+- (void)getEnvelopes:(AccelerometerEnvelope *)envelopes columns:(NSUInteger)columns start:(double)start length:(double)length
+{
+    double samplesPerColumn = length / columns;
+    NSUInteger level = 0;
+    while (level + 1 < _levelCount && levels[level + 1].bucketSize <= samplesPerColumn) {
+        level++;
+    }
+    const AccelerometerLODLevel *source = &levels[level];
+    
+    AccelerometerSampleSpan span = { 0 };
+    for (NSUInteger column = 0; column < columns; column++) {
+        AccelerometerEnvelope *envelope = &envelopes[column];
+        double from = floor(start + column * samplesPerColumn);
+        double to = MAX(floor(start + (column + 1) * samplesPerColumn), from + 1.0);
+        if (from < 0.0 || from >= _count) {
+            for (int axis = 0; axis < 3; axis++) {
+                envelope->min[axis] = 1.0;
+                envelope->max[axis] = -1.0;
+            }
+            continue;
+        }
+        NSUInteger first = (NSUInteger)from / source->bucketSize;
+        NSUInteger end = MIN(((NSUInteger)MIN(to, _count) + source->bucketSize - 1) / source->bucketSize, source->count);
+        
+        for (int axis = 0; axis < 3; axis++) {
+            envelope->min[axis] = INT16_MAX;
+            envelope->max[axis] = INT16_MIN;
+        }
+        for (NSUInteger i = first; i < end; i++) {
+            if (level == 0) {
+                // Raw samples come from the source, a span usually covers many columns.
+                if ((i < span.start || i >= span.start + span.count) && ![_source getSpan:&span atIndex:i]) {
+                    break;
+                }
+                int16_t values[3] = { span.x[i - span.start], span.y[i - span.start], span.z[i - span.start] };
+                for (int axis = 0; axis < 3; axis++) {
+                    envelope->min[axis] = MIN(envelope->min[axis], values[axis]);
+                    envelope->max[axis] = MAX(envelope->max[axis], values[axis]);
+                }
+            } else {
+                for (int axis = 0; axis < 3; axis++) {
+                    envelope->min[axis] = MIN(envelope->min[axis], source->min[axis][i]);
+                    envelope->max[axis] = MAX(envelope->max[axis], source->max[axis][i]);
+                }
+            }
+        }
+    }
+}
+
+@end
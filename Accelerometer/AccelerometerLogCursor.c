@@ -0,0 +1,99 @@
+/**
+ * AccelerometerLogCursor.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerLogCursor.h"
+
+const AccelerometerLogCursor AccelerometerLogCursorEmpty = { 0, 0.0, 0 };
+
+static size_t TrailingTies(const double *times, size_t count)
+{
+	size_t ties = 0;
+	
+	while(ties < count && times[count - 1 - ties] == times[count - 1])
+		ties++;
+	return ties;
+}
+
+size_t AccelerometerLogCursorFirstNew(const AccelerometerLogCursor *cursor, const double *times, size_t count)
+{
+	if(!cursor->count)
+		return 0;
+	
+	// Walk the increasing runs newest first, a run that ends before the cursor cannot hold it.
+	size_t end = count;
+	while(end > 0)
+	{
+		size_t start = end - 1;
+		while(start > 0 && times[start - 1] <= times[start])
+			start--;
+		
+		if(times[end - 1] >= cursor->time && times[start] <= cursor->time)
+		{
+			size_t low = start, high = end;
+			while(low < high)
+			{
+				size_t mid = low + (high - low) / 2;
+				if(times[mid] < cursor->time)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+			// Skip as many entries at the cursor time as the journal already holds.
+			size_t ties = 0;
+			while(low < end && ties < cursor->ties && times[low] == cursor->time)
+			{
+				low++;
+				ties++;
+			}
+			if(ties)
+				return low;
+		}
+		end = start;
+	}
+	return 0;
+}
+
+void AccelerometerLogCursorAdvance(AccelerometerLogCursor *cursor, const double *times, size_t count)
+{
+	if(!count)
+		return;
+	
+	size_t ties = TrailingTies(times, count);
+	if(ties == count && cursor->count && times[count - 1] == cursor->time)
+		ties += cursor->ties;
+	cursor->count += count;
+	cursor->time = times[count - 1];
+	cursor->ties = ties;
+}
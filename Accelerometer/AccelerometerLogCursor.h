@@ -0,0 +1,74 @@
+/**
+ * AccelerometerLogCursor.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+/*
+ Which entries of a downloaded log are already in the journal.
+ 
+ The cursor is the timestamp of the newest journal entry and how many entries share it. A download
+ overlaps the journal only when it holds that entry again, everything after it is new. Timestamps are
+ not trusted to only increase: a board reset or a correction of the phone clock can stamp new entries
+ earlier than the cursor. So a download is split into runs that increase, the cursor is looked for
+ in the newest run that holds it, and a download without the cursor entry is new in full instead of
+ being cut off at the cursor time.
+ */
+
+#ifndef AccelerometerLogCursor_h
+#define AccelerometerLogCursor_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	// Entries in the journal, the other fields mean nothing while this is 0.
+	size_t count;
+	double time;
+	size_t ties;
+} AccelerometerLogCursor;
+
+extern const AccelerometerLogCursor AccelerometerLogCursorEmpty;
+
+// Index of the first of count downloaded entries at times that is not in the journal yet.
+size_t AccelerometerLogCursorFirstNew(const AccelerometerLogCursor *cursor, const double *times, size_t count);
+
+// Move the cursor past count entries appended to the journal.
+void AccelerometerLogCursorAdvance(AccelerometerLogCursor *cursor, const double *times, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
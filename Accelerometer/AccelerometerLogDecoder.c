@@ -0,0 +1,130 @@
+/**
+ * AccelerometerLogDecoder.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerLogDecoder.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+static inline int16_t ReadInt16LE(const uint8_t *p)
+{
+	return (int16_t)(uint16_t)(p[0] | (p[1] << 8));
+}
+
+void AccelerometerLogDecodeInt16x3Scalar(const uint8_t *src, size_t count, int16_t *x, int16_t *y, int16_t *z)
+{
+	for(size_t i = 0; i < count; i++, src += kAccelerometerLogPayloadSize)
+	{
+		x[i] = ReadInt16LE(src);
+		y[i] = ReadInt16LE(src + 2);
+		z[i] = ReadInt16LE(src + 4);
+	}
+}
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && defined(__LITTLE_ENDIAN__)
+
+// Eight samples per step, vld3q_s16 deinterleaves 48 bytes straight into the three axes.
+static size_t DecodeVector(const uint8_t *src, size_t count, int16_t *x, int16_t *y, int16_t *z)
+{
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		int16x8x3_t v = vld3q_s16((const int16_t *)(src + i * kAccelerometerLogPayloadSize));
+		vst1q_s16(x + i, v.val[0]);
+		vst1q_s16(y + i, v.val[1]);
+		vst1q_s16(z + i, v.val[2]);
+	}
+	return i;
+}
+
+#elif defined(__SSSE3__)
+
+/*
+ Eight samples are 24 words spread over three registers a, b and c. Each axis takes every third word,
+ so it is gathered with one shuffle per register that moves its words into place and zeroes the rest,
+ then the three shuffles are or'ed together.
+ */
+static size_t DecodeVector(const uint8_t *src, size_t count, int16_t *x, int16_t *y, int16_t *z)
+{
+	const __m128i xa = _mm_setr_epi8(0, 1, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i xb = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 3, 8, 9, 14, 15, -1, -1, -1, -1);
+	const __m128i xc = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, 5, 10, 11);
+	const __m128i ya = _mm_setr_epi8(2, 3, 8, 9, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i yb = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 4, 5, 10, 11, -1, -1, -1, -1, -1, -1);
+	const __m128i yc = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 6, 7, 12, 13);
+	const __m128i za = _mm_setr_epi8(4, 5, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m128i zb = _mm_setr_epi8(-1, -1, -1, -1, 0, 1, 6, 7, 12, 13, -1, -1, -1, -1, -1, -1);
+	const __m128i zc = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 3, 8, 9, 14, 15);
+	
+	size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m128i *p = (const __m128i *)(src + i * kAccelerometerLogPayloadSize);
+		__m128i a = _mm_loadu_si128(p);
+		__m128i b = _mm_loadu_si128(p + 1);
+		__m128i c = _mm_loadu_si128(p + 2);
+		
+		__m128i vx = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, xa), _mm_shuffle_epi8(b, xb)), _mm_shuffle_epi8(c, xc));
+		__m128i vy = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, ya), _mm_shuffle_epi8(b, yb)), _mm_shuffle_epi8(c, yc));
+		__m128i vz = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, za), _mm_shuffle_epi8(b, zb)), _mm_shuffle_epi8(c, zc));
+		_mm_storeu_si128((__m128i *)(x + i), vx);
+		_mm_storeu_si128((__m128i *)(y + i), vy);
+		_mm_storeu_si128((__m128i *)(z + i), vz);
+	}
+	return i;
+}
+
+#else
+
+static size_t DecodeVector(const uint8_t *src, size_t count, int16_t *x, int16_t *y, int16_t *z)
+{
+	(void)src;
+	(void)count;
+	(void)x;
+	(void)y;
+	(void)z;
+	return 0;
+}
+
+#endif
+
+void AccelerometerLogDecodeInt16x3(const uint8_t *src, size_t count, int16_t *x, int16_t *y, int16_t *z)
+{
+	size_t done = DecodeVector(src, count, x, y, z);
+	AccelerometerLogDecodeInt16x3Scalar(src + done * kAccelerometerLogPayloadSize, count - done, x + done, y + done, z + done);
+}
@@ -0,0 +1,90 @@
+/**
+ * AccelerometerLogJournal.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+#import "AccelerometerSampleStore.h"
+
+/*
+ Journal of the entries downloaded from a logged accelerometer event, with duplicates left out.
+ 
+ Every downloaded entry is appended to a journal on disk, one per device and event name, and
+ AccelerometerLogCursor decides which entries of a download the journal already holds, so whatever
+ the MetaWear still has from an earlier download is dropped instead of stored twice. Only the new
+ entries are written, which keeps the local cost of a download proportional to the new data.
+ 
+ This does not shorten the transfer itself. The MetaWear API sends the whole log on every download
+ and hands it over only once it is complete, with no way to ask for a part of it or to continue an
+ interrupted one. A failed download is tried again from the start after reconnecting, up to
+ maxAttempts times, and since the cursor only moves once entries reach the journal nothing is lost
+ or stored twice when one fails.
+ */
+
+#define kAccelerometerLogJournalDefaultAttempts 3
+
+extern NSString *const AccelerometerLogJournalErrorDomain;
+
+typedef NS_ENUM(NSInteger, AccelerometerLogJournalError) {
+    AccelerometerLogJournalErrorJournal = 1,
+    AccelerometerLogJournalErrorBusy
+};
+
+// newEntries holds the MBLAccelerometerData that were not in the journal yet, oldest first.
+typedef void (^AccelerometerLogJournalHandler)(NSArray *newEntries, NSError *error);
+
+@interface AccelerometerLogJournal : NSObject
+
+// name tells apart several logged events of the same device, it becomes part of the journal file name.
+- (id)initWithDevice:(MBLMetaWear *)device event:(MBLEvent *)event name:(NSString *)name;
+
+// Download the whole log, append the entries missing from the journal and call handler on the main queue.
+// progressHandler is called on the main queue too, whatever the MetaWear callback queue is.
+- (void)downloadAndStopLogging:(BOOL)stopLogging handler:(AccelerometerLogJournalHandler)handler progressHandler:(MBLFloatHandler)progressHandler;
+// Everything downloaded so far, read back from the journal, nil when out of memory.
+- (AccelerometerSampleStore *)sampleStore;
+// Delete the journal, the next download keeps every entry the MetaWear returns.
+- (void)reset;
+
+@property (nonatomic, readonly) MBLMetaWear *device;
+@property (nonatomic, readonly) MBLEvent *event;
+@property (nonatomic, readonly) NSURL *journalURL;
+@property (nonatomic, readonly) NSUInteger count;
+// Timestamp of the newest downloaded entry, nil before the first one.
+@property (nonatomic, readonly) NSDate *lastTimestamp;
+@property (nonatomic, readonly, getter=isDownloading) BOOL downloading;
+// Downloads tried before the error is reported, kAccelerometerLogJournalDefaultAttempts by default.
+@property (nonatomic) NSUInteger maxAttempts;
+
+@end
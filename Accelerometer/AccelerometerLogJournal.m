@@ -0,0 +1,309 @@
+/**
+ * AccelerometerLogJournal.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerLogJournal.h"
+#import "AccelerometerSaturate.h"
+#import "AccelerometerLogCursor.h"
+
+NSString *const AccelerometerLogJournalErrorDomain = @"AccelerometerLogJournalErrorDomain";
+
+#define kAccelerometerLogJournalMagic      "MWAJ"
+#define kAccelerometerLogJournalVersion    1
+
+// The journal is this header followed by one record per downloaded entry, little endian.
+typedef struct {
+    char magic[4];
+    uint32_t version;
+} AccelerometerLogJournalHeader;
+
+typedef struct {
+    double timestamp;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    int16_t reserved;
+} AccelerometerLogJournalRecord;
+
+static inline NSTimeInterval EntryTime(MBLAccelerometerData *data)
+{
+    return data.timestamp.timeIntervalSince1970;
+}
+
+// Timestamps of the entries for AccelerometerLogCursor, NULL when out of memory.
+static double *EntryTimes(NSArray *entries)
+{
+    double *times = malloc(MAX(entries.count, 1) * sizeof(double));
+    if (times) {
+        NSUInteger i = 0;
+        for (MBLAccelerometerData *data in entries) {
+            times[i++] = EntryTime(data);
+        }
+    }
+    return times;
+}
+
+static NSError *LogJournalError(AccelerometerLogJournalError code, NSString *description)
+{
+    return [NSError errorWithDomain:AccelerometerLogJournalErrorDomain code:code userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+@interface AccelerometerLogJournal ()
+@property (nonatomic, readwrite) NSUInteger count;
+@property (nonatomic, readwrite, getter=isDownloading) BOOL downloading;
+@property (nonatomic) dispatch_queue_t journalQueue;
+@end
+
+@implementation AccelerometerLogJournal
+{
+    AccelerometerLogCursor cursor;
+}
+
++ (NSURL *)journalDirectory
+{
+    NSURL *support = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+    return [support URLByAppendingPathComponent:@"AccelerometerLogs" isDirectory:YES];
+}
+
+- (id)initWithDevice:(MBLMetaWear *)device event:(MBLEvent *)event name:(NSString *)name
+{
+    self = [super init];
+    if (self != nil) {
+        _device = device;
+        _event = event;
+        _maxAttempts = kAccelerometerLogJournalDefaultAttempts;
+        _journalQueue = dispatch_queue_create("com.mbientlab.accelerometer.logjournal", DISPATCH_QUEUE_SERIAL);
+        NSString *file = [NSString stringWithFormat:@"%@-%@.mwaj", device.identifier.UUIDString, name];
+        _journalURL = [[AccelerometerLogJournal journalDirectory] URLByAppendingPathComponent:file];
+        [self loadCursor];
+    }
+    return self;
+}
+
+- (NSDate *)lastTimestamp
+{
+    return cursor.count ? [NSDate dateWithTimeIntervalSince1970:cursor.time] : nil;
+}
+
+// Recover the cursor from the journal tail, dropping a record cut short by an interrupted append.
+- (void)loadCursor
+{
+    cursor = AccelerometerLogCursorEmpty;
+    self.count = 0;
+    
+    NSData *journal = [NSData dataWithContentsOfURL:self.journalURL options:NSDataReadingMappedIfSafe error:nil];
+    if (journal.length < sizeof(AccelerometerLogJournalHeader)) {
+        return;
+    }
+    const AccelerometerLogJournalHeader *header = journal.bytes;
+    if (memcmp(header->magic, kAccelerometerLogJournalMagic, 4) || header->version != kAccelerometerLogJournalVersion) {
+        NSLog(@"Discarding unreadable log journal %@", self.journalURL.lastPathComponent);
+        [[NSFileManager defaultManager] removeItemAtURL:self.journalURL error:nil];
+        return;
+    }
+    NSUInteger count = (journal.length - sizeof(AccelerometerLogJournalHeader)) / sizeof(AccelerometerLogJournalRecord);
+    unsigned long long length = sizeof(AccelerometerLogJournalHeader) + count * sizeof(AccelerometerLogJournalRecord);
+    if (length != journal.length) {
+        NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:self.journalURL error:nil];
+        [handle truncateFileAtOffset:length];
+        [handle closeFile];
+    }
+    
+    const AccelerometerLogJournalRecord *records = (const AccelerometerLogJournalRecord *)(header + 1);
+    if (count) {
+        // Only the tail run of equal timestamps matters for the cursor.
+        NSUInteger ties = 0;
+        while (ties < count && records[count - 1 - ties].timestamp == records[count - 1].timestamp) {
+            ties++;
+        }
+        cursor.count = count;
+        cursor.time = records[count - 1].timestamp;
+        cursor.ties = ties;
+    }
+    self.count = count;
+}
+
+- (void)reset
+{
+    dispatch_sync(self.journalQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:self.journalURL error:nil];
+    });
+    cursor = AccelerometerLogCursorEmpty;
+    self.count = 0;
+}
+
+- (void)downloadAndStopLogging:(BOOL)stopLogging handler:(AccelerometerLogJournalHandler)handler progressHandler:(MBLFloatHandler)progressHandler
+{
+    if (self.downloading) {
+        if (handler) {
+            handler(nil, LogJournalError(AccelerometerLogJournalErrorBusy, @"A log download is already in progress"));
+        }
+        return;
+    }
+    self.downloading = YES;
+    [self downloadAndStopLogging:stopLogging attempt:1 handler:handler progressHandler:progressHandler];
+}
+
+- (void)downloadAndStopLogging:(BOOL)stopLogging attempt:(NSUInteger)attempt handler:(AccelerometerLogJournalHandler)handler progressHandler:(MBLFloatHandler)progressHandler
+{
+    [self.event downloadLogAndStopLogging:stopLogging handler:^(NSArray *array, NSError *error) {
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            if (!error) {
+                [self appendEntries:array handler:handler];
+                return;
+            }
+            if (attempt >= self.maxAttempts) {
+                [self finishWithEntries:nil error:error handler:handler];
+                return;
+            }
+            // The API cannot continue a transfer, the next attempt downloads the whole log again.
+            NSLog(@"Log download attempt %lu failed: %@", (unsigned long)attempt, error.localizedDescription);
+            if (self.device.state == CBPeripheralStateConnected) {
+                [self downloadAndStopLogging:stopLogging attempt:attempt + 1 handler:handler progressHandler:progressHandler];
+                return;
+            }
+            [self.device connectWithHandler:^(NSError *error) {
+                [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                    if (error) {
+                        [self finishWithEntries:nil error:error handler:handler];
+                    } else {
+                        [self downloadAndStopLogging:stopLogging attempt:attempt + 1 handler:handler progressHandler:progressHandler];
+                    }
+                }];
+            }];
+        }];
+    } progressHandler:^(float number, NSError *error) {
+        if (progressHandler) {
+            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                progressHandler(number, error);
+            }];
+        }
+    }];
+}
+
+- (void)appendEntries:(NSArray *)entries handler:(AccelerometerLogJournalHandler)handler
+{
+    double *times = EntryTimes(entries);
+    if (!times) {
+        [self finishWithEntries:nil error:LogJournalError(AccelerometerLogJournalErrorJournal, @"Not enough memory for the downloaded log") handler:handler];
+        return;
+    }
+    NSUInteger first = AccelerometerLogCursorFirstNew(&cursor, times, entries.count);
+    NSArray *newEntries = [entries subarrayWithRange:NSMakeRange(first, entries.count - first)];
+    if (!newEntries.count) {
+        free(times);
+        [self finishWithEntries:newEntries error:nil handler:handler];
+        return;
+    }
+    BOOL empty = self.count == 0;
+    
+    dispatch_async(self.journalQueue, ^{
+        NSMutableData *bytes = [NSMutableData dataWithCapacity:sizeof(AccelerometerLogJournalHeader) + newEntries.count * sizeof(AccelerometerLogJournalRecord)];
+        if (empty) {
+            AccelerometerLogJournalHeader header;
+            memcpy(header.magic, kAccelerometerLogJournalMagic, 4);
+            header.version = kAccelerometerLogJournalVersion;
+            [bytes appendBytes:&header length:sizeof(header)];
+        }
+        for (NSUInteger i = 0; i < newEntries.count; i++) {
+            MBLAccelerometerData *data = newEntries[i];
+            AccelerometerLogJournalRecord record = { times[first + i], SaturateInt16(data.x), SaturateInt16(data.y), SaturateInt16(data.z), 0 };
+            [bytes appendBytes:&record length:sizeof(record)];
+        }
+        
+        NSError *error = nil;
+        [[NSFileManager defaultManager] createDirectoryAtURL:[AccelerometerLogJournal journalDirectory] withIntermediateDirectories:YES attributes:nil error:nil];
+        NSOutputStream *stream = [NSOutputStream outputStreamWithURL:self.journalURL append:!empty];
+        [stream open];
+        const uint8_t *p = bytes.bytes;
+        NSUInteger remaining = bytes.length;
+        while (remaining) {
+            NSInteger written = [stream write:p maxLength:remaining];
+            if (written <= 0) {
+                error = LogJournalError(AccelerometerLogJournalErrorJournal, @"Unable to write the log journal");
+                break;
+            }
+            p += written;
+            remaining -= written;
+        }
+        [stream close];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (error) {
+                // Whatever made it to disk is picked up again from the journal tail.
+                [self loadCursor];
+            } else {
+                AccelerometerLogCursorAdvance(&self->cursor, times + first, newEntries.count);
+                self.count = self->cursor.count;
+            }
+            free(times);
+            [self finishWithEntries:error ? nil : newEntries error:error handler:handler];
+        });
+    });
+}
+
+- (void)finishWithEntries:(NSArray *)entries error:(NSError *)error handler:(AccelerometerLogJournalHandler)handler
+{
+    self.downloading = NO;
+    if (handler) {
+        handler(entries, error);
+    }
+}
+
+- (AccelerometerSampleStore *)sampleStore
+{
+    __block NSData *journal = nil;
+    dispatch_sync(self.journalQueue, ^{
+        journal = [NSData dataWithContentsOfURL:self.journalURL options:NSDataReadingMappedIfSafe error:nil];
+    });
+    AccelerometerSampleStore *store = [[AccelerometerSampleStore alloc] init];
+    if (journal.length < sizeof(AccelerometerLogJournalHeader)) {
+        return store;
+    }
+    NSUInteger count = (journal.length - sizeof(AccelerometerLogJournalHeader)) / sizeof(AccelerometerLogJournalRecord);
+    const AccelerometerLogJournalRecord *records = (const AccelerometerLogJournalRecord *)((const AccelerometerLogJournalHeader *)journal.bytes + 1);
+    if (count) {
+        store.epoch = records[0].timestamp;
+    }
+    for (NSUInteger i = 0; i < count; i++) {
+        NSTimeInterval offset = records[i].timestamp - store.epoch;
+        uint64_t tick = offset > 0 ? llround(offset * kAccelerometerSampleStoreTicksPerSecond) : 0;
+        if (![store appendX:records[i].x y:records[i].y z:records[i].z tick:tick]) {
+            return nil;
+        }
+    }
+    return store;
+}
+
+@end
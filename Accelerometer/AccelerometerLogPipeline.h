@@ -0,0 +1,95 @@
+/**
+ * AccelerometerLogPipeline.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+#import "AccelerometerFilter.h"
+#import "AccelerometerSampleStore.h"
+#import "AccelerometerSessionFile.h"
+#import "AccelerometerLODPyramid.h"
+
+/*
+ Background post processing of a downloaded accelerometer log.
+ 
+ The entries are decoded and timestamped in chunks spread over the global concurrent queue, the raw
+ payloads through AccelerometerLogDecodeInt16x3 when they agree with what the framework decoded. The
+ resulting store then feeds three independent stages that run side by side: the LOD pyramid, the
+ binary session file and the statistics, which zero phase filter the recording first when a filter
+ is set. With a sessionURL the session file is written first and the other two stages read it back
+ mapped, so the unfiltered statistics take constant memory. Only the finished results reach the
+ main queue.
+ 
+ The MetaWear API hands over the log as one array once the download completes, so processing starts
+ at that point rather than while entries arrive.
+ */
+
+// Statistics of the recording in milli-G, of the filtered signal when the pipeline has a filter.
+typedef struct {
+    NSUInteger count;
+    NSTimeInterval duration;
+    double mean[3];
+    double rms[3];
+    double min[3];
+    double max[3];
+    // YES when the filter ran forward and backward. Recordings too long to hold as doubles are
+    // filtered causally one span at a time instead, with the phase lag and single pass response.
+    BOOL zeroPhase;
+} AccelerometerLogSummary;
+
+typedef void (^AccelerometerLogPipelineHandler)(AccelerometerLogSummary summary, AccelerometerSampleStore *store,
+                                                AccelerometerLODPyramid *pyramid, NSData *session);
+
+@interface AccelerometerLogPipeline : NSObject
+
+- (id)initWithSettings:(AccelerometerSessionSettings)settings;
+
+// Run an array of MBLAccelerometerData through the pipeline, handler is called on the main queue. When
+// the recording does not fit in memory the handler gets an empty summary and a nil store.
+- (void)processEntries:(NSArray *)entries handler:(AccelerometerLogPipelineHandler)handler;
+
+@property (nonatomic, readonly) AccelerometerSessionSettings settings;
+// Applied with filtfilt before the statistics, see AccelerometerLogSummary.zeroPhase for long
+// recordings. Must not be used elsewhere while the pipeline runs.
+@property (nonatomic) AccelerometerFilter *filter;
+// When set the session file is written here, replacing any earlier one, and the pyramid and the
+// statistics read the recording back through AccelerometerSessionReader over the mapped file. The
+// handler then gets the mapped file as session. Without it, or if writing fails, everything works
+// on the in-memory store.
+@property (nonatomic) NSURL *sessionURL;
+// Nominal sample rate of the log. When set the recording is resampled onto an exactly uniform grid
+// at this rate, correcting board clock drift, before any of the stages see it.
+@property (nonatomic) double resampleRate;
+
+@end
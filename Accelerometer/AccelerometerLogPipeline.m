@@ -0,0 +1,392 @@
+/**
+ * AccelerometerLogPipeline.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerLogPipeline.h"
+#import "AccelerometerLogDecoder.h"
+#import "AccelerometerResampler.h"
+#import "AccelerometerSaturate.h"
+#import <Accelerate/Accelerate.h>
+
+// Entries decoded per task.
+#define kAccelerometerLogPipelineChunkSize 4096
+// Longest recording filtfilt gets for the statistics, 96 MB of doubles or 87 minutes at 800 Hz.
+#define kAccelerometerLogPipelineFiltfiltLimit (1 << 22)
+
+@implementation AccelerometerLogPipeline
+
+- (id)initWithSettings:(AccelerometerSessionSettings)settings
+{
+    self = [super init];
+    if (self != nil) {
+        _settings = settings;
+    }
+    return self;
+}
+
+- (void)processEntries:(NSArray *)entries handler:(AccelerometerLogPipelineHandler)handler
+{
+    AccelerometerSessionSettings settings = self.settings;
+    AccelerometerFilter *filter = self.filter;
+    double resampleRate = self.resampleRate;
+    NSURL *sessionURL = self.sessionURL;
+    dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+    
+    dispatch_async(queue, ^{
+        AccelerometerSampleStore *store = [self decodeEntries:entries queue:queue];
+        if (store && resampleRate > 0.0) {
+            store = [AccelerometerLogPipeline resampleStore:store rate:resampleRate];
+        }
+        if (!store) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                AccelerometerLogSummary empty;
+                memset(&empty, 0, sizeof(empty));
+                handler(empty, nil, nil, nil);
+            });
+            return;
+        }
+        
+        // With a session file the later stages read the mapped file, each through its own reader.
+        NSData *mapped = sessionURL ? [AccelerometerLogPipeline writeStore:store settings:settings toURL:sessionURL] : nil;
+        id<AccelerometerSampleSource> pyramidSource = mapped ? [[AccelerometerSessionReader alloc] initWithData:mapped error:nil] : nil;
+        id<AccelerometerSampleSource> summarySource = mapped ? [[AccelerometerSessionReader alloc] initWithData:mapped error:nil] : nil;
+        
+        __block AccelerometerLODPyramid *pyramid = nil;
+        __block NSData *session = mapped;
+        __block AccelerometerLogSummary summary;
+        dispatch_group_t group = dispatch_group_create();
+        dispatch_group_async(group, queue, ^{
+            pyramid = [[AccelerometerLODPyramid alloc] initWithSampleSource:pyramidSource ?: store];
+        });
+        if (!session) {
+            dispatch_group_async(group, queue, ^{
+                session = [AccelerometerSessionWriter dataWithSampleStore:store settings:settings];
+            });
+        }
+        dispatch_group_async(group, queue, ^{
+            summary = [AccelerometerLogPipeline summarizeSource:summarySource ?: store filter:filter];
+        });
+        dispatch_group_notify(group, dispatch_get_main_queue(), ^{
+            handler(summary, store, pyramid, session);
+        });
+    });
+}
+
+// Write next to url and rename over it, so a mapping of the previous session keeps its own file.
++ (NSData *)writeStore:(AccelerometerSampleStore *)store settings:(AccelerometerSessionSettings)settings toURL:(NSURL *)url
+{
+    NSURL *directory = [url URLByDeletingLastPathComponent];
+    NSURL *temporary = [url URLByAppendingPathExtension:@"tmp"];
+    if (![[NSFileManager defaultManager] createDirectoryAtURL:directory withIntermediateDirectories:YES attributes:nil error:nil] ||
+        ![AccelerometerSessionWriter writeSampleStore:store settings:settings toURL:temporary error:nil] ||
+        rename(temporary.fileSystemRepresentation, url.fileSystemRepresentation) != 0) {
+        [[NSFileManager defaultManager] removeItemAtURL:temporary error:nil];
+        return nil;
+    }
+    return [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:nil];
+}
+
+- (AccelerometerSampleStore *)decodeEntries:(NSArray *)entries queue:(dispatch_queue_t)queue
+{
+    NSUInteger count = entries.count;
+    AccelerometerSampleStore *store = [[AccelerometerSampleStore alloc] init];
+    if (count == 0) {
+        return store;
+    }
+    int16_t *x = malloc(count * 3 * sizeof(int16_t));
+    uint64_t *ticks = malloc(count * sizeof(uint64_t));
+    if (!x || !ticks) {
+        free(x);
+        free(ticks);
+        return nil;
+    }
+    int16_t *y = x + count;
+    int16_t *z = y + count;
+    MBLAccelerometerData *first = entries[0];
+    NSTimeInterval epoch = first.timestamp.timeIntervalSince1970;
+    
+    BOOL raw = [AccelerometerLogPipeline payloadMatchesEntry:first] && [AccelerometerLogPipeline payloadMatchesEntry:[entries lastObject]];
+    
+    // Entries are immutable, so chunks can be read from any thread.
+    size_t chunks = (count + kAccelerometerLogPipelineChunkSize - 1) / kAccelerometerLogPipelineChunkSize;
+    dispatch_apply(chunks, queue, ^(size_t chunk) {
+        NSUInteger firstIndex = chunk * kAccelerometerLogPipelineChunkSize;
+        NSUInteger end = MIN(firstIndex + kAccelerometerLogPipelineChunkSize, count);
+        uint8_t payloads[kAccelerometerLogPipelineChunkSize * kAccelerometerLogPayloadSize];
+        BOOL packed = raw;
+        for (NSUInteger i = firstIndex; i < end; i++) {
+            @autoreleasepool {
+                MBLAccelerometerData *data = entries[i];
+                NSTimeInterval timestamp = data.timestamp.timeIntervalSince1970;
+                if (packed && data.data.length >= kAccelerometerLogPayloadSize) {
+                    [data.data getBytes:payloads + (i - firstIndex) * kAccelerometerLogPayloadSize length:kAccelerometerLogPayloadSize];
+                } else {
+                    packed = NO;
+                    x[i] = SaturateInt16(data.x);
+                    y[i] = SaturateInt16(data.y);
+                    z[i] = SaturateInt16(data.z);
+                }
+                ticks[i] = timestamp > epoch ? llround((timestamp - epoch) * kAccelerometerSampleStoreTicksPerSecond) : 0;
+            }
+        }
+        if (packed) {
+            AccelerometerLogDecodeInt16x3(payloads, end - firstIndex, x + firstIndex, y + firstIndex, z + firstIndex);
+        } else if (raw) {
+            // A short payload turned up part way, redo the chunk from the decoded properties.
+            for (NSUInteger i = firstIndex; i < end; i++) {
+                MBLAccelerometerData *data = entries[i];
+                x[i] = SaturateInt16(data.x);
+                y[i] = SaturateInt16(data.y);
+                z[i] = SaturateInt16(data.z);
+            }
+        }
+    });
+    
+    store.epoch = epoch;
+    BOOL appended = [store appendSamplesX:x y:y z:z ticks:ticks count:count];
+    free(x);
+    free(ticks);
+    return appended ? store : nil;
+}
+
++ (AccelerometerSampleStore *)resampleStore:(AccelerometerSampleStore *)store rate:(double)rate
+{
+    AccelerometerSampleStore *uniform = [[AccelerometerSampleStore alloc] init];
+    uniform.epoch = store.epoch;
+    // The whole log is at hand, so one fit over all of it replaces the running estimate when it succeeds.
+    AccelerometerTimebase timebase;
+    AccelerometerResampler *resampler;
+    if ([AccelerometerLogPipeline fitStore:store rate:rate timebase:&timebase]) {
+        resampler = [[AccelerometerResampler alloc] initWithInputRate:rate outputRate:rate timebase:timebase];
+    } else {
+        resampler = [[AccelerometerResampler alloc] initWithInputRate:rate outputRate:rate];
+    }
+    
+    int16_t *columns = malloc(kAccelerometerResamplerBatch * 3 * sizeof(int16_t));
+    uint64_t *ticks = malloc(kAccelerometerResamplerBatch * sizeof(uint64_t));
+    float *clipped = malloc(kAccelerometerResamplerBatch * sizeof(float));
+    float *input = malloc(kAccelerometerSampleStoreChunkSize * 3 * sizeof(float));
+    __block BOOL failed = !resampler || !columns || !ticks || !clipped || !input;
+    resampler.handler = ^(const float *x, const float *y, const float *z, NSUInteger count, NSTimeInterval firstTime, NSTimeInterval interval) {
+        const float *axes[3] = { x, y, z };
+        const float low = INT16_MIN, high = INT16_MAX;
+        for (int axis = 0; axis < 3; axis++) {
+            // The kernels ring a little past full scale, clip before rounding back to int16.
+            vDSP_vclip(axes[axis], 1, &low, &high, clipped, 1, count);
+            vDSP_vfixr16(clipped, 1, columns + axis * kAccelerometerResamplerBatch, 1, count);
+        }
+        for (NSUInteger i = 0; i < count; i++) {
+            double time = firstTime + i * interval;
+            ticks[i] = time > 0.0 ? llround(time * kAccelerometerSampleStoreTicksPerSecond) : 0;
+        }
+        if (![uniform appendSamplesX:columns y:columns + kAccelerometerResamplerBatch z:columns + 2 * kAccelerometerResamplerBatch ticks:ticks count:count]) {
+            failed = YES;
+        }
+    };
+    
+    [store enumerateSpansInRange:NSMakeRange(0, failed ? 0 : store.count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        vDSP_vflt16(span.x, 1, input, 1, span.count);
+        vDSP_vflt16(span.y, 1, input + kAccelerometerSampleStoreChunkSize, 1, span.count);
+        vDSP_vflt16(span.z, 1, input + 2 * kAccelerometerSampleStoreChunkSize, 1, span.count);
+        if (![resampler addSamplesX:input y:input + kAccelerometerSampleStoreChunkSize z:input + 2 * kAccelerometerSampleStoreChunkSize ticks:span.tick count:span.count]) {
+            failed = YES;
+        }
+        *stop = failed;
+    }];
+    if (!failed) {
+        [resampler finish];
+    }
+    
+    free(input);
+    free(columns);
+    free(ticks);
+    free(clipped);
+    return failed ? nil : uniform;
+}
+
+// Board time n / rate of every sample against its tick in seconds, NO if the fit was rejected.
++ (BOOL)fitStore:(AccelerometerSampleStore *)store rate:(double)rate timebase:(AccelerometerTimebase *)timebase
+{
+    NSUInteger count = store.count;
+    uint64_t *boardTicks = malloc(count * sizeof(uint64_t));
+    double *times = malloc(count * sizeof(double));
+    if (!boardTicks || !times) {
+        free(boardTicks);
+        free(times);
+        return NO;
+    }
+    [store enumerateSpansInRange:NSMakeRange(0, count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        for (NSUInteger i = 0; i < span.count; i++) {
+            boardTicks[span.start + i] = llround((span.start + i) / rate * kAccelerometerTimebaseTicksPerSecond);
+            times[span.start + i] = span.tick[i] / kAccelerometerSampleStoreTicksPerSecond;
+        }
+    }];
+    BOOL fitted = AccelerometerTimebaseFit(boardTicks, times, count, timebase);
+    free(boardTicks);
+    free(times);
+    return fitted;
+}
+
+// Raw payloads are only decoded in bulk when they hold what the framework decoded for the entry.
++ (BOOL)payloadMatchesEntry:(MBLAccelerometerData *)data
+{
+    if (data.data.length < kAccelerometerLogPayloadSize) {
+        return NO;
+    }
+    int16_t x, y, z;
+    AccelerometerLogDecodeInt16x3Scalar(data.data.bytes, 1, &x, &y, &z);
+    return x == data.x && y == data.y && z == data.z;
+}
+
++ (AccelerometerLogSummary)summarizeSource:(id<AccelerometerSampleSource>)source filter:(AccelerometerFilter *)filter
+{
+    __block AccelerometerLogSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    NSUInteger count = source.count;
+    summary.count = count;
+    if (count == 0) {
+        return summary;
+    }
+    AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+    size_t sectionCount = filter ? [filter getSections:sections] : 0;
+    if (sectionCount == 0) {
+        return [AccelerometerLogPipeline streamSummaryOfSource:source sections:NULL count:0];
+    }
+    
+    // filtfilt runs over the whole signal, so here every sample is in memory. One buffer with the x, y
+    // and z columns back to back, blocks cannot capture an array of pointers. Longer recordings, or
+    // when the buffer cannot be had, get the causal filter one span at a time instead.
+    double *values = count <= kAccelerometerLogPipelineFiltfiltLimit ? malloc(3 * count * sizeof(double)) : NULL;
+    if (!values) {
+        return [AccelerometerLogPipeline streamSummaryOfSource:source sections:sections count:sectionCount];
+    }
+    __block uint64_t lastTick = 0;
+    [source enumerateSpansInRange:NSMakeRange(0, count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        vDSP_vflt16D((short *)span.x, 1, values + span.start, 1, span.count);
+        vDSP_vflt16D((short *)span.y, 1, values + count + span.start, 1, span.count);
+        vDSP_vflt16D((short *)span.z, 1, values + 2 * count + span.start, 1, span.count);
+        lastTick = span.tick[span.count - 1];
+    }];
+    summary.duration = lastTick / kAccelerometerSampleStoreTicksPerSecond;
+    summary.zeroPhase = YES;
+    
+    [filter filtfiltX:values y:values + count z:values + 2 * count count:count];
+    
+    dispatch_apply(3, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t axis) {
+        const double *column = values + axis * count;
+        vDSP_meanvD(column, 1, &summary.mean[axis], count);
+        vDSP_rmsqvD(column, 1, &summary.rms[axis], count);
+        vDSP_minvD(column, 1, &summary.min[axis], count);
+        vDSP_maxvD(column, 1, &summary.max[axis], count);
+    });
+    
+    free(values);
+    return summary;
+}
+
+/*
+ Statistics one span at a time, memory stays constant however long the recording is. With sections
+ the spans run through the cascade first, causally, its delay lines settled on the first sample and
+ carried from span to span. Returns an empty summary if the scratch buffer cannot be allocated.
+ */
++ (AccelerometerLogSummary)streamSummaryOfSource:(id<AccelerometerSampleSource>)source
+                                        sections:(const AccelerometerBiquad *)sections count:(size_t)sectionCount
+{
+    __block AccelerometerLogSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    __block double sum[3] = { 0.0, 0.0, 0.0 };
+    __block double squares[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; axis++) {
+        summary.min[axis] = INFINITY;
+        summary.max[axis] = -INFINITY;
+    }
+    AccelerometerBiquadState states[kAccelerometerBiquadMaxSections];
+    AccelerometerBiquadState *cascade = states;
+    __block AccelerometerFilterState state;
+    __block double *scratch = NULL;
+    __block NSUInteger scratchSize = 0;
+    __block BOOL failed = NO;
+    [source enumerateSpansInRange:NSMakeRange(0, source.count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        if (span.count > scratchSize) {
+            free(scratch);
+            scratchSize = span.count;
+            scratch = malloc(3 * scratchSize * sizeof(double));
+            if (!scratch) {
+                failed = YES;
+                *stop = YES;
+                return;
+            }
+        }
+        const int16_t *axes[3] = { span.x, span.y, span.z };
+        if (sectionCount > 0) {
+            if (span.start == 0) {
+                AccelerometerBiquadSettle(sections, cascade, sectionCount, span.x[0], span.y[0], span.z[0]);
+            }
+            AccelerometerBiquadRun(sections, cascade, sectionCount, &state, span.x, span.y, span.z,
+                                   scratch, scratch + scratchSize, scratch + 2 * scratchSize, span.count);
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            double value;
+            double *column = scratch + axis * scratchSize;
+            if (sectionCount == 0) {
+                vDSP_vflt16D((short *)axes[axis], 1, column, 1, span.count);
+            }
+            vDSP_sveD(column, 1, &value, span.count);
+            sum[axis] += value;
+            vDSP_svesqD(column, 1, &value, span.count);
+            squares[axis] += value;
+            vDSP_minvD(column, 1, &value, span.count);
+            summary.min[axis] = MIN(summary.min[axis], value);
+            vDSP_maxvD(column, 1, &value, span.count);
+            summary.max[axis] = MAX(summary.max[axis], value);
+        }
+        summary.count += span.count;
+        summary.duration = span.tick[span.count - 1] / kAccelerometerSampleStoreTicksPerSecond;
+    }];
+    free(scratch);
+    if (failed) {
+        memset(&summary, 0, sizeof(summary));
+        return summary;
+    }
+    
+    if (summary.count > 0) {
+        for (int axis = 0; axis < 3; axis++) {
+            summary.mean[axis] = sum[axis] / summary.count;
+            summary.rms[axis] = sqrt(squares[axis] / summary.count);
+        }
+    }
+    return summary;
+}
+
+@end
@@ -0,0 +1,83 @@
+/**
+ * AccelerometerResampler.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import "AccelerometerResamplerKernels.h"
+
+/*
+ Streaming resampler from the board sample clock onto an exactly uniform grid of phone time, see
+ AccelerometerResamplerKernels.h for the interpolation itself.
+ 
+ An AccelerometerTimebaseEstimator fits the board clock against the tick clock as samples come in,
+ which averages out BLE jitter and follows the drift between them. Outputs sit on multiples of
+ 1 / outputRate in tick time, so separate resamplers at the same rate share a grid.
+ 
+ The board clock is only recovered from the sample count, so the input must not have gaps. Logs
+ downloaded in full satisfy that, a stream that dropped packets does not. When the whole recording is
+ at hand, fit it once with AccelerometerTimebaseFit and pass the result in instead, every output then
+ uses the same timebase.
+ */
+
+// Outputs collected before the handler is called.
+#define kAccelerometerResamplerBatch    256
+
+// count outputs of each axis, output i is at firstTime + i * interval seconds of tick time.
+typedef void (^AccelerometerResamplerHandler)(const float *x, const float *y, const float *z, NSUInteger count,
+                                              NSTimeInterval firstTime, NSTimeInterval interval);
+
+@interface AccelerometerResampler : NSObject
+
+- (id)initWithInputRate:(double)inputRate outputRate:(double)outputRate;
+// Resample with a timebase fitted beforehand rather than the running estimate.
+- (id)initWithInputRate:(double)inputRate outputRate:(double)outputRate timebase:(AccelerometerTimebase)timebase;
+
+// ticks are microseconds, in any epoch as long as it does not change. Returns NO when the history
+// cannot grow, outputs of the samples before the failing one are still handed over.
+- (BOOL)addSamplesX:(const float *)xs y:(const float *)ys z:(const float *)zs ticks:(const uint64_t *)ticks count:(NSUInteger)count;
+// Hand over outputs still waiting for a full batch. Outputs needing samples not yet added stay pending.
+- (void)flush;
+// End of input: produce the outputs up to the time of the last sample, the taps past it reading the
+// last sample repeated, and flush. Call reset before adding more.
+- (void)finish;
+- (void)reset;
+
+@property (nonatomic, copy) AccelerometerResamplerHandler handler;
+
+@property (nonatomic, readonly) double inputRate;
+@property (nonatomic, readonly) double outputRate;
+// Current fit of tick time in seconds against board time in seconds, or the fixed timebase.
+@property (nonatomic, readonly) AccelerometerTimebase timebase;
+
+@end
@@ -0,0 +1,142 @@
+/**
+ * AccelerometerResampler.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerResampler.h"
+
+@implementation AccelerometerResampler
+{
+    AccelerometerResamplerState *state;
+    
+    float batch[3][kAccelerometerResamplerBatch];
+    NSUInteger batchCount;
+    int64_t batchFirstIndex;
+}
+
+- (id)initWithInputRate:(double)inputRate outputRate:(double)outputRate
+{
+    return [self initWithInputRate:inputRate outputRate:outputRate fixedTimebase:NULL];
+}
+
+- (id)initWithInputRate:(double)inputRate outputRate:(double)outputRate timebase:(AccelerometerTimebase)timebase
+{
+    return [self initWithInputRate:inputRate outputRate:outputRate fixedTimebase:&timebase];
+}
+
+- (id)initWithInputRate:(double)inputRate outputRate:(double)outputRate fixedTimebase:(const AccelerometerTimebase *)timebase
+{
+    self = [super init];
+    if (self != nil) {
+        _inputRate = inputRate;
+        _outputRate = outputRate;
+        state = AccelerometerResamplerCreate(inputRate, outputRate, timebase);
+        if (state == NULL) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    AccelerometerResamplerDestroy(state);
+}
+
+- (void)reset
+{
+    AccelerometerResamplerReset(state);
+    batchCount = 0;
+}
+
+- (AccelerometerTimebase)timebase
+{
+    return AccelerometerResamplerTimebase(state);
+}
+
+- (BOOL)addSamplesX:(const float *)xs y:(const float *)ys z:(const float *)zs ticks:(const uint64_t *)ticks count:(NSUInteger)count
+{
+    NSUInteger done = 0;
+    while (done < count) {
+        size_t run = AccelerometerResamplerAdd(state, xs + done, ys + done, zs + done, ticks + done, count - done);
+        // Out of memory, the rest of the input cannot be kept.
+        if (run == 0) {
+            break;
+        }
+        done += run;
+        [self produce];
+    }
+    [self flush];
+    return done == count;
+}
+
+- (void)produce
+{
+    while (YES) {
+        int64_t first;
+        size_t count = AccelerometerResamplerProduce(state, batch[0] + batchCount, batch[1] + batchCount, batch[2] + batchCount,
+                                                     kAccelerometerResamplerBatch - batchCount, &first);
+        if (count == 0) {
+            return;
+        }
+        if (batchCount == 0) {
+            batchFirstIndex = first;
+        }
+        batchCount += count;
+        if (batchCount < kAccelerometerResamplerBatch) {
+            return;
+        }
+        [self flush];
+    }
+}
+
+- (void)finish
+{
+    AccelerometerResamplerFinish(state);
+    [self produce];
+    [self flush];
+}
+
+- (void)flush
+{
+    if (batchCount == 0) {
+        return;
+    }
+    NSUInteger count = batchCount;
+    batchCount = 0;
+    if (self.handler) {
+        self.handler(batch[0], batch[1], batch[2], count, batchFirstIndex / self.outputRate, 1.0 / self.outputRate);
+    }
+}
+
+@end
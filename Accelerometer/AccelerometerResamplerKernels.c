@@ -0,0 +1,296 @@
+/**
+ * AccelerometerResamplerKernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerResamplerKernels.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Input samples kept before the history is compacted or grown.
+#define kAccelerometerResamplerHistory	4096
+
+static const double kPi = 3.14159265358979323846;
+
+static void MakeKernels(AccelerometerResamplerState *state)
+{
+	const int half = kAccelerometerResamplerTaps / 2;
+	// Cutoff in cycles per input sample.
+	double cutoff = 0.5 * fmin(1.0, state->outputRate / state->inputRate) * 0.9;
+	int phase, tap;
+	
+	for(phase = 0; phase < kAccelerometerResamplerPhases; ++phase)
+	{
+		double fraction = (double)phase / kAccelerometerResamplerPhases;
+		double taps[kAccelerometerResamplerTaps];
+		double sum = 0.0;
+		
+		for(tap = 0; tap < kAccelerometerResamplerTaps; ++tap)
+		{
+			// Distance of this tap from the output position, in input samples.
+			double distance = tap - (half - 1) - fraction;
+			double argument = 2.0 * cutoff * distance;
+			double sinc = argument == 0.0 ? 1.0 : sin(kPi * argument) / (kPi * argument);
+			double window = 0.42 + 0.5 * cos(kPi * distance / half) + 0.08 * cos(2.0 * kPi * distance / half);
+			taps[tap] = sinc * window;
+			sum += taps[tap];
+		}
+		// Unity gain at DC for every phase.
+		for(tap = 0; tap < kAccelerometerResamplerTaps; ++tap)
+			state->kernels[phase][tap] = (float)(taps[tap] / sum);
+	}
+}
+
+AccelerometerResamplerState *AccelerometerResamplerCreate(double inputRate, double outputRate, const AccelerometerTimebase *timebase)
+{
+	AccelerometerResamplerState *state = calloc(1, sizeof(AccelerometerResamplerState));
+	int axis;
+	
+	if(!state)
+		return NULL;
+	state->inputRate = inputRate;
+	state->outputRate = outputRate;
+	if(timebase)
+	{
+		state->hasFixedTimebase = 1;
+		state->fixedTimebase = *timebase;
+	}
+	MakeKernels(state);
+	state->historyCapacity = kAccelerometerResamplerHistory;
+	for(axis = 0; axis < 3; ++axis)
+	{
+		state->history[axis] = malloc(state->historyCapacity * sizeof(float));
+		if(!state->history[axis])
+		{
+			AccelerometerResamplerDestroy(state);
+			return NULL;
+		}
+	}
+	AccelerometerResamplerReset(state);
+	return state;
+}
+
+void AccelerometerResamplerDestroy(AccelerometerResamplerState *state)
+{
+	int axis;
+	
+	if(!state)
+		return;
+	for(axis = 0; axis < 3; ++axis)
+		free(state->history[axis]);
+	free(state);
+}
+
+void AccelerometerResamplerReset(AccelerometerResamplerState *state)
+{
+	AccelerometerTimebaseEstimatorReset(&state->estimator);
+	state->historyCount = 0;
+	state->historyStart = 0;
+	state->lastStart = 0;
+	state->inputCount = 0;
+	state->started = 0;
+	state->padding = 0;
+}
+
+AccelerometerTimebase AccelerometerResamplerTimebase(const AccelerometerResamplerState *state)
+{
+	AccelerometerTimebase timebase = AccelerometerTimebaseIdentity;
+	
+	if(state->hasFixedTimebase)
+		return state->fixedTimebase;
+	AccelerometerTimebaseEstimatorGet(&state->estimator, &timebase);
+	return timebase;
+}
+
+// Input index of the first tap of the output at grid index, and the kernel phase it uses.
+static int64_t StartForGridIndex(const AccelerometerResamplerState *state, int64_t index, AccelerometerTimebase timebase, int *phase)
+{
+	const int half = kAccelerometerResamplerTaps / 2;
+	double position = (index / state->outputRate - timebase.offset) * state->inputRate / timebase.rate;
+	double base = floor(position);
+	int64_t start = (int64_t)base - (half - 1);
+	
+	*phase = (int)lround((position - base) * kAccelerometerResamplerPhases);
+	if(*phase == kAccelerometerResamplerPhases)
+	{
+		*phase = 0;
+		start++;
+	}
+	return start;
+}
+
+/*
+ Make room for count more samples, dropping input no output can reach any more. That is input
+ before the last output, and while the next output waits for input, also input well before its taps,
+ so the history stays bounded even when the fit runs ahead of the samples. Returns 0 if the history
+ had to grow and could not.
+ */
+static int MakeRoom(AccelerometerResamplerState *state, size_t count)
+{
+	uint64_t keep = state->lastStart;
+	size_t drop, capacity;
+	int axis;
+	
+	if(state->started)
+	{
+		int phase;
+		int64_t next = StartForGridIndex(state, state->gridIndex, AccelerometerResamplerTimebase(state), &phase) - kAccelerometerResamplerTaps;
+		if(next > (int64_t)keep)
+			keep = (uint64_t)next < state->inputCount ? (uint64_t)next : state->inputCount;
+	}
+	drop = keep > state->historyStart ? (size_t)(keep - state->historyStart) : 0;
+	if(drop)
+	{
+		for(axis = 0; axis < 3; ++axis)
+			memmove(state->history[axis], state->history[axis] + drop, (state->historyCount - drop) * sizeof(float));
+		state->historyCount -= drop;
+		state->historyStart += drop;
+	}
+	
+	capacity = state->historyCapacity;
+	while(state->historyCount + count > capacity)
+		capacity *= 2;
+	if(capacity != state->historyCapacity)
+	{
+		// Each axis keeps its old buffer until every one has grown, capacity only moves once all have.
+		for(axis = 0; axis < 3; ++axis)
+		{
+			float *grown = realloc(state->history[axis], capacity * sizeof(float));
+			if(!grown)
+				return 0;
+			state->history[axis] = grown;
+		}
+		state->historyCapacity = capacity;
+	}
+	return 1;
+}
+
+size_t AccelerometerResamplerAdd(AccelerometerResamplerState *state, const float *x, const float *y, const float *z,
+								 const uint64_t *ticks, size_t count)
+{
+	size_t run, i;
+	
+	// Compacting before the history fills up lets every piece of a stream go in whole.
+	if(state->historyCount + count > state->historyCapacity && !MakeRoom(state, 1))
+		return 0;
+	run = state->historyCapacity - state->historyCount;
+	if(run > count)
+		run = count;
+	memcpy(state->history[0] + state->historyCount, x, run * sizeof(float));
+	memcpy(state->history[1] + state->historyCount, y, run * sizeof(float));
+	memcpy(state->history[2] + state->historyCount, z, run * sizeof(float));
+	for(i = 0; !state->hasFixedTimebase && i < run; ++i)
+		AccelerometerTimebaseEstimatorAdd(&state->estimator, (state->inputCount + i) / state->inputRate, ticks[i] / kAccelerometerTimebaseTicksPerSecond);
+	state->historyCount += run;
+	state->inputCount += run;
+	return run;
+}
+
+size_t AccelerometerResamplerProduce(AccelerometerResamplerState *state, float *outX, float *outY, float *outZ,
+									 size_t capacity, int64_t *firstIndex)
+{
+	const int half = kAccelerometerResamplerTaps / 2;
+	AccelerometerTimebase timebase = AccelerometerResamplerTimebase(state);
+	size_t n = 0;
+	
+	if(!state->started)
+	{
+		double first;
+		
+		if(state->inputCount + state->padding < kAccelerometerResamplerTaps)
+			return 0;
+		// First grid point late enough to have a full set of taps before it.
+		first = timebase.offset + timebase.rate * (half - 1) / state->inputRate;
+		state->gridIndex = (int64_t)ceil(first * state->outputRate);
+		state->started = 1;
+	}
+	*firstIndex = state->gridIndex;
+	
+	while(n < capacity)
+	{
+		const float *kernel, *hx, *hy, *hz;
+		float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+		int phase, tap;
+		int64_t start = StartForGridIndex(state, state->gridIndex, timebase, &phase);
+		
+		// While finishing, only outputs up to the last input, the padding just stands in for the taps after it.
+		if(state->padding && start + (half - 1) + (phase > 0) >= (int64_t)state->inputCount)
+			break;
+		// The fit can move backwards a little, reuse the oldest taps still around rather than stall.
+		if(start < (int64_t)state->historyStart)
+			start = (int64_t)state->historyStart;
+		if(start + kAccelerometerResamplerTaps > (int64_t)(state->inputCount + state->padding))
+			break;
+		
+		kernel = state->kernels[phase];
+		hx = state->history[0] + (start - (int64_t)state->historyStart);
+		hy = state->history[1] + (start - (int64_t)state->historyStart);
+		hz = state->history[2] + (start - (int64_t)state->historyStart);
+		for(tap = 0; tap < kAccelerometerResamplerTaps; ++tap)
+		{
+			sx += hx[tap] * kernel[tap];
+			sy += hy[tap] * kernel[tap];
+			sz += hz[tap] * kernel[tap];
+		}
+		outX[n] = sx;
+		outY[n] = sy;
+		outZ[n] = sz;
+		++n;
+		state->lastStart = (uint64_t)start;
+		state->gridIndex++;
+	}
+	return n;
+}
+
+void AccelerometerResamplerFinish(AccelerometerResamplerState *state)
+{
+	float last[3];
+	size_t i;
+	int axis;
+	
+	// An empty history means no output up to the last input is left.
+	if(state->historyCount == 0 || state->padding)
+		return;
+	for(axis = 0; axis < 3; ++axis)
+		last[axis] = state->history[axis][state->historyCount - 1];
+	// Copies of the last sample after the input, in history only: the estimator and inputCount never see them.
+	if(state->historyCount + kAccelerometerResamplerTaps > state->historyCapacity && !MakeRoom(state, kAccelerometerResamplerTaps))
+		return;
+	for(axis = 0; axis < 3; ++axis)
+	{
+		for(i = 0; i < kAccelerometerResamplerTaps; ++i)
+			state->history[axis][state->historyCount + i] = last[axis];
+	}
+	state->padding = kAccelerometerResamplerTaps;
+}
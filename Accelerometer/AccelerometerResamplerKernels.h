@@ -0,0 +1,122 @@
+/**
+ * AccelerometerResamplerKernels.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Polyphase windowed sinc resampler behind AccelerometerResampler. Plain C, so the kernels are shared
+ by the app and the Linux tests.
+ 
+ Sample n is taken to have been measured at n / inputRate on the board clock, and its tick at that
+ time on the phone clock. Outputs sit on multiples of 1 / outputRate in tick time and each is a
+ windowed sinc interpolation of the input: kAccelerometerResamplerPhases precomputed Blackman
+ windowed kernels of kAccelerometerResamplerTaps taps, the one nearest the fractional position
+ applied to all three axes at once. The kernels low pass at 90% of the lower Nyquist frequency, so
+ downsampling does not alias.
+ 
+ Input is kept in a history that drops whatever no output can reach any more, so memory stays
+ bounded however long the stream runs, and outputs are produced as soon as all their taps are in.
+ */
+
+#ifndef AccelerometerResamplerKernels_h
+#define AccelerometerResamplerKernels_h
+
+#include "AccelerometerTimebase.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerResamplerTaps		16
+#define kAccelerometerResamplerPhases	128
+
+typedef struct {
+	double inputRate, outputRate;
+	float kernels[kAccelerometerResamplerPhases][kAccelerometerResamplerTaps];
+	AccelerometerTimebaseEstimator estimator;
+	int hasFixedTimebase;
+	AccelerometerTimebase fixedTimebase;
+	
+	float *history[3];
+	size_t historyCapacity, historyCount;
+	// Input index of history[axis][0], and of the first tap of the last output.
+	uint64_t historyStart, lastStart;
+	uint64_t inputCount;
+	
+	int started;
+	// Grid index of the next output, its time is gridIndex / outputRate.
+	int64_t gridIndex;
+	// Copies of the last input after it once finished, outputs may read that far.
+	size_t padding;
+} AccelerometerResamplerState;
+
+/*
+ NULL timebase follows the drift with a running AccelerometerTimebaseEstimator, otherwise every output
+ uses the timebase given, typically an AccelerometerTimebaseFit of the whole recording. Returns NULL
+ when out of memory.
+ */
+AccelerometerResamplerState *AccelerometerResamplerCreate(double inputRate, double outputRate, const AccelerometerTimebase *timebase);
+void AccelerometerResamplerDestroy(AccelerometerResamplerState *state);
+void AccelerometerResamplerReset(AccelerometerResamplerState *state);
+
+// Current fit of tick time in seconds against board time in seconds, or the fixed timebase.
+AccelerometerTimebase AccelerometerResamplerTimebase(const AccelerometerResamplerState *state);
+
+/*
+ Append up to count samples, ticks in microseconds in any epoch as long as it does not change.
+ Returns how many were taken, fewer than count when the history is full of input outputs still need,
+ so produce outputs and add the rest. 0 means the history could not grow.
+ */
+size_t AccelerometerResamplerAdd(AccelerometerResamplerState *state, const float *x, const float *y, const float *z,
+								 const uint64_t *ticks, size_t count);
+
+/*
+ Write up to capacity outputs whose taps are all in. Returns the count, output i is at grid index
+ *firstIndex + i. 0 when nothing is ready yet.
+ */
+size_t AccelerometerResamplerProduce(AccelerometerResamplerState *state, float *outX, float *outY, float *outZ,
+									 size_t capacity, int64_t *firstIndex);
+
+/*
+ End of input: outputs up to the time of the last sample become ready, the taps past it read the last
+ sample repeated so the tail keeps its level. Reset before adding more.
+ */
+void AccelerometerResamplerFinish(AccelerometerResamplerState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
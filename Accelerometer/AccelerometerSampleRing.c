@@ -0,0 +1,154 @@
+/**
+ * AccelerometerSampleRing.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+// posix_memalign is POSIX.1-2001, strict C99 builds hide it otherwise.
+#define _POSIX_C_SOURCE 200112L
+
+#include "AccelerometerSampleRing.h"
+#include <stdlib.h>
+#include <string.h>
+
+AccelerometerSampleRing *AccelerometerSampleRingCreate(size_t capacity)
+{
+	size_t size = 1;
+	while(size < capacity)
+		size <<= 1;
+	
+	void *memory = NULL;
+	if(posix_memalign(&memory, kAccelerometerSampleRingLineSize, sizeof(AccelerometerSampleRing)))
+		return NULL;
+	AccelerometerSampleRing *ring = memory;
+	memset(ring, 0, sizeof(*ring));
+	ring->samples = malloc(size * sizeof(AccelerometerRingSample));
+	if(!ring->samples)
+	{
+		free(ring);
+		return NULL;
+	}
+	ring->mask = size - 1;
+	return ring;
+}
+
+void AccelerometerSampleRingDestroy(AccelerometerSampleRing *ring)
+{
+	if(!ring)
+		return;
+	free(ring->samples);
+	free(ring);
+}
+
+static inline void StoreSample(AccelerometerRingSample *slot, const AccelerometerRingSample *sample)
+{
+	__atomic_store(&slot->timestamp, &sample->timestamp, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->x, sample->x, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->y, sample->y, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot->z, sample->z, __ATOMIC_RELAXED);
+}
+
+int AccelerometerSampleRingPush(AccelerometerSampleRing *ring, const AccelerometerRingSample *sample)
+{
+	// Only the producer writes tail, so its own view needs no ordering.
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if(tail - head > ring->mask)
+	{
+		__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+	StoreSample(&ring->samples[tail & ring->mask], sample);
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+void AccelerometerSampleRingPushOverwrite(AccelerometerSampleRing *ring, const AccelerometerRingSample *sample)
+{
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	if(tail > ring->mask)
+	{
+		// Announce the overwrite before making it, a reader that sees the new slot also sees the new floor.
+		__atomic_store_n(&ring->floor, tail - ring->mask, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+	StoreSample(&ring->samples[tail & ring->mask], sample);
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+size_t AccelerometerSampleRingPop(AccelerometerSampleRing *ring, int16_t *x, int16_t *y, int16_t *z, double *timestamps, size_t max)
+{
+	// Only the consumer writes head.
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	size_t count;
+	while(1)
+	{
+		uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		uint64_t floor = __atomic_load_n(&ring->floor, __ATOMIC_ACQUIRE);
+		if(head < floor)
+		{
+			__atomic_fetch_add(&ring->dropped, floor - head, __ATOMIC_RELAXED);
+			head = floor;
+		}
+		count = (size_t)(tail - head);
+		if(count > max)
+			count = max;
+		
+		for(size_t i = 0; i < count; i++)
+		{
+			AccelerometerRingSample *sample = &ring->samples[(head + i) & ring->mask];
+			__atomic_load(&sample->timestamp, &timestamps[i], __ATOMIC_RELAXED);
+			x[i] = __atomic_load_n(&sample->x, __ATOMIC_RELAXED);
+			y[i] = __atomic_load_n(&sample->y, __ATOMIC_RELAXED);
+			z[i] = __atomic_load_n(&sample->z, __ATOMIC_RELAXED);
+		}
+		// Anything below the floor now may have changed under the copy, read again from there.
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&ring->floor, __ATOMIC_RELAXED) <= head)
+			break;
+	}
+	__atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+	return count;
+}
+
+size_t AccelerometerSampleRingCount(const AccelerometerSampleRing *ring)
+{
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint64_t floor = __atomic_load_n(&ring->floor, __ATOMIC_ACQUIRE);
+	return (size_t)(tail - (head > floor ? head : floor));
+}
+
+uint64_t AccelerometerSampleRingDropped(const AccelerometerSampleRing *ring)
+{
+	return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
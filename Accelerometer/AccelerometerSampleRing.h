@@ -0,0 +1,105 @@
+/**
+ * AccelerometerSampleRing.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Lock free single producer, single consumer ring of accelerometer samples.
+ 
+ One thread pushes, typically the BLE callback, and one other thread pops, so the only shared state
+ is the head and tail counters. Each sits on its own cache line and is published with release stores
+ and read with acquire loads through the __atomic builtins, no locks involved. Pushing into a full
+ ring either drops the new sample or, with AccelerometerSampleRingPushOverwrite, the oldest one, and
+ counts the drop, the producer never waits on the consumer. Overwriting never touches head: the
+ producer raises a floor below which samples may be overwritten, fenced before the slot is written,
+ and the consumer skips and counts what lies below it and re-checks it after each copy, see
+ AccelerometerSampleRing.
+ */
+
+#ifndef AccelerometerSampleRing_h
+#define AccelerometerSampleRing_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerSampleRingLineSize	64
+
+typedef struct {
+	// Seconds since 1970.
+	double timestamp;
+	int16_t x, y, z;
+	int16_t reserved;
+} AccelerometerRingSample;
+
+/*
+ Head is written by the consumer only and tail by the producer only. An overwriting push never takes
+ a slot from the consumer: before it writes over sample n it raises floor to n + 1, the oldest sample
+ still intact. The consumer skips everything below floor, and after copying checks floor again and
+ throws away what was overwritten while it read, the way a seqlock reader retries. Slots are read and
+ written with relaxed atomics, so a copy racing an overwrite is discarded rather than undefined.
+ */
+typedef struct {
+	AccelerometerRingSample *samples;
+	uint64_t mask;
+	uint64_t head __attribute__((aligned(kAccelerometerSampleRingLineSize)));
+	uint64_t tail __attribute__((aligned(kAccelerometerSampleRingLineSize)));
+	uint64_t floor;
+	uint64_t dropped __attribute__((aligned(kAccelerometerSampleRingLineSize)));
+} AccelerometerSampleRing;
+
+// Capacity is rounded up to a power of two. Returns NULL when out of memory.
+AccelerometerSampleRing *AccelerometerSampleRingCreate(size_t capacity);
+void AccelerometerSampleRingDestroy(AccelerometerSampleRing *ring);
+
+// Producer side. Returns 0 and counts a drop when the ring is full.
+int AccelerometerSampleRingPush(AccelerometerSampleRing *ring, const AccelerometerRingSample *sample);
+// Producer side. Always stores the sample, overwriting the oldest one when the ring is full. The
+// consumer counts the overwritten samples as dropped when it gets to them.
+void AccelerometerSampleRingPushOverwrite(AccelerometerSampleRing *ring, const AccelerometerRingSample *sample);
+
+// Consumer side. Moves up to max of the oldest samples into the columns and returns how many.
+size_t AccelerometerSampleRingPop(AccelerometerSampleRing *ring, int16_t *x, int16_t *y, int16_t *z, double *timestamps, size_t max);
+
+// Any thread, approximate while the other side is running.
+size_t AccelerometerSampleRingCount(const AccelerometerSampleRing *ring);
+uint64_t AccelerometerSampleRingDropped(const AccelerometerSampleRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
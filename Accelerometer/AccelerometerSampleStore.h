@@ -0,0 +1,105 @@
+/**
+ * AccelerometerSampleStore.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+#import "AccelerometerTimebase.h"
+
+/*
+ Compact columnar storage for accelerometer recordings.
+ 
+ Samples are kept as int16 milli-G x, y, z plus a 64-bit tick of microseconds since epoch, 14 bytes
+ per sample instead of an MBLAccelerometerData and NSDate pair. They are appended into fixed size
+ chunks of kAccelerometerSampleStoreChunkSize samples, so growing never copies existing samples and
+ each column of a chunk is contiguous. Readers get that memory directly through spans.
+ 
+ Wall clock time is only derived from epoch and tick when asked for. Drift of the board clock is
+ corrected in bulk when a downloaded log is resampled, see AccelerometerLogPipeline.
+ */
+
+#define kAccelerometerSampleStoreChunkSize      4096
+#define kAccelerometerSampleStoreTicksPerSecond kAccelerometerTimebaseTicksPerSecond
+
+// A contiguous run of samples inside the store, valid until the store is next modified.
+typedef struct {
+    const int16_t *x;
+    const int16_t *y;
+    const int16_t *z;
+    const uint64_t *tick;
+    // Store index of the first sample in the span.
+    NSUInteger start;
+    NSUInteger count;
+} AccelerometerSampleSpan;
+
+/*
+ Anything samples can be read from in spans, the in-memory store as well as a session file mapped by
+ AccelerometerSessionReader. Code that only reads should take a source, so it works on recordings of
+ any size.
+ */
+@protocol AccelerometerSampleSource <NSObject>
+
+@property (nonatomic, readonly) NSUInteger count;
+// Wall clock time of tick 0 in seconds since 1970.
+@property (nonatomic, readonly) NSTimeInterval epoch;
+
+// Fill span with the longest contiguous run starting at index and return its length, 0 past the end.
+- (NSUInteger)getSpan:(AccelerometerSampleSpan *)span atIndex:(NSUInteger)index;
+- (void)enumerateSpansInRange:(NSRange)range usingBlock:(void (^)(AccelerometerSampleSpan span, BOOL *stop))block;
+
+@end
+
+// Copies hold the samples of the store at the time of the copy, nil when out of memory.
+@interface AccelerometerSampleStore : NSObject <AccelerometerSampleSource, NSCopying>
+
+// Unbounded store.
+- (id)init;
+// Ring store keeping the newest capacity samples, rounded up to whole chunks. Older chunks are recycled.
+- (id)initWithCapacity:(NSUInteger)capacity;
+
+// The appends return NO when a chunk cannot be allocated. Samples before the failing one are kept.
+- (BOOL)appendX:(int16_t)x y:(int16_t)y z:(int16_t)z tick:(uint64_t)tick;
+- (BOOL)appendSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs ticks:(const uint64_t *)ticks count:(NSUInteger)count;
+// The first sample appended sets epoch if it has not been set yet.
+- (BOOL)appendAccelerometerData:(MBLAccelerometerData *)data;
+- (BOOL)appendAccelerometerDataArray:(NSArray *)array;
+- (void)removeAllSamples;
+
+- (NSTimeInterval)timeIntervalSince1970ForTick:(uint64_t)tick;
+
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic) NSTimeInterval epoch;
+@property (nonatomic, readonly) BOOL hasEpoch;
+
+@end
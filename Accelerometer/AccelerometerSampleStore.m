@@ -0,0 +1,249 @@
+/**
+ * AccelerometerSampleStore.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerSampleStore.h"
+#import "AccelerometerSaturate.h"
+
+typedef struct {
+    uint64_t tick[kAccelerometerSampleStoreChunkSize];
+    int16_t x[kAccelerometerSampleStoreChunkSize];
+    int16_t y[kAccelerometerSampleStoreChunkSize];
+    int16_t z[kAccelerometerSampleStoreChunkSize];
+} AccelerometerSampleChunk;
+
+@implementation AccelerometerSampleStore
+{
+    AccelerometerSampleChunk **chunks;
+    NSUInteger chunkCount;
+    NSUInteger chunkTableSize;
+    // 0 for an unbounded store.
+    NSUInteger maxChunks;
+}
+
+- (id)init
+{
+    return [self initWithCapacity:0];
+}
+
+- (id)initWithCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+    if (self != nil) {
+        if (capacity) {
+            // One spare chunk so recycling the oldest one still leaves capacity samples behind.
+            maxChunks = (capacity + kAccelerometerSampleStoreChunkSize - 1) / kAccelerometerSampleStoreChunkSize + 1;
+        }
+    }
+    return self;
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    AccelerometerSampleStore *copy = [[AccelerometerSampleStore allocWithZone:zone] init];
+    NSUInteger used = (_count + kAccelerometerSampleStoreChunkSize - 1) / kAccelerometerSampleStoreChunkSize;
+    copy->chunks = malloc(MAX(used, 1) * sizeof(*chunks));
+    if (!copy->chunks) {
+        return nil;
+    }
+    copy->chunkTableSize = MAX(used, 1);
+    copy->maxChunks = maxChunks;
+    for (NSUInteger i = 0; i < used; i++) {
+        copy->chunks[i] = malloc(sizeof(AccelerometerSampleChunk));
+        if (!copy->chunks[i]) {
+            return nil;
+        }
+        copy->chunkCount++;
+        memcpy(copy->chunks[i], chunks[i], sizeof(AccelerometerSampleChunk));
+    }
+    copy->_count = _count;
+    copy->_epoch = _epoch;
+    copy->_hasEpoch = _hasEpoch;
+    return copy;
+}
+
+- (void)dealloc
+{
+    for (NSUInteger i = 0; i < chunkCount; i++) {
+        free(chunks[i]);
+    }
+    free(chunks);
+}
+
+// NO when out of memory, the store is left as it was.
+- (BOOL)addChunk
+{
+    if (maxChunks && chunkCount == maxChunks) {
+        // Recycle the oldest chunk as the newest one. Whole chunks go at once, so the oldest sample
+        // always sits at the start of chunks[0] and indices need no offset.
+        AccelerometerSampleChunk *oldest = chunks[0];
+        memmove(chunks, chunks + 1, (chunkCount - 1) * sizeof(*chunks));
+        chunks[chunkCount - 1] = oldest;
+        _count -= kAccelerometerSampleStoreChunkSize;
+        return YES;
+    }
+    if (chunkCount == chunkTableSize) {
+        NSUInteger size = chunkTableSize ? chunkTableSize * 2 : 16;
+        AccelerometerSampleChunk **table = realloc(chunks, size * sizeof(*chunks));
+        if (!table) {
+            return NO;
+        }
+        chunks = table;
+        chunkTableSize = size;
+    }
+    AccelerometerSampleChunk *chunk = malloc(sizeof(AccelerometerSampleChunk));
+    if (!chunk) {
+        return NO;
+    }
+    chunks[chunkCount++] = chunk;
+    return YES;
+}
+
+- (BOOL)appendX:(int16_t)x y:(int16_t)y z:(int16_t)z tick:(uint64_t)tick
+{
+    NSUInteger position = _count;
+    if (position / kAccelerometerSampleStoreChunkSize == chunkCount) {
+        if (![self addChunk]) {
+            return NO;
+        }
+        position = _count;
+    }
+    AccelerometerSampleChunk *chunk = chunks[position / kAccelerometerSampleStoreChunkSize];
+    NSUInteger offset = position % kAccelerometerSampleStoreChunkSize;
+    chunk->x[offset] = x;
+    chunk->y[offset] = y;
+    chunk->z[offset] = z;
+    chunk->tick[offset] = tick;
+    _count++;
+    return YES;
+}
+
+- (BOOL)appendSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs ticks:(const uint64_t *)ticks count:(NSUInteger)count
+{
+    NSUInteger done = 0;
+    while (done < count) {
+        NSUInteger position = _count;
+        if (position / kAccelerometerSampleStoreChunkSize == chunkCount) {
+            if (![self addChunk]) {
+                return NO;
+            }
+            position = _count;
+        }
+        AccelerometerSampleChunk *chunk = chunks[position / kAccelerometerSampleStoreChunkSize];
+        NSUInteger offset = position % kAccelerometerSampleStoreChunkSize;
+        NSUInteger run = MIN(count - done, kAccelerometerSampleStoreChunkSize - offset);
+        memcpy(chunk->x + offset, xs + done, run * sizeof(int16_t));
+        memcpy(chunk->y + offset, ys + done, run * sizeof(int16_t));
+        memcpy(chunk->z + offset, zs + done, run * sizeof(int16_t));
+        memcpy(chunk->tick + offset, ticks + done, run * sizeof(uint64_t));
+        _count += run;
+        done += run;
+    }
+    return YES;
+}
+
+- (BOOL)appendAccelerometerData:(MBLAccelerometerData *)data
+{
+    NSTimeInterval timestamp = data.timestamp.timeIntervalSince1970;
+    if (!self.hasEpoch) {
+        self.epoch = timestamp;
+    }
+    uint64_t tick = timestamp > self.epoch ? llround((timestamp - self.epoch) * kAccelerometerSampleStoreTicksPerSecond) : 0;
+    return [self appendX:SaturateInt16(data.x) y:SaturateInt16(data.y) z:SaturateInt16(data.z) tick:tick];
+}
+
+- (BOOL)appendAccelerometerDataArray:(NSArray *)array
+{
+    for (MBLAccelerometerData *data in array) {
+        if (![self appendAccelerometerData:data]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (void)removeAllSamples
+{
+    for (NSUInteger i = 0; i < chunkCount; i++) {
+        free(chunks[i]);
+    }
+    chunkCount = 0;
+    _count = 0;
+    _hasEpoch = NO;
+}
+
+- (void)setEpoch:(NSTimeInterval)epoch
+{
+    _epoch = epoch;
+    _hasEpoch = YES;
+}
+
+- (NSTimeInterval)timeIntervalSince1970ForTick:(uint64_t)tick
+{
+    return self.epoch + tick / kAccelerometerSampleStoreTicksPerSecond;
+}
+
+- (NSUInteger)getSpan:(AccelerometerSampleSpan *)span atIndex:(NSUInteger)index
+{
+    if (index >= _count) {
+        return 0;
+    }
+    AccelerometerSampleChunk *chunk = chunks[index / kAccelerometerSampleStoreChunkSize];
+    NSUInteger offset = index % kAccelerometerSampleStoreChunkSize;
+    
+    span->x = chunk->x + offset;
+    span->y = chunk->y + offset;
+    span->z = chunk->z + offset;
+    span->tick = chunk->tick + offset;
+    span->start = index;
+    span->count = MIN(kAccelerometerSampleStoreChunkSize - offset, _count - index);
+    return span->count;
+}
+
+- (void)enumerateSpansInRange:(NSRange)range usingBlock:(void (^)(AccelerometerSampleSpan span, BOOL *stop))block
+{
+    NSUInteger end = MIN(NSMaxRange(range), _count);
+    NSUInteger index = range.location;
+    BOOL stop = NO;
+    AccelerometerSampleSpan span;
+    
+    while (index < end && !stop) {
+        [self getSpan:&span atIndex:index];
+        span.count = MIN(span.count, end - index);
+        block(span, &stop);
+        index += span.count;
+    }
+}
+
+@end
@@ -0,0 +1,237 @@
+/**
+ * AccelerometerSessionCodec.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerSessionCodec.h"
+#include <string.h>
+
+static inline size_t PackedWords(uint32_t count, unsigned bits)
+{
+	return ((uint64_t)count * bits + 63) / 64;
+}
+
+size_t AccelerometerSessionRawPayloadSize(uint32_t count)
+{
+	return (count * (sizeof(uint64_t) + 3 * sizeof(int16_t)) + 7) & ~(size_t)7;
+}
+
+static void PackBits(uint64_t *out, const uint64_t *values, uint32_t count, unsigned bits)
+{
+	uint64_t bit = 0;
+	uint32_t i;
+	
+	memset(out, 0, PackedWords(count, bits) * sizeof(uint64_t));
+	for(i = 0; bits && i < count; i++, bit += bits)
+	{
+		size_t word = bit >> 6;
+		unsigned shift = bit & 63;
+		
+		out[word] |= values[i] << shift;
+		if(shift + bits > 64)
+			out[word + 1] |= values[i] >> (64 - shift);
+	}
+}
+
+static void UnpackBits(uint64_t *values, const uint64_t *in, uint32_t count, unsigned bits)
+{
+	uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+	uint64_t bit = 0;
+	uint32_t i;
+	
+	if(!bits)
+	{
+		memset(values, 0, count * sizeof(uint64_t));
+		return;
+	}
+	for(i = 0; i < count; i++, bit += bits)
+	{
+		size_t word = bit >> 6;
+		unsigned shift = bit & 63;
+		uint64_t value = in[word] >> shift;
+		
+		if(shift + bits > 64)
+			value |= in[word + 1] << (64 - shift);
+		values[i] = value & mask;
+	}
+}
+
+// Differences between neighbours minus their minimum, which becomes the reference. Returns the bits needed.
+static unsigned Deltas(uint64_t *deltas, const uint64_t *values, uint32_t count, int64_t *reference)
+{
+	int64_t low = INT64_MAX;
+	uint64_t high = 0;
+	uint32_t i;
+	
+	for(i = 1; i < count; i++)
+	{
+		int64_t delta = (int64_t)(values[i] - values[i - 1]);
+		deltas[i - 1] = delta;
+		low = delta < low ? delta : low;
+	}
+	for(i = 1; i < count; i++)
+	{
+		deltas[i - 1] -= (uint64_t)low;
+		high |= deltas[i - 1];
+	}
+	*reference = count > 1 ? low : 0;
+	return high ? 64 - __builtin_clzll(high) : 0;
+}
+
+static void Widen(uint64_t *out, const int16_t *in, uint32_t count)
+{
+	uint32_t i;
+	
+	for(i = 0; i < count; i++)
+		out[i] = (uint64_t)(int64_t)in[i];
+}
+
+void AccelerometerSessionEncodeBlock(AccelerometerSessionBlockHeader *header, uint8_t *payload, uint64_t *scratch,
+									 const uint64_t *tick, const int16_t *x, const int16_t *y, const int16_t *z, uint32_t count)
+{
+	const int16_t *axes[3] = { x, y, z };
+	uint64_t *deltas = scratch + count;
+	size_t packedSize = 0;
+	uint32_t i;
+	int axis, column;
+	
+	memset(header, 0, sizeof(*header));
+	header->firstTick = tick[0];
+	header->lastTick = tick[count - 1];
+	header->count = count;
+	for(axis = 0; axis < 3; axis++)
+	{
+		int16_t low = INT16_MAX, high = INT16_MIN;
+		for(i = 0; i < count; i++)
+		{
+			low = axes[axis][i] < low ? axes[axis][i] : low;
+			high = axes[axis][i] > high ? axes[axis][i] : high;
+		}
+		header->first[axis] = axes[axis][0];
+		header->min[axis] = low;
+		header->max[axis] = high;
+	}
+	
+	// Size the packed payload first, the columns are packed for real only if that wins.
+	for(column = 0; column < 4; column++)
+	{
+		if(column)
+			Widen(scratch, axes[column - 1], count);
+		header->bits[column] = Deltas(deltas, column ? scratch : tick, count, &header->reference[column]);
+		packedSize += PackedWords(count - 1, header->bits[column]) * sizeof(uint64_t);
+	}
+	
+	if(packedSize < AccelerometerSessionRawPayloadSize(count))
+	{
+		uint64_t *out = (uint64_t *)payload;
+		
+		header->encoding = AccelerometerSessionBlockPacked;
+		header->payloadSize = (uint32_t)packedSize;
+		for(column = 0; column < 4; column++)
+		{
+			int64_t reference;
+			if(column)
+				Widen(scratch, axes[column - 1], count);
+			Deltas(deltas, column ? scratch : tick, count, &reference);
+			PackBits(out, deltas, count - 1, header->bits[column]);
+			out += PackedWords(count - 1, header->bits[column]);
+		}
+	}
+	else
+	{
+		header->encoding = AccelerometerSessionBlockRaw;
+		header->payloadSize = (uint32_t)AccelerometerSessionRawPayloadSize(count);
+		memset(payload, 0, header->payloadSize);
+		memcpy(payload, tick, count * sizeof(uint64_t));
+		for(axis = 0; axis < 3; axis++)
+			memcpy(payload + count * (sizeof(uint64_t) + axis * sizeof(int16_t)), axes[axis], count * sizeof(int16_t));
+	}
+}
+
+int AccelerometerSessionDecodeBlock(const AccelerometerSessionBlockHeader *header, const uint8_t *payload, uint64_t *scratch,
+									uint64_t *tick, int16_t *x, int16_t *y, int16_t *z)
+{
+	uint32_t count = header->count, i;
+	int16_t *axes[3] = { x, y, z };
+	const uint64_t *in = (const uint64_t *)payload;
+	size_t packedSize = 0;
+	int axis, column;
+	
+	if(count == 0)
+		return 0;
+	if(header->encoding == AccelerometerSessionBlockRaw)
+	{
+		if(header->payloadSize != AccelerometerSessionRawPayloadSize(count))
+			return 0;
+		memcpy(tick, payload, count * sizeof(uint64_t));
+		for(axis = 0; axis < 3; axis++)
+			memcpy(axes[axis], payload + count * (sizeof(uint64_t) + axis * sizeof(int16_t)), count * sizeof(int16_t));
+		return 1;
+	}
+	if(header->encoding != AccelerometerSessionBlockPacked)
+		return 0;
+	for(column = 0; column < 4; column++)
+	{
+		if(header->bits[column] > 64)
+			return 0;
+		packedSize += PackedWords(count - 1, header->bits[column]) * sizeof(uint64_t);
+	}
+	if(packedSize != header->payloadSize)
+		return 0;
+	
+	for(column = 0; column < 4; column++)
+	{
+		uint64_t reference = (uint64_t)header->reference[column];
+		
+		UnpackBits(scratch, in, count - 1, header->bits[column]);
+		in += PackedWords(count - 1, header->bits[column]);
+		if(column == 0)
+		{
+			tick[0] = header->firstTick;
+			for(i = 1; i < count; i++)
+				tick[i] = tick[i - 1] + scratch[i - 1] + reference;
+		}
+		else
+		{
+			int16_t *values = axes[column - 1];
+			uint64_t value = (uint64_t)(int64_t)header->first[column - 1];
+			values[0] = (int16_t)value;
+			for(i = 1; i < count; i++)
+			{
+				value += scratch[i - 1] + reference;
+				values[i] = (int16_t)value;
+			}
+		}
+	}
+	return 1;
+}
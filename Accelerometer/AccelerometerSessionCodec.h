@@ -0,0 +1,149 @@
+/**
+ * AccelerometerSessionCodec.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ On-disk layout and block codec of the accelerometer session container, see AccelerometerSessionFile.h
+ for the file as a whole. Plain C, so the codec is shared by the app and the Linux tests.
+ 
+ All fields are little endian and every structure is laid out on 8 byte boundaries. A block holds up
+ to blockSize samples. Its payload is either raw, the tick column as uint64 followed by the x, y and z
+ columns as int16 and padded to 8 bytes, or packed. A packed column stores the differences between
+ neighbouring samples minus the smallest difference of the block, each in bits[c] bits, in
+ consecutive uint64 words starting from bit 0. The first value of each column lives in the block
+ header, so a packed column of count samples holds count - 1 differences. The encoder picks whichever
+ payload is smaller.
+ */
+
+#ifndef AccelerometerSessionCodec_h
+#define AccelerometerSessionCodec_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerSessionMagic			"MWAS"
+#define kAccelerometerSessionFooterMagic	"MWAE"
+#define kAccelerometerSessionVersion		1
+#define kAccelerometerSessionBlockSize		1024
+
+// Segment indices of the accelerometer configuration in use when the session was recorded.
+typedef struct {
+	uint8_t fullScaleRange;
+	uint8_t sampleFrequency;
+	uint8_t highPassFilter;
+	uint8_t filterCutoffFreq;
+	uint8_t lowNoise;
+	uint8_t activePowerScheme;
+	uint8_t autoSleep;
+	uint8_t sleepSampleFrequency;
+	uint8_t sleepPowerScheme;
+	uint8_t tapDetectionAxis;
+	uint8_t tapType;
+	uint8_t reserved[5];
+} AccelerometerSessionSettings;
+
+typedef struct {
+	char magic[4];
+	uint16_t version;
+	uint16_t headerSize;
+	uint32_t blockSize;
+	uint32_t reserved;
+	// Seconds since 1970 of tick 0.
+	double epoch;
+	AccelerometerSessionSettings settings;
+} AccelerometerSessionHeader;
+
+enum {
+	AccelerometerSessionBlockRaw = 0,
+	AccelerometerSessionBlockPacked = 1
+};
+
+// Columns are tick, x, y, z in that order wherever there is one entry per column.
+typedef struct {
+	uint64_t firstTick;
+	uint64_t lastTick;
+	uint32_t count;
+	uint32_t payloadSize;
+	int16_t first[3];
+	int16_t min[3];
+	int16_t max[3];
+	uint8_t encoding;
+	uint8_t bits[4];
+	uint8_t reserved;
+	int64_t reference[4];
+} AccelerometerSessionBlockHeader;
+
+typedef struct {
+	// File offset of the block header.
+	uint64_t offset;
+	// Session index of the first sample in the block.
+	uint64_t firstSample;
+	uint64_t firstTick;
+	uint64_t lastTick;
+} AccelerometerSessionIndexEntry;
+
+typedef struct {
+	uint64_t indexOffset;
+	uint64_t blockCount;
+	uint64_t sampleCount;
+	char magic[4];
+	uint32_t reserved;
+} AccelerometerSessionFooter;
+
+// Payload size of a raw block, which is also the most an encoded block of count samples can take.
+size_t AccelerometerSessionRawPayloadSize(uint32_t count);
+
+/*
+ Encode count samples, at least one, into header and payload, which must hold
+ AccelerometerSessionRawPayloadSize(count) bytes. scratch holds 2 * count values.
+ */
+void AccelerometerSessionEncodeBlock(AccelerometerSessionBlockHeader *header, uint8_t *payload, uint64_t *scratch,
+									 const uint64_t *tick, const int16_t *x, const int16_t *y, const int16_t *z, uint32_t count);
+
+/*
+ Decode header->count samples. scratch holds header->count values. Returns 0 if the payload does not
+ match the header, payloadSize must have been checked against the bytes actually available.
+ */
+int AccelerometerSessionDecodeBlock(const AccelerometerSessionBlockHeader *header, const uint8_t *payload, uint64_t *scratch,
+									uint64_t *tick, int16_t *x, int16_t *y, int16_t *z);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * AccelerometerSessionFile.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import "AccelerometerSampleStore.h"
+#import "AccelerometerSessionCodec.h"
+
+/*
+ Binary container for recorded accelerometer sessions. A file is
+ 
+     AccelerometerSessionHeader
+     blocks, each an AccelerometerSessionBlockHeader followed by payloadSize bytes
+     AccelerometerSessionIndexEntry for every block
+     AccelerometerSessionFooter
+ 
+ The structures and the block encoding are in AccelerometerSessionCodec.h. Ticks are microseconds
+ since epoch and should not go backwards, the index relies on that for seeking.
+ */
+
+// Decoded packed blocks the reader keeps around for spans.
+#define kAccelerometerSessionCachedBlocks   4
+
+extern NSString *const AccelerometerSessionErrorDomain;
+
+typedef NS_ENUM(NSInteger, AccelerometerSessionError) {
+    AccelerometerSessionErrorWrite = 1,
+    AccelerometerSessionErrorFormat,
+    AccelerometerSessionErrorVersion,
+    AccelerometerSessionErrorTruncated,
+    AccelerometerSessionErrorMemory
+};
+
+@interface AccelerometerSessionWriter : NSObject
+
+// The stream is opened if needed and closed by finish.
+- (id)initWithOutputStream:(NSOutputStream *)stream settings:(AccelerometerSessionSettings)settings epoch:(NSTimeInterval)epoch;
+
+- (void)appendX:(int16_t)x y:(int16_t)y z:(int16_t)z tick:(uint64_t)tick;
+- (void)appendSpan:(AccelerometerSampleSpan)span;
+// Write the last partial block and the index. Returns NO and sets error if any write failed.
+- (BOOL)finish;
+
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSError *error;
+
++ (NSData *)dataWithSampleStore:(AccelerometerSampleStore *)store settings:(AccelerometerSessionSettings)settings;
++ (BOOL)writeSampleStore:(AccelerometerSampleStore *)store settings:(AccelerometerSessionSettings)settings toURL:(NSURL *)url error:(NSError **)error;
+
+@end
+
+/*
+ Random access to a session without materializing it.
+ 
+ initWithContentsOfURL: maps the file instead of reading it, so a session of any size costs only the
+ pages that are touched plus kAccelerometerSessionCachedBlocks decoded blocks. Spans of raw blocks
+ point straight into the file, spans of packed blocks into the decoded block cache. Spans stay valid
+ until kAccelerometerSessionCachedBlocks other packed blocks have been decoded, so consume them before
+ asking for more. A reader is not thread safe.
+ */
+@interface AccelerometerSessionReader : NSObject <AccelerometerSampleSource>
+
+// The header, footer and index are validated here, block payloads as they are read.
+- (id)initWithData:(NSData *)data error:(NSError **)error;
+- (id)initWithContentsOfURL:(NSURL *)url error:(NSError **)error;
+
+@property (nonatomic, readonly) AccelerometerSessionSettings settings;
+@property (nonatomic, readonly) NSTimeInterval epoch;
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSUInteger blockCount;
+@property (nonatomic, readonly) NSUInteger blockSize;
+
+// Decode a block into arrays of at least blockSize entries and return its sample count, 0 if the block is damaged.
+- (NSUInteger)readBlock:(NSUInteger)block x:(int16_t *)x y:(int16_t *)y z:(int16_t *)z tick:(uint64_t *)tick;
+// Every sample of the session, nil if a block is damaged or out of memory.
+- (AccelerometerSampleStore *)sampleStore;
+
+// Same contract as AccelerometerSampleStore, a span never crosses a block. Returns 0 past the end or for a damaged block.
+- (NSUInteger)getSpan:(AccelerometerSampleSpan *)span atIndex:(NSUInteger)index;
+- (void)enumerateSpansInRange:(NSRange)range usingBlock:(void (^)(AccelerometerSampleSpan span, BOOL *stop))block;
+
+// Index of the first sample at or after tick or time, count if there is none. O(log n) through the block index.
+- (NSUInteger)indexOfSampleAtTick:(uint64_t)tick;
+- (NSUInteger)indexOfSampleAtTimeIntervalSince1970:(NSTimeInterval)time;
+
+@end
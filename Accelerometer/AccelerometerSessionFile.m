@@ -0,0 +1,493 @@
+/**
+ * AccelerometerSessionFile.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerSessionFile.h"
+
+NSString *const AccelerometerSessionErrorDomain = @"AccelerometerSessionErrorDomain";
+
+static NSError *SessionError(AccelerometerSessionError code, NSString *description)
+{
+    return [NSError errorWithDomain:AccelerometerSessionErrorDomain code:code userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+@implementation AccelerometerSessionWriter
+{
+    NSOutputStream *stream;
+    NSMutableData *index;
+    uint64_t offset;
+    uint32_t pending;
+    uint64_t tick[kAccelerometerSessionBlockSize];
+    int16_t x[kAccelerometerSessionBlockSize];
+    int16_t y[kAccelerometerSessionBlockSize];
+    int16_t z[kAccelerometerSessionBlockSize];
+    uint64_t scratch[2 * kAccelerometerSessionBlockSize];
+    uint8_t payload[kAccelerometerSessionBlockSize * (sizeof(uint64_t) + 3 * sizeof(int16_t))];
+}
+
+- (id)initWithOutputStream:(NSOutputStream *)outputStream settings:(AccelerometerSessionSettings)settings epoch:(NSTimeInterval)epoch
+{
+    self = [super init];
+    if (self != nil) {
+        stream = outputStream;
+        index = [NSMutableData data];
+        if (stream.streamStatus == NSStreamStatusNotOpen) {
+            [stream open];
+        }
+        
+        AccelerometerSessionHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, kAccelerometerSessionMagic, sizeof(header.magic));
+        header.version = kAccelerometerSessionVersion;
+        header.headerSize = sizeof(header);
+        header.blockSize = kAccelerometerSessionBlockSize;
+        header.epoch = epoch;
+        header.settings = settings;
+        [self writeBytes:&header length:sizeof(header)];
+    }
+    return self;
+}
+
+- (BOOL)writeBytes:(const void *)bytes length:(NSUInteger)length
+{
+    const uint8_t *position = bytes;
+    while (length && !_error) {
+        NSInteger written = [stream write:position maxLength:length];
+        if (written <= 0) {
+            _error = stream.streamError ?: SessionError(AccelerometerSessionErrorWrite, @"Could not write the session");
+            break;
+        }
+        position += written;
+        length -= written;
+        offset += written;
+    }
+    return _error == nil;
+}
+
+- (void)flushBlock
+{
+    if (!pending) {
+        return;
+    }
+    AccelerometerSessionBlockHeader header;
+    AccelerometerSessionEncodeBlock(&header, payload, scratch, tick, x, y, z, pending);
+    
+    AccelerometerSessionIndexEntry entry = { offset, _count - pending, header.firstTick, header.lastTick };
+    [index appendBytes:&entry length:sizeof(entry)];
+    [self writeBytes:&header length:sizeof(header)];
+    [self writeBytes:payload length:header.payloadSize];
+    pending = 0;
+}
+
+- (void)appendX:(int16_t)xValue y:(int16_t)yValue z:(int16_t)zValue tick:(uint64_t)tickValue
+{
+    x[pending] = xValue;
+    y[pending] = yValue;
+    z[pending] = zValue;
+    tick[pending] = tickValue;
+    _count++;
+    if (++pending == kAccelerometerSessionBlockSize) {
+        [self flushBlock];
+    }
+}
+
+- (void)appendSpan:(AccelerometerSampleSpan)span
+{
+    NSUInteger done = 0;
+    while (done < span.count) {
+        NSUInteger run = MIN(span.count - done, kAccelerometerSessionBlockSize - pending);
+        memcpy(x + pending, span.x + done, run * sizeof(int16_t));
+        memcpy(y + pending, span.y + done, run * sizeof(int16_t));
+        memcpy(z + pending, span.z + done, run * sizeof(int16_t));
+        memcpy(tick + pending, span.tick + done, run * sizeof(uint64_t));
+        pending += run;
+        _count += run;
+        done += run;
+        if (pending == kAccelerometerSessionBlockSize) {
+            [self flushBlock];
+        }
+    }
+}
+
+- (BOOL)finish
+{
+    [self flushBlock];
+    
+    AccelerometerSessionFooter footer;
+    memset(&footer, 0, sizeof(footer));
+    footer.indexOffset = offset;
+    footer.blockCount = index.length / sizeof(AccelerometerSessionIndexEntry);
+    footer.sampleCount = _count;
+    memcpy(footer.magic, kAccelerometerSessionFooterMagic, sizeof(footer.magic));
+    [self writeBytes:index.bytes length:index.length];
+    [self writeBytes:&footer length:sizeof(footer)];
+    [stream close];
+    return _error == nil;
+}
+
++ (NSData *)dataWithSampleStore:(AccelerometerSampleStore *)store settings:(AccelerometerSessionSettings)settings
+{
+    NSOutputStream *stream = [NSOutputStream outputStreamToMemory];
+    AccelerometerSessionWriter *writer = [[AccelerometerSessionWriter alloc] initWithOutputStream:stream settings:settings epoch:store.epoch];
+    [store enumerateSpansInRange:NSMakeRange(0, store.count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        [writer appendSpan:span];
+    }];
+    if (![writer finish]) {
+        return nil;
+    }
+    return [stream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+}
+
++ (BOOL)writeSampleStore:(AccelerometerSampleStore *)store settings:(AccelerometerSessionSettings)settings toURL:(NSURL *)url error:(NSError **)error
+{
+    NSOutputStream *stream = [NSOutputStream outputStreamWithURL:url append:NO];
+    AccelerometerSessionWriter *writer = [[AccelerometerSessionWriter alloc] initWithOutputStream:stream settings:settings epoch:store.epoch];
+    [store enumerateSpansInRange:NSMakeRange(0, store.count) usingBlock:^(AccelerometerSampleSpan span, BOOL *stop) {
+        [writer appendSpan:span];
+        *stop = writer.error != nil;
+    }];
+    if (![writer finish]) {
+        if (error) {
+            *error = writer.error;
+        }
+        return NO;
+    }
+    return YES;
+}
+
+@end
+
+@implementation AccelerometerSessionReader
+{
+    NSData *data;
+    const AccelerometerSessionIndexEntry *index;
+    uint64_t *scratch;
+    // Decoded packed blocks, replaced round robin.
+    NSUInteger cachedBlock[kAccelerometerSessionCachedBlocks];
+    AccelerometerSampleSpan cachedSpan[kAccelerometerSessionCachedBlocks];
+    NSUInteger nextCacheEntry;
+}
+
+- (id)initWithData:(NSData *)sessionData error:(NSError **)error
+{
+    self = [super init];
+    if (self != nil) {
+        data = sessionData;
+        NSError *problem = [self validate];
+        if (problem) {
+            if (error) {
+                *error = problem;
+            }
+            return nil;
+        }
+        scratch = malloc(_blockSize * sizeof(uint64_t));
+        if (!scratch) {
+            if (error) {
+                *error = SessionError(AccelerometerSessionErrorMemory, @"Not enough memory to read the session");
+            }
+            return nil;
+        }
+        for (int i = 0; i < kAccelerometerSessionCachedBlocks; i++) {
+            cachedBlock[i] = NSNotFound;
+        }
+    }
+    return self;
+}
+
+- (id)initWithContentsOfURL:(NSURL *)url error:(NSError **)error
+{
+    NSData *mapped = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:error];
+    if (!mapped) {
+        return nil;
+    }
+    return [self initWithData:mapped error:error];
+}
+
+- (void)dealloc
+{
+    free(scratch);
+    for (int i = 0; i < kAccelerometerSessionCachedBlocks; i++) {
+        free((void *)cachedSpan[i].tick);
+    }
+}
+
+- (NSError *)validate
+{
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    if (length < sizeof(AccelerometerSessionHeader) + sizeof(AccelerometerSessionFooter)) {
+        return SessionError(AccelerometerSessionErrorTruncated, @"The session file is too short");
+    }
+    
+    AccelerometerSessionHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, kAccelerometerSessionMagic, sizeof(header.magic))) {
+        return SessionError(AccelerometerSessionErrorFormat, @"Not an accelerometer session file");
+    }
+    if (header.version != kAccelerometerSessionVersion) {
+        return SessionError(AccelerometerSessionErrorVersion, @"Unsupported session file version");
+    }
+    if (header.headerSize < sizeof(header) || header.blockSize == 0 || header.blockSize > (1 << 24)) {
+        return SessionError(AccelerometerSessionErrorFormat, @"Damaged session header");
+    }
+    
+    AccelerometerSessionFooter footer;
+    memcpy(&footer, bytes + length - sizeof(footer), sizeof(footer));
+    if (memcmp(footer.magic, kAccelerometerSessionFooterMagic, sizeof(footer.magic))) {
+        return SessionError(AccelerometerSessionErrorTruncated, @"The session file was not finished");
+    }
+    uint64_t indexEnd = length - sizeof(footer);
+    if (footer.indexOffset < header.headerSize || footer.indexOffset > indexEnd ||
+        footer.blockCount != (indexEnd - footer.indexOffset) / sizeof(AccelerometerSessionIndexEntry) ||
+        (indexEnd - footer.indexOffset) % sizeof(AccelerometerSessionIndexEntry) || footer.indexOffset % 8) {
+        return SessionError(AccelerometerSessionErrorFormat, @"Damaged session index");
+    }
+    
+    // Every block must sit between the header and the index and hold the samples the index claims.
+    index = (const AccelerometerSessionIndexEntry *)(bytes + footer.indexOffset);
+    for (uint64_t i = 0; i < footer.blockCount; i++) {
+        uint64_t end = i + 1 < footer.blockCount ? index[i + 1].firstSample : footer.sampleCount;
+        if (index[i].offset < header.headerSize || index[i].offset % 8 ||
+            index[i].offset + sizeof(AccelerometerSessionBlockHeader) > footer.indexOffset ||
+            index[i].firstSample >= end || end - index[i].firstSample > header.blockSize) {
+            return SessionError(AccelerometerSessionErrorFormat, @"Damaged session index");
+        }
+    }
+    if (footer.blockCount == 0 && footer.sampleCount) {
+        return SessionError(AccelerometerSessionErrorFormat, @"Damaged session index");
+    }
+    
+    _settings = header.settings;
+    _epoch = header.epoch;
+    _blockSize = header.blockSize;
+    _blockCount = (NSUInteger)footer.blockCount;
+    _count = (NSUInteger)footer.sampleCount;
+    return nil;
+}
+
+- (const AccelerometerSessionBlockHeader *)blockHeader:(NSUInteger)block
+{
+    const AccelerometerSessionBlockHeader *header = (const void *)((const uint8_t *)data.bytes + index[block].offset);
+    uint64_t expected = (block + 1 < _blockCount ? index[block + 1].firstSample : _count) - index[block].firstSample;
+    uint64_t end = index[block].offset + sizeof(*header) + header->payloadSize;
+    uint64_t limit = block + 1 < _blockCount ? index[block + 1].offset : data.length - sizeof(AccelerometerSessionFooter) - _blockCount * sizeof(*index);
+    if (header->count != expected || end > limit) {
+        return NULL;
+    }
+    return header;
+}
+
+- (NSUInteger)readBlock:(NSUInteger)block x:(int16_t *)x y:(int16_t *)y z:(int16_t *)z tick:(uint64_t *)tick
+{
+    if (block >= _blockCount) {
+        return 0;
+    }
+    const AccelerometerSessionBlockHeader *header = [self blockHeader:block];
+    if (!header || !AccelerometerSessionDecodeBlock(header, (const uint8_t *)(header + 1), scratch, tick, x, y, z)) {
+        return 0;
+    }
+    return header->count;
+}
+
+- (AccelerometerSampleStore *)sampleStore
+{
+    AccelerometerSampleStore *store = [[AccelerometerSampleStore alloc] init];
+    store.epoch = _epoch;
+    
+    int16_t *x = malloc(_blockSize * 3 * sizeof(int16_t));
+    int16_t *y = x + _blockSize;
+    int16_t *z = y + _blockSize;
+    uint64_t *tick = malloc(_blockSize * sizeof(uint64_t));
+    if (!x || !tick) {
+        store = nil;
+    }
+    for (NSUInteger block = 0; block < _blockCount && store; block++) {
+        NSUInteger count = [self readBlock:block x:x y:y z:z tick:tick];
+        if (!count || ![store appendSamplesX:x y:y z:z ticks:tick count:count]) {
+            store = nil;
+        }
+    }
+    free(x);
+    free(tick);
+    return store;
+}
+
+// Block holding the sample at index, by binary search over the first sample of every block.
+- (NSUInteger)blockForIndex:(NSUInteger)sampleIndex
+{
+    NSUInteger low = 0, high = _blockCount;
+    while (high - low > 1) {
+        NSUInteger middle = (low + high) / 2;
+        if (index[middle].firstSample <= sampleIndex) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Span covering a whole block, pointing into the file for raw blocks or the cache for packed ones.
+- (BOOL)getBlockSpan:(AccelerometerSampleSpan *)span block:(NSUInteger)block
+{
+    for (int i = 0; i < kAccelerometerSessionCachedBlocks; i++) {
+        if (cachedBlock[i] == block) {
+            *span = cachedSpan[i];
+            return YES;
+        }
+    }
+    const AccelerometerSessionBlockHeader *header = [self blockHeader:block];
+    if (!header) {
+        return NO;
+    }
+    uint32_t count = header->count;
+    const uint8_t *payload = (const uint8_t *)(header + 1);
+    span->start = (NSUInteger)index[block].firstSample;
+    span->count = count;
+    
+    if (header->encoding == AccelerometerSessionBlockRaw) {
+        if (header->payloadSize != AccelerometerSessionRawPayloadSize(count)) {
+            return NO;
+        }
+        span->tick = (const uint64_t *)payload;
+        span->x = (const int16_t *)(payload + count * sizeof(uint64_t));
+        span->y = span->x + count;
+        span->z = span->y + count;
+        return YES;
+    }
+    
+    NSUInteger entry = nextCacheEntry;
+    AccelerometerSampleSpan *cached = &cachedSpan[entry];
+    if (!cached->tick) {
+        uint64_t *tick = malloc(_blockSize * (sizeof(uint64_t) + 3 * sizeof(int16_t)));
+        if (!tick) {
+            return NO;
+        }
+        cached->tick = tick;
+        cached->x = (const int16_t *)(tick + _blockSize);
+        cached->y = cached->x + _blockSize;
+        cached->z = cached->y + _blockSize;
+    }
+    cachedBlock[entry] = NSNotFound;
+    if (!AccelerometerSessionDecodeBlock(header, payload, scratch, (uint64_t *)cached->tick, (int16_t *)cached->x, (int16_t *)cached->y, (int16_t *)cached->z)) {
+        return NO;
+    }
+    cached->start = span->start;
+    cached->count = count;
+    cachedBlock[entry] = block;
+    nextCacheEntry = (entry + 1) % kAccelerometerSessionCachedBlocks;
+    *span = *cached;
+    return YES;
+}
+
+- (NSUInteger)getSpan:(AccelerometerSampleSpan *)span atIndex:(NSUInteger)sampleIndex
+{
+    if (sampleIndex >= _count) {
+        return 0;
+    }
+    AccelerometerSampleSpan whole;
+    if (![self getBlockSpan:&whole block:[self blockForIndex:sampleIndex]]) {
+        return 0;
+    }
+    NSUInteger offset = sampleIndex - whole.start;
+    span->x = whole.x + offset;
+    span->y = whole.y + offset;
+    span->z = whole.z + offset;
+    span->tick = whole.tick + offset;
+    span->start = sampleIndex;
+    span->count = whole.count - offset;
+    return span->count;
+}
+
+- (void)enumerateSpansInRange:(NSRange)range usingBlock:(void (^)(AccelerometerSampleSpan span, BOOL *stop))block
+{
+    NSUInteger end = MIN(NSMaxRange(range), _count);
+    NSUInteger sampleIndex = range.location;
+    BOOL stop = NO;
+    AccelerometerSampleSpan span;
+    
+    while (sampleIndex < end && !stop) {
+        if (![self getSpan:&span atIndex:sampleIndex]) {
+            break;
+        }
+        span.count = MIN(span.count, end - sampleIndex);
+        block(span, &stop);
+        sampleIndex += span.count;
+    }
+}
+
+- (NSUInteger)indexOfSampleAtTick:(uint64_t)tick
+{
+    // First block that ends at or after tick, then the first sample inside it.
+    NSUInteger low = 0, high = _blockCount;
+    while (low < high) {
+        NSUInteger middle = (low + high) / 2;
+        if (index[middle].lastTick < tick) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == _blockCount) {
+        return _count;
+    }
+    if (index[low].firstTick >= tick) {
+        return (NSUInteger)index[low].firstSample;
+    }
+    
+    AccelerometerSampleSpan span;
+    if (![self getBlockSpan:&span block:low]) {
+        return _count;
+    }
+    NSUInteger first = 0, last = span.count;
+    while (first < last) {
+        NSUInteger middle = (first + last) / 2;
+        if (span.tick[middle] < tick) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return span.start + first;
+}
+
+- (NSUInteger)indexOfSampleAtTimeIntervalSince1970:(NSTimeInterval)time
+{
+    if (time <= _epoch) {
+        return 0;
+    }
+    return [self indexOfSampleAtTick:llround((time - _epoch) * kAccelerometerSampleStoreTicksPerSecond)];
+}
+
+@end
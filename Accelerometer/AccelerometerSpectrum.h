@@ -0,0 +1,85 @@
+/**
+ * AccelerometerSpectrum.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Streaming spectral analysis of accelerometer samples.
+ 
+ Samples are collected into a circular window of windowSize samples per axis. As soon as the window
+ is first filled and then every hopSize samples the window has its mean removed, is multiplied by a
+ Hann window and run through a real FFT by AccelerometerSpectrumKernels. The plan and every buffer
+ are created once in the initializer, so steady state analysis does not allocate or move samples
+ around. A new spectrum is available at most hopSize samples after the newest sample in it, which
+ bounds the latency to hopSize / sampleRate seconds once the first window is filled.
+ */
+
+// Strongest non DC component of each axis in one window.
+typedef struct {
+    double frequency[3];
+    float power[3];
+} AccelerometerSpectrumPeaks;
+
+/*
+ Called once per window with the one sided power spectrum of each axis, binCount entries spaced
+ binWidth Hz apart starting at DC. The buffers are reused, copy anything that must outlive the call.
+ */
+typedef void (^AccelerometerSpectrumHandler)(const float *powerX, const float *powerY, const float *powerZ,
+                                             NSUInteger binCount, AccelerometerSpectrumPeaks peaks);
+
+@interface AccelerometerSpectrum : NSObject
+
+// windowSize must be a power of two between 16 and 16384, hopSize between 1 and windowSize. Returns
+// nil otherwise or when out of memory.
+- (id)initWithSampleRate:(double)rate windowSize:(NSUInteger)windowSize hopSize:(NSUInteger)hopSize;
+
+- (void)addX:(double)x y:(double)y z:(double)z;
+- (void)addSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count;
+
+// Drop any partially filled window.
+- (void)reset;
+
+@property (nonatomic, copy) AccelerometerSpectrumHandler handler;
+
+@property (nonatomic, readonly) double sampleRate;
+@property (nonatomic, readonly) NSUInteger windowSize;
+@property (nonatomic, readonly) NSUInteger hopSize;
+@property (nonatomic, readonly) NSUInteger binCount;
+@property (nonatomic, readonly) double binWidth;
+
+// Peaks of the most recent window.
+@property (nonatomic, readonly) AccelerometerSpectrumPeaks peaks;
+
+@end
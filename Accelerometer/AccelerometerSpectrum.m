@@ -0,0 +1,145 @@
+/**
+ * AccelerometerSpectrum.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerSpectrum.h"
+#import "AccelerometerSpectrumKernels.h"
+
+@implementation AccelerometerSpectrum
+{
+    AccelerometerSpectrumPlan *plan;
+    // Per axis circular windows of the newest samples, next is where the following sample goes.
+    float *samples[3];
+    float *power[3];
+    NSUInteger next;
+    NSUInteger filled;
+    NSUInteger sinceHop;
+}
+
+- (id)initWithSampleRate:(double)rate windowSize:(NSUInteger)windowSize hopSize:(NSUInteger)hopSize
+{
+    self = [super init];
+    if (self != nil) {
+        if (hopSize < 1 || hopSize > windowSize) {
+            return nil;
+        }
+        plan = AccelerometerSpectrumPlanCreate(windowSize);
+        if (!plan) {
+            return nil;
+        }
+        
+        _sampleRate = rate;
+        _windowSize = windowSize;
+        _hopSize = hopSize;
+        _binCount = windowSize / 2 + 1;
+        _binWidth = rate / windowSize;
+        
+        for (int axis = 0; axis < 3; axis++) {
+            samples[axis] = calloc(windowSize, sizeof(float));
+            power[axis] = calloc(_binCount, sizeof(float));
+            if (!samples[axis] || !power[axis]) {
+                return nil;
+            }
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    AccelerometerSpectrumPlanDestroy(plan);
+    for (int axis = 0; axis < 3; axis++) {
+        free(samples[axis]);
+        free(power[axis]);
+    }
+}
+
+- (void)reset
+{
+    next = 0;
+    filled = 0;
+    sinceHop = 0;
+}
+
+- (void)addX:(double)x y:(double)y z:(double)z
+{
+    samples[0][next] = x;
+    samples[1][next] = y;
+    samples[2][next] = z;
+    [self advance];
+}
+
+- (void)addSamplesX:(const int16_t *)xs y:(const int16_t *)ys z:(const int16_t *)zs count:(NSUInteger)count
+{
+    for (NSUInteger i = 0; i < count; i++) {
+        samples[0][next] = xs[i];
+        samples[1][next] = ys[i];
+        samples[2][next] = zs[i];
+        [self advance];
+    }
+}
+
+// The window only moves its write position, the kernel reads it starting from the oldest sample.
+- (void)advance
+{
+    next = (next + 1) & (self.windowSize - 1);
+    // The first window is analyzed as soon as it is full, later ones every hopSize samples.
+    if (filled < self.windowSize) {
+        if (++filled < self.windowSize) {
+            return;
+        }
+    } else if (++sinceHop < self.hopSize) {
+        return;
+    }
+    sinceHop = 0;
+    [self analyzeWindow];
+}
+
+- (void)analyzeWindow
+{
+    AccelerometerSpectrumPeaks peaks;
+    
+    for (int axis = 0; axis < 3; axis++) {
+        // The mean is removed first, so gravity and any other offset cannot win the peak search.
+        AccelerometerSpectrumPower(plan, samples[axis], next, power[axis]);
+        peaks.frequency[axis] = AccelerometerSpectrumPeak(power[axis], self.binCount, self.binWidth, &peaks.power[axis]);
+    }
+    _peaks = peaks;
+    
+    if (self.handler) {
+        self.handler(power[0], power[1], power[2], self.binCount, peaks);
+    }
+}
+
+@end
@@ -0,0 +1,213 @@
+/**
+ * AccelerometerSpectrumKernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerSpectrumKernels.h"
+#include <math.h>
+#include <stdlib.h>
+
+// M_PI is an extension of math.h, not part of C99.
+static const double kPi = 3.14159265358979323846;
+
+struct AccelerometerSpectrumPlan {
+	size_t n;
+	float *window;
+	float energy;
+	// Complex FFT of n / 2 points: bit reversal permutation and e^(-2 pi i k / (n / 2)) for k < n / 4.
+	uint32_t *reverse;
+	float *cosine, *sine;
+	// e^(-2 pi i k / n) for k <= n / 2, used by the split.
+	float *splitCosine, *splitSine;
+	float *re, *im;
+};
+
+AccelerometerSpectrumPlan *AccelerometerSpectrumPlanCreate(size_t windowSize)
+{
+	AccelerometerSpectrumPlan *plan;
+	size_t half = windowSize / 2, bits = 0, i, j;
+	
+	if(windowSize < kAccelerometerSpectrumMinWindow || windowSize > kAccelerometerSpectrumMaxWindow || (windowSize & (windowSize - 1)))
+		return NULL;
+	plan = calloc(1, sizeof(*plan));
+	if(!plan)
+		return NULL;
+	plan->n = windowSize;
+	plan->window = malloc(windowSize * sizeof(float));
+	plan->reverse = malloc(half * sizeof(uint32_t));
+	plan->cosine = malloc(half / 2 * sizeof(float));
+	plan->sine = malloc(half / 2 * sizeof(float));
+	plan->splitCosine = malloc((half + 1) * sizeof(float));
+	plan->splitSine = malloc((half + 1) * sizeof(float));
+	plan->re = malloc(half * sizeof(float));
+	plan->im = malloc(half * sizeof(float));
+	if(!plan->window || !plan->reverse || !plan->cosine || !plan->sine || !plan->splitCosine || !plan->splitSine || !plan->re || !plan->im)
+	{
+		AccelerometerSpectrumPlanDestroy(plan);
+		return NULL;
+	}
+	
+	// Periodic Hann window, its scale cancels in the normalization by the window energy.
+	plan->energy = 0.0f;
+	for(i = 0; i < windowSize; ++i)
+	{
+		plan->window[i] = (float)(0.5 * (1.0 - cos(2.0 * kPi * i / windowSize)));
+		plan->energy += plan->window[i] * plan->window[i];
+	}
+	
+	while(((size_t)1 << bits) < half)
+		bits++;
+	for(i = 0; i < half; ++i)
+	{
+		uint32_t r = 0;
+		for(j = 0; j < bits; ++j)
+			r |= (uint32_t)((i >> j) & 1) << (bits - 1 - j);
+		plan->reverse[i] = r;
+	}
+	for(i = 0; i < half / 2; ++i)
+	{
+		plan->cosine[i] = (float)cos(2.0 * kPi * i / half);
+		plan->sine[i] = (float)-sin(2.0 * kPi * i / half);
+	}
+	for(i = 0; i <= half; ++i)
+	{
+		plan->splitCosine[i] = (float)cos(2.0 * kPi * i / windowSize);
+		plan->splitSine[i] = (float)-sin(2.0 * kPi * i / windowSize);
+	}
+	return plan;
+}
+
+void AccelerometerSpectrumPlanDestroy(AccelerometerSpectrumPlan *plan)
+{
+	if(!plan)
+		return;
+	free(plan->window);
+	free(plan->reverse);
+	free(plan->cosine);
+	free(plan->sine);
+	free(plan->splitCosine);
+	free(plan->splitSine);
+	free(plan->re);
+	free(plan->im);
+	free(plan);
+}
+
+// In place forward FFT of the half size complex sequence, input already in bit reversed order.
+static void ComplexFFT(const AccelerometerSpectrumPlan *plan, float *restrict re, float *restrict im, size_t count)
+{
+	size_t size, start, k;
+	
+	for(size = 2; size <= count; size *= 2)
+	{
+		size_t span = size / 2, stride = count / size;
+		
+		for(start = 0; start < count; start += size)
+		{
+			for(k = 0; k < span; ++k)
+			{
+				float wr = plan->cosine[k * stride], wi = plan->sine[k * stride];
+				size_t a = start + k, b = a + span;
+				float tr = re[b] * wr - im[b] * wi;
+				float ti = re[b] * wi + im[b] * wr;
+				
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+}
+
+void AccelerometerSpectrumPower(AccelerometerSpectrumPlan *plan, const float *samples, size_t start, float *power)
+{
+	size_t n = plan->n, half = n / 2, i, k;
+	float *re = plan->re, *im = plan->im;
+	float scale = 1.0f / plan->energy;
+	double sum = 0.0;
+	float mean;
+	
+	for(i = 0; i < n; ++i)
+		sum += samples[i];
+	mean = (float)(sum / n);
+	
+	// Even samples become the real part and odd samples the imaginary part, stored bit reversed.
+	for(i = 0; i < half; ++i)
+	{
+		size_t even = (start + 2 * i) & (n - 1), odd = (even + 1) & (n - 1);
+		uint32_t r = plan->reverse[i];
+		
+		re[r] = (samples[even] - mean) * plan->window[2 * i];
+		im[r] = (samples[odd] - mean) * plan->window[2 * i + 1];
+	}
+	ComplexFFT(plan, re, im, half);
+	
+	// X[k] = E[k] + e^(-2 pi i k / n) O[k], E and O recovered from Z[k] and conj(Z[half - k]).
+	power[0] = (re[0] + im[0]) * (re[0] + im[0]) * scale;
+	power[half] = (re[0] - im[0]) * (re[0] - im[0]) * scale;
+	for(k = 1; k < half; ++k)
+	{
+		float ar = re[k], ai = im[k], br = re[half - k], bi = -im[half - k];
+		float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+		float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+		float wr = plan->splitCosine[k], wi = plan->splitSine[k];
+		float xr = er + or_ * wr - oi * wi;
+		float xi = ei + or_ * wi + oi * wr;
+		
+		// One sided, the negative frequencies fold onto the positive ones.
+		power[k] = 2.0f * (xr * xr + xi * xi) * scale;
+	}
+}
+
+double AccelerometerSpectrumPeak(const float *power, size_t binCount, double binWidth, float *peakPower)
+{
+	size_t bin = 1, i;
+	double offset = 0.0;
+	
+	for(i = 2; i < binCount; ++i)
+	{
+		if(power[i] > power[bin])
+			bin = i;
+	}
+	// Parabolic interpolation between the neighbouring bins.
+	if(bin + 1 < binCount)
+	{
+		double a = power[bin - 1], b = power[bin], c = power[bin + 1];
+		double denominator = a - 2.0 * b + c;
+		if(denominator != 0.0)
+			offset = 0.5 * (a - c) / denominator;
+	}
+	if(peakPower)
+		*peakPower = power[bin];
+	return (bin + offset) * binWidth;
+}
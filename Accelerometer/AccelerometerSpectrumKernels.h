@@ -0,0 +1,82 @@
+/**
+ * AccelerometerSpectrumKernels.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Windowed power spectrum kernel behind AccelerometerSpectrum.
+ 
+ Plain C like the filter kernels, so the same code runs in the app and in the Linux benchmarks. A plan
+ holds everything a window size needs: the Hann window, bit reversal and twiddle tables, and scratch
+ space, so analyzing a window never allocates. The real input of n samples is transformed as a
+ complex FFT of n / 2 points, iterative radix 2, followed by the split that separates the spectra of
+ the even and odd samples again.
+ */
+
+#ifndef AccelerometerSpectrumKernels_h
+#define AccelerometerSpectrumKernels_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerSpectrumMinWindow		16
+#define kAccelerometerSpectrumMaxWindow		16384
+
+typedef struct AccelerometerSpectrumPlan AccelerometerSpectrumPlan;
+
+// windowSize must be a power of two between kAccelerometerSpectrumMinWindow and kAccelerometerSpectrumMaxWindow.
+AccelerometerSpectrumPlan *AccelerometerSpectrumPlanCreate(size_t windowSize);
+void AccelerometerSpectrumPlanDestroy(AccelerometerSpectrumPlan *plan);
+
+/*
+ One sided power spectrum of windowSize samples read from a circular buffer of that size, oldest
+ sample at index start. The mean is removed and the Hann window applied first. Writes windowSize / 2 + 1
+ bins starting at DC, normalized by the window energy so a bin holds power per bin.
+ */
+void AccelerometerSpectrumPower(AccelerometerSpectrumPlan *plan, const float *samples, size_t start, float *power);
+
+/*
+ Strongest bin of power other than DC, refined by parabolic interpolation with its neighbours.
+ Returns the frequency in Hz and stores the power of the bin in peakPower.
+ */
+double AccelerometerSpectrumPeak(const float *power, size_t binCount, double binWidth, float *peakPower);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
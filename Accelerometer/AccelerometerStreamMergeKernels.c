@@ -0,0 +1,384 @@
+/**
+ * AccelerometerStreamMergeKernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerStreamMergeKernels.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline AccelerometerMergedFrame *Slot(AccelerometerMergeStream *stream, size_t offset)
+{
+	return &stream->frames[(stream->head + offset) % kAccelerometerStreamMergeCapacity];
+}
+
+static inline double HeadTime(const AccelerometerStreamMergeState *state, size_t index)
+{
+	const AccelerometerMergeStream *stream = &state->streams[index];
+	return stream->frames[stream->head].time;
+}
+
+// Where the fit expects board sample index to arrive.
+static inline double Predict(const AccelerometerStreamMergeState *state, const AccelerometerMergeStream *stream, uint64_t index)
+{
+	return stream->timebase.offset + stream->timebase.rate * (index / state->sampleRate);
+}
+
+static void ResetStream(AccelerometerMergeStream *stream)
+{
+	AccelerometerMergedFrame *frames = stream->frames;
+	
+	memset(stream, 0, sizeof(*stream));
+	stream->frames = frames;
+	stream->timebase = AccelerometerTimebaseIdentity;
+	stream->lastArrival = -INFINITY;
+	stream->lastTime = -INFINITY;
+	stream->rejectedSince = INFINITY;
+	stream->active = 1;
+}
+
+/*
+ West's weighted update with every earlier weight scaled by the forgetting factor first, so the means
+ and co-moments are those of an exponentially weighted least squares fit.
+ */
+static void FitAdd(const AccelerometerStreamMergeState *state, AccelerometerMergeStream *stream, double t, double h)
+{
+	double dt, rate;
+	
+	if(stream->weight == 0.0)
+	{
+		stream->originT = t;
+		stream->originH = h;
+	}
+	t -= stream->originT;
+	h -= stream->originH;
+	
+	stream->weight = state->forgetting * stream->weight + 1.0;
+	dt = t - stream->meanT;
+	stream->meanT += dt / stream->weight;
+	stream->meanH += (h - stream->meanH) / stream->weight;
+	stream->varianceT = state->forgetting * stream->varianceT + dt * (t - stream->meanT);
+	stream->covariance = state->forgetting * stream->covariance + dt * (h - stream->meanH);
+	
+	if(stream->weight >= kAccelerometerStreamMergeMinFit && stream->varianceT > 0.0)
+	{
+		rate = stream->covariance / stream->varianceT;
+		if(fabs(rate - 1.0) <= kAccelerometerTimebaseMaxSkew)
+			stream->timebase.rate = rate;
+	}
+	stream->timebase.offset = stream->originH + stream->meanH - stream->timebase.rate * (stream->originT + stream->meanT);
+}
+
+// Fit the next board sample against its arrival and place it on the phone clock. 0 when it is late.
+static int TimeNext(AccelerometerStreamMergeState *state, AccelerometerMergeStream *stream, double arrival, double *time)
+{
+	double boardTime = stream->sampleIndex / state->sampleRate;
+	double expected = Predict(state, stream, stream->sampleIndex);
+	
+	stream->sampleIndex++;
+	// Delays only ever make arrivals later, the tail of a stall must not drag the fit along.
+	if(stream->weight < kAccelerometerStreamMergeMinFit || arrival <= expected + kAccelerometerStreamMergeFitReject)
+		stream->rejectedSince = INFINITY;
+	else if(stream->rejectedSince == INFINITY)
+		stream->rejectedSince = arrival;
+	if(stream->rejectedSince == INFINITY || arrival - stream->rejectedSince >= kAccelerometerStreamMergeFitRecover)
+		FitAdd(state, stream, boardTime, arrival);
+	else
+		stream->rejectedSamples++;
+	// A refit may pull the line back a little, the stream's own frames still stay in order.
+	*time = fmax(stream->timebase.offset + stream->timebase.rate * boardTime, stream->lastTime);
+	stream->lastTime = *time;
+	if(*time > state->newestTime)
+		state->newestTime = *time;
+	if(*time < state->emittedTime)
+	{
+		state->lateFrames++;
+		return 0;
+	}
+	return 1;
+}
+
+static void SiftDown(AccelerometerStreamMergeState *state, size_t index, size_t count)
+{
+	size_t *heap = state->heap;
+	
+	for(;;)
+	{
+		size_t smallest = index, left = 2 * index + 1, right = left + 1, swap;
+		
+		if(left < count && HeadTime(state, heap[left]) < HeadTime(state, heap[smallest]))
+			smallest = left;
+		if(right < count && HeadTime(state, heap[right]) < HeadTime(state, heap[smallest]))
+			smallest = right;
+		if(smallest == index)
+			return;
+		swap = heap[index];
+		heap[index] = heap[smallest];
+		heap[smallest] = swap;
+		index = smallest;
+	}
+}
+
+static void MergeUpTo(AccelerometerStreamMergeState *state, double limit)
+{
+	size_t heapCount = 0, i;
+	
+	for(i = 0; i < state->streamCount; ++i)
+	{
+		if(state->streams[i].count)
+			state->heap[heapCount++] = i;
+	}
+	for(i = heapCount / 2; i-- > 0;)
+		SiftDown(state, i, heapCount);
+	
+	while(heapCount)
+	{
+		AccelerometerMergeStream *stream = &state->streams[state->heap[0]];
+		AccelerometerMergedFrame *frame = &stream->frames[stream->head];
+		
+		if(frame->time > limit)
+			break;
+		state->output[state->outputCount++] = *frame;
+		state->emittedTime = frame->time;
+		state->mergedFrames++;
+		stream->head = (stream->head + 1) % kAccelerometerStreamMergeCapacity;
+		if(--stream->count == 0)
+			state->heap[0] = state->heap[--heapCount];
+		SiftDown(state, 0, heapCount);
+	}
+}
+
+static double Watermark(const AccelerometerStreamMergeState *state)
+{
+	double watermark = INFINITY;
+	size_t i;
+	
+	for(i = 0; i < state->streamCount; ++i)
+	{
+		const AccelerometerMergeStream *stream = &state->streams[i];
+		// A stream that has not delivered for maxLatency is not waited for, one that never did counts from the first arrival.
+		double lastArrival = stream->lastArrival == -INFINITY ? state->firstArrival : stream->lastArrival;
+		if(stream->active && lastArrival >= state->newestArrival - state->maxLatency && stream->lastTime < watermark)
+			watermark = stream->lastTime;
+	}
+	if(watermark == INFINITY)
+		watermark = state->newestTime;
+	return fmax(watermark, state->newestTime - state->maxLatency);
+}
+
+// Skip lateness worth of lost samples and time the held ones, in place behind the timed ones.
+static void Release(AccelerometerStreamMergeState *state, AccelerometerMergeStream *stream, double lateness)
+{
+	uint64_t skip = lateness > 0.0 ? (uint64_t)llround(lateness * state->sampleRate) : 0;
+	size_t base = stream->count, held = stream->held, i;
+	
+	stream->sampleIndex += skip;
+	stream->skippedSamples += skip;
+	stream->held = 0;
+	// Reads never fall behind writes, a late frame leaves a hole the next one fills.
+	for(i = 0; i < held; ++i)
+	{
+		AccelerometerMergedFrame frame = *Slot(stream, base + i);
+		if(TimeNext(state, stream, frame.time, &frame.time))
+			*Slot(stream, stream->count++) = frame;
+	}
+}
+
+// Free a slot in a full queue, held samples that filled it alone are taken as a stall.
+static void MakeRoom(AccelerometerStreamMergeState *state, AccelerometerMergeStream *stream)
+{
+	if(stream->count + stream->held < kAccelerometerStreamMergeCapacity)
+		return;
+	if(!stream->count)
+		Release(state, stream, 0.0);
+	if(stream->count)
+		MergeUpTo(state, stream->frames[stream->head].time);
+}
+
+AccelerometerStreamMergeState *AccelerometerStreamMergeCreate(double sampleRate, double maxLatency)
+{
+	AccelerometerStreamMergeState *state = calloc(1, sizeof(AccelerometerStreamMergeState));
+	
+	if(!state)
+		return NULL;
+	state->sampleRate = sampleRate;
+	state->maxLatency = maxLatency;
+	state->forgetting = 1.0 - 1.0 / (kAccelerometerStreamMergeFitSeconds * sampleRate);
+	AccelerometerStreamMergeReset(state);
+	return state;
+}
+
+void AccelerometerStreamMergeDestroy(AccelerometerStreamMergeState *state)
+{
+	if(!state)
+		return;
+	AccelerometerStreamMergeReset(state);
+	free(state);
+}
+
+void AccelerometerStreamMergeReset(AccelerometerStreamMergeState *state)
+{
+	size_t i;
+	
+	for(i = 0; i < state->streamCount; ++i)
+		free(state->streams[i].frames);
+	free(state->streams);
+	free(state->heap);
+	free(state->output);
+	state->streams = NULL;
+	state->heap = NULL;
+	state->output = NULL;
+	state->streamCount = 0;
+	state->outputCount = 0;
+	state->outputCapacity = 0;
+	state->emittedTime = -INFINITY;
+	state->firstArrival = -INFINITY;
+	state->newestArrival = -INFINITY;
+	state->newestTime = -INFINITY;
+	state->mergedFrames = 0;
+	state->lateFrames = 0;
+}
+
+long AccelerometerStreamMergeAddStream(AccelerometerStreamMergeState *state)
+{
+	AccelerometerMergedFrame *frames = malloc(kAccelerometerStreamMergeCapacity * sizeof(AccelerometerMergedFrame));
+	AccelerometerMergeStream *streams = realloc(state->streams, (state->streamCount + 1) * sizeof(AccelerometerMergeStream));
+	size_t *heap;
+	
+	if(streams)
+		state->streams = streams;
+	heap = realloc(state->heap, (state->streamCount + 1) * sizeof(size_t));
+	if(heap)
+		state->heap = heap;
+	if(!frames || !streams || !heap)
+	{
+		free(frames);
+		return -1;
+	}
+	state->streams[state->streamCount].frames = frames;
+	ResetStream(&state->streams[state->streamCount]);
+	return (long)state->streamCount++;
+}
+
+int AccelerometerStreamMergeAdd(AccelerometerStreamMergeState *state, size_t index, const int16_t *x, const int16_t *y,
+								const int16_t *z, const double *arrivals, size_t count)
+{
+	AccelerometerMergeStream *stream = &state->streams[index];
+	size_t needed = state->outputCount + count, i;
+	double lateness, time;
+	
+	// Everything buffered and everything added could come out of this one call.
+	for(i = 0; i < state->streamCount; ++i)
+		needed += state->streams[i].count + state->streams[i].held;
+	if(needed > state->outputCapacity)
+	{
+		AccelerometerMergedFrame *output = realloc(state->output, needed * sizeof(AccelerometerMergedFrame));
+		if(!output)
+			return 0;
+		state->output = output;
+		state->outputCapacity = needed;
+	}
+	
+	stream->active = 1;
+	for(i = 0; i < count; ++i)
+	{
+		AccelerometerMergedFrame *frame;
+		double arrival = arrivals[i];
+		
+		stream->lastArrival = arrival;
+		if(state->firstArrival == -INFINITY)
+			state->firstArrival = arrival;
+		if(arrival > state->newestArrival)
+			state->newestArrival = arrival;
+		MakeRoom(state, stream);
+		
+		lateness = stream->weight >= kAccelerometerStreamMergeMinFit ? arrival - Predict(state, stream, stream->sampleIndex + stream->held) : 0.0;
+		if(lateness > kAccelerometerStreamMergeGapTolerance)
+		{
+			// Still catching up while the lateness keeps falling.
+			if(!stream->held || lateness < stream->settledFrom - kAccelerometerStreamMergeGapJitter)
+			{
+				stream->settledFrom = lateness;
+				stream->settledArrival = arrival;
+				stream->settledLateness = 0.0;
+				stream->settledCount = 0;
+			}
+			stream->settledLateness += lateness;
+			stream->settledCount++;
+			frame = Slot(stream, stream->count + stream->held++);
+			frame->time = arrival;
+			frame->stream = (uint32_t)index;
+			frame->x = x[i];
+			frame->y = y[i];
+			frame->z = z[i];
+			// The fit runs through the middle of the jitter, so the mean lateness is the length of the gap.
+			if(arrival - stream->settledArrival >= kAccelerometerStreamMergeGapConfirm)
+				Release(state, stream, stream->settledLateness / stream->settledCount);
+			continue;
+		}
+		// On time again, whatever was held was a stall.
+		if(stream->held)
+			Release(state, stream, 0.0);
+		if(!TimeNext(state, stream, arrival, &time))
+			continue;
+		frame = Slot(stream, stream->count++);
+		frame->time = time;
+		frame->stream = (uint32_t)index;
+		frame->x = x[i];
+		frame->y = y[i];
+		frame->z = z[i];
+	}
+	MergeUpTo(state, Watermark(state));
+	return 1;
+}
+
+void AccelerometerStreamMergeEnd(AccelerometerStreamMergeState *state, size_t stream)
+{
+	if(state->streams[stream].held)
+		Release(state, &state->streams[stream], 0.0);
+	state->streams[stream].active = 0;
+	MergeUpTo(state, Watermark(state));
+}
+
+void AccelerometerStreamMergeFlush(AccelerometerStreamMergeState *state)
+{
+	size_t i;
+	
+	for(i = 0; i < state->streamCount; ++i)
+	{
+		if(state->streams[i].held)
+			Release(state, &state->streams[i], 0.0);
+	}
+	MergeUpTo(state, INFINITY);
+}
@@ -0,0 +1,166 @@
+/**
+ * AccelerometerStreamMergeKernels.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Clock alignment and k-way merge behind AccelerometerStreamMerger. Plain C, so the kernels are shared
+ by the app and the Linux tests.
+ 
+ Every stream is a board sampling at sampleRate on a clock of its own, whose samples reach the phone
+ in BLE bursts. Sample n of a stream is taken at n / sampleRate board seconds, and a least squares fit
+ of arrival time against board time maps that onto the phone clock. The fit forgets exponentially
+ with a time constant of kAccelerometerStreamMergeFitSeconds, so it follows the drift of a warming
+ board and never turns as stiff as a fit over the whole stream. Below kAccelerometerStreamMergeMinFit
+ samples the rate stays nominal, and a fitted rate off by more than kAccelerometerTimebaseMaxSkew
+ keeps the last good one. Delays only ever make arrivals later, so an arrival more than
+ kAccelerometerStreamMergeFitReject after the fit is left out of it, and the late tail of a stall
+ cannot drag it along. Arrivals that stay late for kAccelerometerStreamMergeFitRecover seconds are
+ a connection whose delay changed, and are fitted again.
+ 
+ An arrival more than kAccelerometerStreamMergeGapTolerance after the fit is a stalled connection or
+ lost samples, and only what follows tells them apart: a stall ends in a burst that catches up with
+ the fit, lost samples leave every later arrival late by the same amount. Late samples are held back
+ untimed until one of them is on time again, and nothing was lost, or their lateness has settled for
+ kAccelerometerStreamMergeGapConfirm seconds of arrivals, and the stream skips ahead by the mean
+ lateness since it settled. Held samples that fill the queue, are flushed or ended count as a stall.
+ 
+ Timed samples wait in a fixed size queue per stream. A k-way merge over a binary heap of the queue
+ heads hands out everything up to the watermark, the oldest newest time among streams still
+ delivering, so a frame only goes out once no other stream can still produce an earlier one. The
+ watermark never trails the newest time by more than maxLatency, a stream that fell silent holds
+ nobody up, and a full queue forces out frames up to its own head. A stream added before it delivers
+ is waited for as if it had delivered the first sample of all. Samples timed behind frames already
+ merged are dropped and counted in lateFrames, the output never goes back in time.
+ 
+ Merged frames collect in output for the caller to take after every call. Nothing here locks.
+ */
+
+#ifndef AccelerometerStreamMergeKernels_h
+#define AccelerometerStreamMergeKernels_h
+
+#include "AccelerometerTimebase.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per stream queue, the bound on buffered samples.
+#define kAccelerometerStreamMergeCapacity		1024
+// Arrivals this much later than the fit are a suspected gap, well above BLE connection interval jitter.
+#define kAccelerometerStreamMergeGapTolerance	0.25
+// Seconds of arrivals over which the lateness of held samples has to settle before they are a gap.
+#define kAccelerometerStreamMergeGapConfirm		0.1
+// Lateness falling by less than this is settled, a catching up burst falls faster.
+#define kAccelerometerStreamMergeGapJitter		0.02
+// Samples fitted before gaps are looked for, the fit is too loose before that.
+#define kAccelerometerStreamMergeMinFit			32
+// Time constant of the clock fit in board seconds.
+#define kAccelerometerStreamMergeFitSeconds		30.0
+// Arrivals this much later than the fit expects are left out of it.
+#define kAccelerometerStreamMergeFitReject		0.05
+// Seconds of arrivals left out after which they enter the fit again, the delay itself has changed.
+#define kAccelerometerStreamMergeFitRecover		1.0
+
+typedef struct {
+	// Seconds on the phone clock.
+	double time;
+	// Index of the stream the sample came from.
+	uint32_t stream;
+	int16_t x, y, z;
+} AccelerometerMergedFrame;
+
+typedef struct {
+	// Ring of count timed frames from head, then held frames, which carry their arrival as time.
+	AccelerometerMergedFrame *frames;
+	size_t head, count, held;
+	// Forgetting fit of arrival against board seconds, both relative to the first pair.
+	double weight, originT, originH, meanT, meanH, varianceT, covariance;
+	// Board seconds onto the phone clock.
+	AccelerometerTimebase timebase;
+	// Board sample number of the next sample to be timed.
+	uint64_t sampleIndex;
+	uint64_t skippedSamples, rejectedSamples;
+	// Arrival of the first of the late samples left out of the fit in a row.
+	double rejectedSince;
+	// Lateness and arrival of the held sample after which the lateness stopped falling by more than a
+	// jitter, and the summed lateness of the settledCount held samples since.
+	double settledFrom, settledArrival, settledLateness;
+	size_t settledCount;
+	double lastArrival, lastTime;
+	int active;
+} AccelerometerMergeStream;
+
+typedef struct {
+	double sampleRate, maxLatency;
+	// Weight a pair keeps in the fit for every later one.
+	double forgetting;
+	AccelerometerMergeStream *streams;
+	size_t streamCount;
+	// Stream indices ordered by the time of their head frame, rebuilt for every merge.
+	size_t *heap;
+	AccelerometerMergedFrame *output;
+	size_t outputCount, outputCapacity;
+	// Time of the last frame merged, nothing earlier may follow it.
+	double emittedTime;
+	double firstArrival, newestArrival, newestTime;
+	uint64_t mergedFrames, lateFrames;
+} AccelerometerStreamMergeState;
+
+// Returns NULL when out of memory.
+AccelerometerStreamMergeState *AccelerometerStreamMergeCreate(double sampleRate, double maxLatency);
+void AccelerometerStreamMergeDestroy(AccelerometerStreamMergeState *state);
+// Forget every stream, frame and counter, output included.
+void AccelerometerStreamMergeReset(AccelerometerStreamMergeState *state);
+
+// Index of a new stream, -1 when out of memory.
+long AccelerometerStreamMergeAddStream(AccelerometerStreamMergeState *state);
+
+/*
+ Samples of a stream in arrival order, arrivals in seconds on the phone clock. Returns 0 and takes
+ nothing when the output could not grow.
+ */
+int AccelerometerStreamMergeAdd(AccelerometerStreamMergeState *state, size_t stream, const int16_t *x, const int16_t *y,
+								const int16_t *z, const double *arrivals, size_t count);
+// No more samples are coming from stream, the watermark stops waiting for it until it adds again.
+void AccelerometerStreamMergeEnd(AccelerometerStreamMergeState *state, size_t stream);
+// Time every held sample and merge everything buffered.
+void AccelerometerStreamMergeFlush(AccelerometerStreamMergeState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * AccelerometerStreamMerger.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+#import "AccelerometerStreamingManager.h"
+#import "AccelerometerStreamMergeKernels.h"
+
+/*
+ Merges the accelerometer streams of several MetaWears into one time ordered stream of frames.
+ 
+ The timestamps of streamed samples are phone arrival times, which jitter with the BLE connection
+ interval, and each board samples on a clock of its own that drifts against the phone. The merger
+ fits every device's board clock against its arrivals, tells lost samples from stalls and hands out
+ frames in time order once no other device can still produce an earlier one, all in
+ AccelerometerStreamMergeKernels, which describes the rules. A single device has nothing to be
+ merged with and keeps the timestamps AccelerometerStreamingManager gives it, use this only when more
+ than one device streams.
+ 
+ Samples may be added from any thread. Merged frames are handed to the handler outside the merger's
+ lock, on a thread that added samples, removed a device or flushed, never concurrently and always in
+ order. A call that finds another thread delivering leaves its frames to that thread rather than
+ waiting, so the handler may call back into the merger, except for -reset, which waits for them.
+ */
+
+// Most frames per handler call.
+#define kAccelerometerStreamMergerBatch         256
+#define kAccelerometerStreamMergerDefaultLatency 0.25
+
+typedef void (^AccelerometerStreamMergerHandler)(const AccelerometerMergedFrame *frames, NSUInteger count);
+
+@interface AccelerometerStreamMerger : NSObject
+
+- (id)initWithSampleRate:(double)sampleRate;
+
+// Samples of device in arrival order, timestamps as AccelerometerStreamingManager delivers them.
+- (void)addSamplesFromDevice:(MBLMetaWear *)device x:(const int16_t *)x y:(const int16_t *)y z:(const int16_t *)z
+                  timestamps:(const double *)timestamps count:(NSUInteger)count;
+// No more samples are coming from device, the watermark stops waiting for it.
+- (void)removeDevice:(MBLMetaWear *)device;
+// Hand over every buffered frame.
+- (void)flush;
+// Flush and wait until every frame is handed over, then forget every device and counter. Not from the handler.
+- (void)reset;
+
+// Consumer for -[AccelerometerStreamingManager addDevice:consumer:] feeding this merger.
+- (AccelerometerStreamingConsumer)consumer;
+
+// Current fit of the device's board time in seconds onto the phone clock.
+- (AccelerometerTimebase)timebaseForDevice:(MBLMetaWear *)device;
+
+@property (nonatomic, copy) AccelerometerStreamMergerHandler handler;
+
+@property (nonatomic, readonly) double sampleRate;
+// Seconds a frame may wait for slower devices, set before adding samples.
+@property (nonatomic) NSTimeInterval maxLatency;
+// Devices in the order they first delivered samples, AccelerometerMergedFrame.stream indexes this.
+@property (nonatomic, readonly) NSArray *devices;
+@property (nonatomic, readonly) uint64_t mergedFrames;
+@property (nonatomic, readonly) uint64_t lateFrames;
+
+@end
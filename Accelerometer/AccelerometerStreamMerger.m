@@ -0,0 +1,246 @@
+/**
+ * AccelerometerStreamMerger.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerStreamMerger.h"
+#import <pthread.h>
+
+@implementation AccelerometerStreamMerger
+{
+    pthread_mutex_t lock;
+    // Signalled whenever a thread stops delivering.
+    pthread_cond_t delivered;
+    AccelerometerStreamMergeState *state;
+    NSMutableDictionary *indices;
+    NSMutableArray *deviceList;
+    // Frames merged but not yet handed to the handler, in order.
+    NSMutableData *pending;
+    // YES while some thread is calling the handler, others leave their frames in pending for it.
+    BOOL delivering;
+}
+
+- (id)initWithSampleRate:(double)sampleRate
+{
+    self = [super init];
+    if (self != nil) {
+        state = AccelerometerStreamMergeCreate(sampleRate, kAccelerometerStreamMergerDefaultLatency);
+        if (!state) {
+            return nil;
+        }
+        pthread_mutex_init(&lock, NULL);
+        pthread_cond_init(&delivered, NULL);
+        _sampleRate = sampleRate;
+        indices = [NSMutableDictionary dictionary];
+        deviceList = [NSMutableArray array];
+        pending = [NSMutableData data];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (state) {
+        AccelerometerStreamMergeDestroy(state);
+        pthread_cond_destroy(&delivered);
+        pthread_mutex_destroy(&lock);
+    }
+}
+
+- (void)reset
+{
+    // What was buffered up to now still goes out, only then is everything forgotten.
+    pthread_mutex_lock(&lock);
+    AccelerometerStreamMergeFlush(state);
+    [self takeOutput];
+    [self deliverAndUnlock];
+    // A thread that was already delivering took our frames over, they are only handed out once it stops.
+    pthread_mutex_lock(&lock);
+    while (delivering) {
+        pthread_cond_wait(&delivered, &lock);
+    }
+    AccelerometerStreamMergeReset(state);
+    [indices removeAllObjects];
+    [deviceList removeAllObjects];
+    pthread_mutex_unlock(&lock);
+}
+
+- (NSTimeInterval)maxLatency
+{
+    pthread_mutex_lock(&lock);
+    NSTimeInterval maxLatency = state->maxLatency;
+    pthread_mutex_unlock(&lock);
+    return maxLatency;
+}
+
+- (void)setMaxLatency:(NSTimeInterval)maxLatency
+{
+    pthread_mutex_lock(&lock);
+    state->maxLatency = maxLatency;
+    pthread_mutex_unlock(&lock);
+}
+
+- (uint64_t)mergedFrames
+{
+    pthread_mutex_lock(&lock);
+    uint64_t mergedFrames = state->mergedFrames;
+    pthread_mutex_unlock(&lock);
+    return mergedFrames;
+}
+
+- (uint64_t)lateFrames
+{
+    pthread_mutex_lock(&lock);
+    uint64_t lateFrames = state->lateFrames;
+    pthread_mutex_unlock(&lock);
+    return lateFrames;
+}
+
+- (NSArray *)devices
+{
+    pthread_mutex_lock(&lock);
+    NSArray *devices = [deviceList copy];
+    pthread_mutex_unlock(&lock);
+    return devices;
+}
+
+// Stream of device in the merge state, NSNotFound when it has none and create is NO or memory ran out.
+- (NSUInteger)streamForDevice:(MBLMetaWear *)device create:(BOOL)create
+{
+    NSNumber *index = indices[device.identifier];
+    if (index) {
+        return index.unsignedIntegerValue;
+    }
+    if (!create) {
+        return NSNotFound;
+    }
+    long stream = AccelerometerStreamMergeAddStream(state);
+    if (stream < 0) {
+        return NSNotFound;
+    }
+    indices[device.identifier] = @(stream);
+    [deviceList addObject:device];
+    return stream;
+}
+
+// Move what the merge produced into pending, with lock held.
+- (void)takeOutput
+{
+    [pending appendBytes:state->output length:state->outputCount * sizeof(AccelerometerMergedFrame)];
+    state->outputCount = 0;
+}
+
+- (void)addSamplesFromDevice:(MBLMetaWear *)device x:(const int16_t *)x y:(const int16_t *)y z:(const int16_t *)z
+                  timestamps:(const double *)timestamps count:(NSUInteger)count
+{
+    pthread_mutex_lock(&lock);
+    NSUInteger stream = [self streamForDevice:device create:YES];
+    if (stream == NSNotFound || !AccelerometerStreamMergeAdd(state, stream, x, y, z, timestamps, count)) {
+        pthread_mutex_unlock(&lock);
+        NSLog(@"Unable to allocate merge buffers for %@", device.identifier.UUIDString);
+        return;
+    }
+    [self takeOutput];
+    [self deliverAndUnlock];
+}
+
+// Called with lock held, returns with it released. The handler runs unlocked on pending frames swapped
+// out under the lock, and only one thread delivers at a time so batches keep their order. A thread
+// that finds another delivering leaves its frames for that one to pick up.
+- (void)deliverAndUnlock
+{
+    if (delivering) {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    delivering = YES;
+    NSMutableData *ready = [NSMutableData data];
+    while (pending.length) {
+        NSMutableData *swap = pending;
+        pending = ready;
+        ready = swap;
+        AccelerometerStreamMergerHandler handler = self.handler;
+        pthread_mutex_unlock(&lock);
+        
+        const AccelerometerMergedFrame *frames = ready.bytes;
+        NSUInteger count = ready.length / sizeof(AccelerometerMergedFrame);
+        for (NSUInteger i = 0; handler && i < count; i += kAccelerometerStreamMergerBatch) {
+            handler(frames + i, MIN(count - i, kAccelerometerStreamMergerBatch));
+        }
+        ready.length = 0;
+        pthread_mutex_lock(&lock);
+    }
+    delivering = NO;
+    pthread_cond_broadcast(&delivered);
+    pthread_mutex_unlock(&lock);
+}
+
+- (void)removeDevice:(MBLMetaWear *)device
+{
+    pthread_mutex_lock(&lock);
+    NSUInteger stream = [self streamForDevice:device create:NO];
+    if (stream != NSNotFound) {
+        AccelerometerStreamMergeEnd(state, stream);
+        [self takeOutput];
+    }
+    [self deliverAndUnlock];
+}
+
+- (void)flush
+{
+    pthread_mutex_lock(&lock);
+    AccelerometerStreamMergeFlush(state);
+    [self takeOutput];
+    [self deliverAndUnlock];
+}
+
+- (AccelerometerStreamingConsumer)consumer
+{
+    return ^(MBLMetaWear *device, const int16_t *x, const int16_t *y, const int16_t *z, const double *timestamps, NSUInteger count) {
+        [self addSamplesFromDevice:device x:x y:y z:z timestamps:timestamps count:count];
+    };
+}
+
+- (AccelerometerTimebase)timebaseForDevice:(MBLMetaWear *)device
+{
+    AccelerometerTimebase timebase = AccelerometerTimebaseIdentity;
+    pthread_mutex_lock(&lock);
+    NSUInteger stream = [self streamForDevice:device create:NO];
+    if (stream != NSNotFound) {
+        timebase = state->streams[stream].timebase;
+    }
+    pthread_mutex_unlock(&lock);
+    return timebase;
+}
+
+@end
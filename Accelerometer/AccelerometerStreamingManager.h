@@ -0,0 +1,112 @@
+/**
+ * AccelerometerStreamingManager.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+
+/*
+ Accelerometer streaming from many connected MetaWears at once.
+ 
+ Every device gets an AccelerometerSampleRing. Its dataReadyEvent handler only copies the sample into
+ the ring, and when no drain is pending yet schedules one drainInterval later on a serial queue of its
+ own that targets the global concurrent queue. A drain hands everything that came in meanwhile to the
+ consumer in blocks of blockSize samples, only the last one may be shorter. Drains run for different
+ devices side by side on the worker pool while each ring still has exactly one consumer.
+ 
+ What happens when a consumer falls behind and its ring fills up is the backpressure policy of the
+ device. None of them ever waits, the callback queue is shared by every device. Every outcome is
+ counted in its AccelerometerStreamingCounters, once a device is removed received equals delivered
+ plus dropped plus coalesced.
+ 
+ Callbacks should come in on a serial queue other than the main one, see
+ -[MBLMetaWearManager setCallbackQueue:], so the producer side never competes with UIKit. The manager
+ itself is used from the main queue. Consumers must not dispatch_sync to the main queue,
+ removeDevice: waits for them there.
+ */
+
+#define kAccelerometerStreamingRingCapacity     8192
+// Largest blockSize, consumers can size their scratch space with it.
+#define kAccelerometerStreamingBatch            512
+#define kAccelerometerStreamingDefaultBlockSize 64
+#define kAccelerometerStreamingDefaultInterval  (1.0 / 60.0)
+
+typedef NS_ENUM(NSInteger, AccelerometerBackpressure) {
+    // Drop the sample that does not fit.
+    AccelerometerBackpressureDropNewest = 0,
+    // Make room by dropping the oldest sample in the ring.
+    AccelerometerBackpressureDropOldest,
+    // Keep only the newest of the samples that do not fit, it goes in as soon as there is room.
+    AccelerometerBackpressureCoalesce
+};
+
+typedef struct {
+    uint64_t received;
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t coalesced;
+} AccelerometerStreamingCounters;
+
+// Called on the device's drain queue, never concurrently for the same device.
+typedef void (^AccelerometerStreamingConsumer)(MBLMetaWear *device, const int16_t *x, const int16_t *y, const int16_t *z,
+                                               const double *timestamps, NSUInteger count);
+
+@interface AccelerometerStreamingManager : NSObject
+
+- (id)initWithRingCapacity:(NSUInteger)capacity;
+
+// Start notifications on the accelerometer of a connected device, calling consumer with its samples.
+// The device keeps the backpressure, blockSize and drainInterval in effect when it was added.
+- (void)addDevice:(MBLMetaWear *)device consumer:(AccelerometerStreamingConsumer)consumer;
+// Stop notifications and return once every sample already received has gone through the consumer.
+- (void)removeDevice:(MBLMetaWear *)device;
+- (void)removeAllDevices;
+
+// Run block on the drain queue of a device between two consumer calls and return once it has run, for
+// reading what the consumer fills without stopping the stream. Runs block right away for other devices.
+- (void)performOnDrainQueueOfDevice:(MBLMetaWear *)device block:(dispatch_block_t)block;
+
+- (AccelerometerStreamingCounters)countersForDevice:(MBLMetaWear *)device;
+// Samples waiting in the ring of a device.
+- (NSUInteger)pendingSamplesForDevice:(MBLMetaWear *)device;
+
+@property (nonatomic, readonly) NSArray *devices;
+@property (nonatomic, readonly) NSUInteger ringCapacity;
+@property (nonatomic) AccelerometerBackpressure backpressure;
+// Samples per consumer call, at most kAccelerometerStreamingBatch.
+@property (nonatomic) NSUInteger blockSize;
+// How long samples collect in the ring before a drain, bounds both latency and consumer calls.
+@property (nonatomic) NSTimeInterval drainInterval;
+
+@end
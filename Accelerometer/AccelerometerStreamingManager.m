@@ -0,0 +1,285 @@
+/**
+ * AccelerometerStreamingManager.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "AccelerometerStreamingManager.h"
+#import "AccelerometerSampleRing.h"
+#import "AccelerometerSaturate.h"
+#import <sched.h>
+
+@interface AccelerometerStreamingDevice : NSObject
+@property (nonatomic, strong) MBLMetaWear *device;
+@property (nonatomic, copy) AccelerometerStreamingConsumer consumer;
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic) AccelerometerBackpressure backpressure;
+@property (nonatomic) NSUInteger blockSize;
+@property (nonatomic) NSTimeInterval drainInterval;
+@end
+
+@implementation AccelerometerStreamingDevice
+{
+    @public
+    AccelerometerSampleRing *ring;
+    AccelerometerStreamingCounters counters;
+    // Set by the producer when it schedules a drain, cleared by the drain before it starts reading.
+    int drainPending;
+    // Producer only until finish, the newest sample that did not fit under AccelerometerBackpressureCoalesce.
+    AccelerometerRingSample held;
+    BOOL holding;
+    // Set on removal. Callbacks already queued may still arrive, and are ignored from then on.
+    int stopped;
+    // Raised by the producer around a push, finish waits for it to drop so no sample lands after the final drain.
+    int pushing;
+    // Drain queue only, YES once the final drain ran and the consumer must not be called again.
+    BOOL finished;
+}
+
+- (id)initWithDevice:(MBLMetaWear *)device capacity:(NSUInteger)capacity consumer:(AccelerometerStreamingConsumer)consumer
+{
+    self = [super init];
+    if (self != nil) {
+        ring = AccelerometerSampleRingCreate(capacity);
+        if (!ring) {
+            return nil;
+        }
+        _device = device;
+        _consumer = consumer;
+        NSString *label = [NSString stringWithFormat:@"com.mbientlab.accelerometer.stream.%@", device.identifier.UUIDString];
+        _queue = dispatch_queue_create(label.UTF8String, DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_queue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    AccelerometerSampleRingDestroy(ring);
+}
+
+- (void)push:(MBLAccelerometerData *)data
+{
+    // Either finish sees pushing raised and waits, or this sees stopped and leaves the ring alone.
+    __atomic_store_n(&pushing, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&stopped, __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(&pushing, 0, __ATOMIC_RELEASE);
+        return;
+    }
+    AccelerometerRingSample sample = { data.timestamp.timeIntervalSince1970, SaturateInt16(data.x), SaturateInt16(data.y), SaturateInt16(data.z), 0 };
+    __atomic_fetch_add(&counters.received, 1, __ATOMIC_RELAXED);
+    
+    switch (self.backpressure) {
+        case AccelerometerBackpressureDropNewest:
+            AccelerometerSampleRingPush(ring, &sample);
+            break;
+        case AccelerometerBackpressureDropOldest:
+            AccelerometerSampleRingPushOverwrite(ring, &sample);
+            break;
+        case AccelerometerBackpressureCoalesce: {
+            // Only the producer adds samples, so room seen here cannot disappear before the push.
+            BOOL room = AccelerometerSampleRingCount(ring) <= ring->mask;
+            if (holding && room) {
+                AccelerometerSampleRingPush(ring, &held);
+                holding = NO;
+                room = AccelerometerSampleRingCount(ring) <= ring->mask;
+            }
+            if (room) {
+                AccelerometerSampleRingPush(ring, &sample);
+            } else {
+                if (holding) {
+                    __atomic_fetch_add(&counters.coalesced, 1, __ATOMIC_RELAXED);
+                }
+                held = sample;
+                holding = YES;
+            }
+            break;
+        }
+    }
+    __atomic_store_n(&pushing, 0, __ATOMIC_RELEASE);
+    [self scheduleDrain];
+}
+
+- (void)scheduleDrain
+{
+    if (!__atomic_exchange_n(&drainPending, 1, __ATOMIC_ACQ_REL)) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.drainInterval * NSEC_PER_SEC)), self.queue, ^{
+            [self drain];
+        });
+    }
+}
+
+- (void)finish
+{
+    __atomic_store_n(&stopped, 1, __ATOMIC_SEQ_CST);
+    // A push that got past the check is a few instructions from done, let it land before the final drain.
+    while (__atomic_load_n(&pushing, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+    dispatch_sync(self.queue, ^{
+        [self drain];
+        // The producer is gone, so the held sample is this drain's to deliver.
+        if (holding) {
+            AccelerometerSampleRingPush(ring, &held);
+            holding = NO;
+            [self drain];
+        }
+        finished = YES;
+    });
+}
+
+- (void)drain
+{
+    if (finished) {
+        return;
+    }
+    // Cleared first, so a sample pushed while draining schedules another pass rather than waiting.
+    __atomic_store_n(&drainPending, 0, __ATOMIC_RELEASE);
+    int16_t x[kAccelerometerStreamingBatch], y[kAccelerometerStreamingBatch], z[kAccelerometerStreamingBatch];
+    double timestamps[kAccelerometerStreamingBatch];
+    size_t count;
+    while ((count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, self.blockSize))) {
+        if (self.consumer) {
+            self.consumer(self.device, x, y, z, timestamps, count);
+        }
+        __atomic_fetch_add(&counters.delivered, count, __ATOMIC_RELAXED);
+    }
+}
+
+- (AccelerometerStreamingCounters)counters
+{
+    AccelerometerStreamingCounters copy;
+    copy.received = __atomic_load_n(&counters.received, __ATOMIC_RELAXED);
+    copy.delivered = __atomic_load_n(&counters.delivered, __ATOMIC_RELAXED);
+    copy.coalesced = __atomic_load_n(&counters.coalesced, __ATOMIC_RELAXED);
+    copy.dropped = AccelerometerSampleRingDropped(ring);
+    return copy;
+}
+
+@end
+
+@implementation AccelerometerStreamingManager
+{
+    NSMutableDictionary *streams;
+}
+
+- (id)init
+{
+    return [self initWithRingCapacity:kAccelerometerStreamingRingCapacity];
+}
+
+- (id)initWithRingCapacity:(NSUInteger)capacity
+{
+    self = [super init];
+    if (self != nil) {
+        _ringCapacity = capacity;
+        _blockSize = kAccelerometerStreamingDefaultBlockSize;
+        _drainInterval = kAccelerometerStreamingDefaultInterval;
+        streams = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void)setBlockSize:(NSUInteger)blockSize
+{
+    _blockSize = MAX(1, MIN(blockSize, kAccelerometerStreamingBatch));
+}
+
+- (NSArray *)devices
+{
+    return [[streams allValues] valueForKey:@"device"];
+}
+
+- (void)addDevice:(MBLMetaWear *)device consumer:(AccelerometerStreamingConsumer)consumer
+{
+    [self removeDevice:device];
+    AccelerometerStreamingDevice *stream = [[AccelerometerStreamingDevice alloc] initWithDevice:device capacity:self.ringCapacity consumer:consumer];
+    if (!stream) {
+        NSLog(@"Unable to allocate a sample ring for %@", device.identifier.UUIDString);
+        return;
+    }
+    stream.backpressure = self.backpressure;
+    stream.blockSize = self.blockSize;
+    stream.drainInterval = self.drainInterval;
+    streams[device.identifier] = stream;
+    // The handler is the ring's only producer, it keeps stream alive for as long as notifications run.
+    [device.accelerometer.dataReadyEvent startNotificationsWithHandler:^(MBLAccelerometerData *acceleration, NSError *error) {
+        if (acceleration) {
+            [stream push:acceleration];
+        }
+    }];
+}
+
+- (void)removeDevice:(MBLMetaWear *)device
+{
+    AccelerometerStreamingDevice *stream = streams[device.identifier];
+    if (!stream) {
+        return;
+    }
+    [device.accelerometer.dataReadyEvent stopNotifications];
+    [streams removeObjectForKey:device.identifier];
+    // Whatever is left goes through the consumer before this returns.
+    [stream finish];
+}
+
+- (void)removeAllDevices
+{
+    for (MBLMetaWear *device in self.devices) {
+        [self removeDevice:device];
+    }
+}
+
+- (void)performOnDrainQueueOfDevice:(MBLMetaWear *)device block:(dispatch_block_t)block
+{
+    AccelerometerStreamingDevice *stream = streams[device.identifier];
+    if (stream) {
+        dispatch_sync(stream.queue, block);
+    } else {
+        block();
+    }
+}
+
+- (AccelerometerStreamingCounters)countersForDevice:(MBLMetaWear *)device
+{
+    AccelerometerStreamingDevice *stream = streams[device.identifier];
+    AccelerometerStreamingCounters counters;
+    memset(&counters, 0, sizeof(counters));
+    return stream ? [stream counters] : counters;
+}
+
+- (NSUInteger)pendingSamplesForDevice:(MBLMetaWear *)device
+{
+    AccelerometerStreamingDevice *stream = streams[device.identifier];
+    return stream ? AccelerometerSampleRingCount(stream->ring) : 0;
+}
+
+@end
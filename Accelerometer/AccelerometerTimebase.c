@@ -0,0 +1,122 @@
+/**
+ * AccelerometerTimebase.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "AccelerometerTimebase.h"
+#include <math.h>
+#include <string.h>
+
+const AccelerometerTimebase AccelerometerTimebaseIdentity = { 0.0, 1.0 };
+
+int AccelerometerTimebaseFit(const uint64_t *ticks, const double *times, size_t count, AccelerometerTimebase *timebase)
+{
+	if(count < 2)
+		return 0;
+	
+	// Centre both axes on the first pair so the sums stay small enough for double precision.
+	double t0 = ticks[0] / kAccelerometerTimebaseTicksPerSecond;
+	double h0 = times[0];
+	double sumT = 0.0, sumH = 0.0;
+	for(size_t i = 0; i < count; i++)
+	{
+		sumT += ticks[i] / kAccelerometerTimebaseTicksPerSecond - t0;
+		sumH += times[i] - h0;
+	}
+	double meanT = sumT / count;
+	double meanH = sumH / count;
+	
+	double covariance = 0.0, variance = 0.0;
+	for(size_t i = 0; i < count; i++)
+	{
+		double dt = ticks[i] / kAccelerometerTimebaseTicksPerSecond - t0 - meanT;
+		double dh = times[i] - h0 - meanH;
+		covariance += dt * dh;
+		variance += dt * dt;
+	}
+	if(variance <= 0.0)
+		return 0;
+	
+	double rate = covariance / variance;
+	if(fabs(rate - 1.0) > kAccelerometerTimebaseMaxSkew)
+		return 0;
+	
+	timebase->rate = rate;
+	timebase->offset = h0 + meanH - rate * (t0 + meanT);
+	return 1;
+}
+
+double AccelerometerTimebaseSeconds(AccelerometerTimebase timebase, uint64_t tick)
+{
+	return timebase.offset + timebase.rate * (tick / kAccelerometerTimebaseTicksPerSecond);
+}
+
+void AccelerometerTimebaseEstimatorReset(AccelerometerTimebaseEstimator *estimator)
+{
+	memset(estimator, 0, sizeof(*estimator));
+}
+
+void AccelerometerTimebaseEstimatorAdd(AccelerometerTimebaseEstimator *estimator, double t, double h)
+{
+	if(estimator->count == 0.0)
+	{
+		estimator->originT = t;
+		estimator->originH = h;
+	}
+	t -= estimator->originT;
+	h -= estimator->originH;
+	
+	estimator->count += 1.0;
+	double dt = t - estimator->meanT;
+	estimator->meanT += dt / estimator->count;
+	estimator->meanH += (h - estimator->meanH) / estimator->count;
+	estimator->varianceT += dt * (t - estimator->meanT);
+	estimator->covariance += dt * (h - estimator->meanH);
+}
+
+int AccelerometerTimebaseEstimatorGet(const AccelerometerTimebaseEstimator *estimator, AccelerometerTimebase *timebase)
+{
+	if(estimator->count == 0.0)
+		return 0;
+	
+	double rate = 1.0;
+	if(estimator->varianceT > 0.0)
+	{
+		double fitted = estimator->covariance / estimator->varianceT;
+		if(fabs(fitted - 1.0) <= kAccelerometerTimebaseMaxSkew)
+			rate = fitted;
+	}
+	timebase->rate = rate;
+	timebase->offset = estimator->originH + estimator->meanH - rate * (estimator->originT + estimator->meanT);
+	return 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * AccelerometerTimebase.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Linear mapping between sample ticks and phone time.
+ 
+ Samples carry a 64-bit tick of microseconds since the session epoch and nothing else, wall clock
+ time is only worked out when it is needed. When the ticks come from the MetaWear clock they slowly
+ drift against the nominal sample rate. Reference pairs, the tick of a sample and the time the board
+ sampled it, fit that drift by least squares once the recording is done. The log pipeline fits a
+ whole downloaded log in one pass and resamples it through the fit rather than per sample.
+ */
+
+#ifndef AccelerometerTimebase_h
+#define AccelerometerTimebase_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kAccelerometerTimebaseTicksPerSecond	1000000.0
+// Fits claiming the clocks disagree by more than this fraction are rejected as bad references.
+#define kAccelerometerTimebaseMaxSkew			0.01
+
+// Phone time in seconds since the epoch of a tick is offset + rate * tick / kAccelerometerTimebaseTicksPerSecond.
+typedef struct {
+	double offset;
+	double rate;
+} AccelerometerTimebase;
+
+extern const AccelerometerTimebase AccelerometerTimebaseIdentity;
+
+/*
+ Least squares fit of the phone times against the ticks of count reference pairs. Times are seconds
+ relative to the session epoch. Returns 0 and leaves timebase untouched when there are fewer than two
+ distinct ticks or the fitted rate is off by more than kAccelerometerTimebaseMaxSkew.
+ */
+int AccelerometerTimebaseFit(const uint64_t *ticks, const double *times, size_t count, AccelerometerTimebase *timebase);
+
+double AccelerometerTimebaseSeconds(AccelerometerTimebase timebase, uint64_t tick);
+
+/*
+ Online counterpart of AccelerometerTimebaseFit. Pairs are added one at a time in O(1) with Welford
+ style running means and co-moments, both axes taken relative to the first pair for precision, and
+ the current fit can be read at any point. Times are seconds on both axes here.
+ */
+typedef struct {
+	double count;
+	double originT, originH;
+	double meanT, meanH;
+	double varianceT, covariance;
+} AccelerometerTimebaseEstimator;
+
+void AccelerometerTimebaseEstimatorReset(AccelerometerTimebaseEstimator *estimator);
+void AccelerometerTimebaseEstimatorAdd(AccelerometerTimebaseEstimator *estimator, double t, double h);
+/*
+ Returns 0 only before the first pair. Unlike AccelerometerTimebaseFit it does not reject: with a
+ single distinct t, or a fitted rate off by more than kAccelerometerTimebaseMaxSkew, timebase gets
+ rate 1 and the offset that puts the mean of the pairs on it, and 1 is returned. The resampler
+ relies on that to place outputs before the fit has settled and when a log cannot be fitted.
+ */
+int AccelerometerTimebaseEstimatorGet(const AccelerometerTimebaseEstimator *estimator, AccelerometerTimebase *timebase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,12 +34,20 @@
  */
 
 #import "AppDelegate.h"
+#import <MetaWear/MetaWear.h>
 
 @implementation AppDelegate
 
 - (BOOL)application:(UIApplication *)application didFinishLaunchingWithOptions:(NSDictionary *)launchOptions
 {
     // Override point for customization after application launch.
+    
+    // Keep MetaWear callbacks off the main queue, handlers hop back to it for UI work. The queue is
+    // serial so each sensor event still has a single producer.
+    NSOperationQueue *callbackQueue = [[NSOperationQueue alloc] init];
+    callbackQueue.name = @"com.mbientlab.metawear.callbacks";
+    callbackQueue.maxConcurrentOperationCount = 1;
+    [[MBLMetaWearManager sharedManager] setCallbackQueue:callbackQueue];
 
     return YES;
 }
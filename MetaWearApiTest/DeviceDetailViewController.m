@@ -36,6 +36,20 @@
 #import "DeviceDetailViewController.h"
 #import "MBProgressHUD.h"
 #import "APLGraphView.h"
+#import "AccelerometerSampleStore.h"
+#import "AccelerometerCSVExporter.h"
+#import "AccelerometerSessionFile.h"
+#import "AccelerometerDecimator.h"
+#import "AccelerometerLODPyramid.h"
+#import "APLHistoryGraphView.h"
+#import "AccelerometerLogPipeline.h"
+#import "AccelerometerLogJournal.h"
+#import "AccelerometerStreamingManager.h"
+
+// Rates of the MBLAccelerometerSampleFrequency values, indexed like the sampleFrequency control.
+static const double kSampleFrequencyHz[] = { 800.0, 400.0, 200.0, 100.0, 50.0, 12.5, 6.25, 1.56 };
+// Time covered by one pixel column of the graph, 1 sample per pixel at 100Hz.
+static const NSTimeInterval kGraphColumnDuration = 0.01;
 
 @interface DeviceDetailViewController () <MFMailComposeViewControllerDelegate>
 @property (weak, nonatomic) IBOutlet UIScrollView *scrollView;
@@ -89,7 +103,15 @@
 @property (weak, nonatomic) IBOutlet UILabel *firmwareUpdateLabel;
 
 @property (strong, nonatomic) UIView *grayScreen;
-@property (strong, nonatomic) NSArray *accelerometerDataArray;
+@property (strong, nonatomic) AccelerometerSampleStore *accelerometerSamples;
+// Session file of accelerometerSamples when it was already written in the background.
+@property (strong, nonatomic) NSData *accelerometerSession;
+// Shown over the live graph once a log has been downloaded.
+@property (weak, nonatomic) APLHistoryGraphView *historyGraph;
+// Journal of everything downloaded from the accelerometer log of this device.
+@property (strong, nonatomic) AccelerometerLogJournal *accelerometerLogJournal;
+// Moves streamed samples off the callback queue onto a worker.
+@property (strong, nonatomic) AccelerometerStreamingManager *streamingManager;
 @property (nonatomic) BOOL accelerometerRunning;
 @property (nonatomic) BOOL switchRunning;
 @end
@@ -153,28 +175,32 @@
     if (on) {
         hud.labelText = @"Connecting...";
         [self.device connectWithHandler:^(NSError *error) {
-            [self setConnected:(error == nil)];
-            hud.mode = MBProgressHUDModeText;
-            if (error) {
-                hud.labelText = error.localizedDescription;
-                [hud hide:YES afterDelay:2];
-            } else {
-                hud.labelText = @"Connected!";
-                [hud hide:YES afterDelay:0.5];
-            }
+            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                [self setConnected:(error == nil)];
+                hud.mode = MBProgressHUDModeText;
+                if (error) {
+                    hud.labelText = error.localizedDescription;
+                    [hud hide:YES afterDelay:2];
+                } else {
+                    hud.labelText = @"Connected!";
+                    [hud hide:YES afterDelay:0.5];
+                }
+            }];
         }];
     } else {
         hud.labelText = @"Disconnecting...";
         [self.device disconnectWithHandler:^(NSError *error) {
-            [self setConnected:NO];
-            hud.mode = MBProgressHUDModeText;
-            if (error) {
-                hud.labelText = error.localizedDescription;
-                [hud hide:YES afterDelay:2];
-            } else {
-                hud.labelText = @"Disconnected!";
-                [hud hide:YES afterDelay:0.5];
-            }
+            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                [self setConnected:NO];
+                hud.mode = MBProgressHUDModeText;
+                if (error) {
+                    hud.labelText = error.localizedDescription;
+                    [hud hide:YES afterDelay:2];
+                } else {
+                    hud.labelText = @"Disconnected!";
+                    [hud hide:YES afterDelay:0.5];
+                }
+            }];
         }];
     }
 }
@@ -187,8 +213,10 @@
 - (IBAction)readTempraturePressed:(id)sender
 {
     [self.device.temperature readTemperatureWithHandler:^(NSDecimalNumber *temp, NSError *error) {
-        NSString *suffix = self.device.temperature.units == MBLTemperatureUnitCelsius ? @"°C" : @"°F";
-        self.tempratureLabel.text = [[temp stringValue] stringByAppendingString:suffix];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            NSString *suffix = self.device.temperature.units == MBLTemperatureUnitCelsius ? @"°C" : @"°F";
+            self.tempratureLabel.text = [[temp stringValue] stringByAppendingString:suffix];
+        }];
     }];
 }
 
@@ -227,7 +255,9 @@
 - (IBAction)readSwitchPressed:(id)sender
 {
     [self.device.mechanicalSwitch readSwitchStateWithHandler:^(BOOL isPressed, NSError *error) {
-        self.mechanicalSwitchLabel.text = isPressed ? @"Down" : @"Up";
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.mechanicalSwitchLabel.text = isPressed ? @"Down" : @"Up";
+        }];
     }];
 }
 
@@ -235,7 +265,9 @@
 {
     self.switchRunning = YES;
     [self.device.mechanicalSwitch.switchUpdateEvent startNotificationsWithHandler:^(MBLNumericData *isPressed, NSError *error) {
-        self.mechanicalSwitchLabel.text = isPressed.value.boolValue ? @"Down" : @"Up";
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.mechanicalSwitchLabel.text = isPressed.value.boolValue ? @"Down" : @"Up";
+        }];
     }];
 }
 
@@ -248,14 +280,18 @@
 - (IBAction)readBatteryPressed:(id)sender
 {
     [self.device readBatteryLifeWithHandler:^(NSNumber *number, NSError *error) {
-        self.batteryLevelLabel.text = [number stringValue];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.batteryLevelLabel.text = [number stringValue];
+        }];
     }];
 }
 
 - (IBAction)readRSSIPressed:(id)sender
 {
     [self.device readRSSIWithHandler:^(NSNumber *number, NSError *error) {
-        self.rssiLevelLabel.text = [number stringValue];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.rssiLevelLabel.text = [number stringValue];
+        }];
     }];
 }
 
@@ -277,7 +313,9 @@
 - (IBAction)checkForFirmwareUpdatesPressed:(id)sender
 {
     [self.device checkForFirmwareUpdateWithHandler:^(BOOL isTrue, NSError *error) {
-        self.firmwareUpdateLabel.text = isTrue ? @"Avaliable!" : @"Up To Date";
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.firmwareUpdateLabel.text = isTrue ? @"Avaliable!" : @"Up To Date";
+        }];
     }];
 }
 
@@ -289,27 +327,31 @@
     hud.labelText = @"Updating...";
     
     [self.device updateFirmwareWithHandler:^(NSError *error) {
-        hud.mode = MBProgressHUDModeText;
-        if (error) {
-            NSLog(@"Firmware update error: %@", error.localizedDescription);
-            [[[UIAlertView alloc] initWithTitle:@"Update Error"
-                                        message:[@"Please re-connect and try again, if you can't connect, try MetaBoot Mode to recover.\nError: " stringByAppendingString:error.localizedDescription]
-                                       delegate:nil
-                              cancelButtonTitle:@"Okay"
-                              otherButtonTitles:nil] show];
-            [hud hide:YES];
-        } else {
-            hud.labelText = @"Success!";
-            [hud hide:YES afterDelay:2.0];
-        }
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            hud.mode = MBProgressHUDModeText;
+            if (error) {
+                NSLog(@"Firmware update error: %@", error.localizedDescription);
+                [[[UIAlertView alloc] initWithTitle:@"Update Error"
+                                            message:[@"Please re-connect and try again, if you can't connect, try MetaBoot Mode to recover.\nError: " stringByAppendingString:error.localizedDescription]
+                                           delegate:nil
+                                  cancelButtonTitle:@"Okay"
+                                  otherButtonTitles:nil] show];
+                [hud hide:YES];
+            } else {
+                hud.labelText = @"Success!";
+                [hud hide:YES afterDelay:2.0];
+            }
+        }];
     } progressHandler:^(float number, NSError *error) {
-        if (number != hud.progress) {
-            hud.progress = number;
-            if (number == 1.0) {
-                hud.mode = MBProgressHUDModeIndeterminate;
-                hud.labelText = @"Resetting...";
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            if (number != hud.progress) {
+                hud.progress = number;
+                if (number == 1.0) {
+                    hud.mode = MBProgressHUDModeIndeterminate;
+                    hud.labelText = @"Resetting...";
+                }
             }
-        }
+        }];
     }];
 }
 
@@ -360,7 +402,9 @@
     MBLGPIOPin *pin = self.device.gpio.pins[self.gpioPinSelector.selectedSegmentIndex];
     // TODO: Update once firmware 1.0.0 has been released
     [pin readDigitalValueWithHandler:^(BOOL isTrue, NSError *error) {
-        self.gpioPinDigitalValue.text = isTrue ? @"1" : @"0";
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.gpioPinDigitalValue.text = isTrue ? @"1" : @"0";
+        }];
     }];
 }
 - (IBAction)readAnalogPressed:(id)sender
@@ -368,7 +412,9 @@
     MBLGPIOPin *pin = self.device.gpio.pins[self.gpioPinSelector.selectedSegmentIndex];
     // TODO: Update once firmware 1.0.0 has been released
     [pin readAnalogValueUsingMode:MBLAnalogReadModeFixed handler:^(NSDecimalNumber *number, NSError *error) {
-        self.gpioPinAnalogValue.text = [NSString stringWithFormat:@"%.3fV", number.doubleValue];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.gpioPinAnalogValue.text = [NSString stringWithFormat:@"%.3fV", number.doubleValue];
+        }];
     }];
 }
 
@@ -395,9 +441,36 @@
     self.device.accelerometer.tapType = (int)self.tapDetectionType.selectedSegmentIndex;
 }
 
+- (AccelerometerDecimator *)makeGraphDecimator
+{
+    AccelerometerDecimator *decimator = [[AccelerometerDecimator alloc] initWithSampleRate:kSampleFrequencyHz[self.sampleFrequency.selectedSegmentIndex]
+                                                                            columnDuration:kGraphColumnDuration];
+    APLGraphView *graph = self.accelerometerGraph;
+    // Columns complete on the streaming worker and go straight into the pending ring of the graph, which
+    // draws whatever arrived once per frame on its own display link.
+    decimator.handler = ^(AccelerometerEnvelope envelope) {
+        [graph addMinX:envelope.min[0] maxX:envelope.max[0] minY:envelope.min[1] maxY:envelope.max[1] minZ:envelope.min[2] maxZ:envelope.max[2]];
+    };
+    return decimator;
+}
+
+- (void)showHistoryGraphWithPyramid:(AccelerometerLODPyramid *)pyramid
+{
+    APLHistoryGraphView *history = self.historyGraph;
+    if (!history) {
+        history = [[APLHistoryGraphView alloc] initWithFrame:self.accelerometerGraph.frame];
+        history.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleHeight;
+        [self.accelerometerGraph.superview insertSubview:history aboveSubview:self.accelerometerGraph];
+        self.historyGraph = history;
+    }
+    history.fullScale = self.accelerometerGraph.fullScale;
+    history.pyramid = pyramid;
+}
+
 - (IBAction)startAccelerationPressed:(id)sender
 {
     [self updateAccelerometerSettings];
+    [self.historyGraph removeFromSuperview];
     
     [self.startAccelerometer setEnabled:NO];
     [self.stopAccelerometer setEnabled:YES];
@@ -405,19 +478,41 @@
     [self.stopLog setEnabled:NO];
     self.accelerometerRunning = YES;
     // These variables are used for data recording
-    NSMutableArray *array = [[NSMutableArray alloc] initWithCapacity:1000];
-    self.accelerometerDataArray = array;
+    AccelerometerSampleStore *samples = [[AccelerometerSampleStore alloc] init];
+    self.accelerometerSamples = samples;
+    self.accelerometerSession = nil;
+    AccelerometerDecimator *decimator = [self makeGraphDecimator];
     
-    [self.device.accelerometer.dataReadyEvent startNotificationsWithHandler:^(MBLAccelerometerData *acceleration, NSError *error) {
-        [self.accelerometerGraph addX:(float)acceleration.x / 1000.0 y:(float)acceleration.y / 1000.0 z:(float)acceleration.z / 1000.0];
-        // Add data to data array for saving
-        [array addObject:acceleration];
+    if (!self.streamingManager) {
+        self.streamingManager = [[AccelerometerStreamingManager alloc] init];
+    }
+    // A single stream keeps the timestamps of the store, AccelerometerStreamMerger is for several devices at once.
+    // Runs on the drain queue of the device, the only place samples and decimator are touched until streaming stops.
+    [self.streamingManager addDevice:self.device consumer:^(MBLMetaWear *device, const int16_t *x, const int16_t *y, const int16_t *z, const double *timestamps, NSUInteger count) {
+        if (!samples.hasEpoch) {
+            samples.epoch = timestamps[0];
+        }
+        uint64_t ticks[kAccelerometerStreamingBatch];
+        float gx[kAccelerometerStreamingBatch], gy[kAccelerometerStreamingBatch], gz[kAccelerometerStreamingBatch];
+        for (NSUInteger i = 0; i < count; i++) {
+            NSTimeInterval offset = timestamps[i] - samples.epoch;
+            ticks[i] = offset > 0.0 ? llround(offset * kAccelerometerSampleStoreTicksPerSecond) : 0;
+            gx[i] = x[i] / 1000.0f;
+            gy[i] = y[i] / 1000.0f;
+            gz[i] = z[i] / 1000.0f;
+        }
+        // Add data to the sample store for saving
+        if (![samples appendSamplesX:x y:y z:z ticks:ticks count:count]) {
+            NSLog(@"Out of memory, samples of %@ dropped", device.identifier.UUIDString);
+        }
+        [decimator addSamplesX:gx y:gy z:gz count:count];
     }];
 }
 
 - (IBAction)stopAccelerationPressed:(id)sender
 {
-    [self.device.accelerometer.dataReadyEvent stopNotifications];
+    // Returns once the samples still in the ring are in the store.
+    [self.streamingManager removeDevice:self.device];
     self.accelerometerRunning = NO;
 
     [self.startAccelerometer setEnabled:YES];
@@ -428,6 +523,7 @@
 - (IBAction)startAccelerometerLog:(id)sender
 {
     [self updateAccelerometerSettings];
+    [self.historyGraph removeFromSuperview];
     
     [self.startLog setEnabled:NO];
     [self.stopLog setEnabled:YES];
@@ -443,14 +539,42 @@
     hud.mode = MBProgressHUDModeDeterminateHorizontalBar;
     hud.labelText = @"Downloading...";
     
-    [self.device.accelerometer.dataReadyEvent downloadLogAndStopLogging:YES handler:^(NSArray *array, NSError *error) {
-        [hud hide:YES];
-        if (!error) {
-            self.accelerometerDataArray = array;
-            for (MBLAccelerometerData *acceleration in array) {
-                [self.accelerometerGraph addX:(float)acceleration.x / 1000.0 y:(float)acceleration.y / 1000.0 z:(float)acceleration.z / 1000.0];
-            }
+    AccelerometerLogPipeline *pipeline = [[AccelerometerLogPipeline alloc] initWithSettings:[self sessionSettings]];
+    // Statistics are taken over the signal with the top half of the band removed.
+    double rate = kSampleFrequencyHz[self.sampleFrequency.selectedSegmentIndex];
+    pipeline.filter = [[BiquadFilter alloc] initWithSampleRate:rate cutoffFrequency:rate / 4.0 order:4 response:AccelerometerBiquadLowpass];
+    pipeline.resampleRate = rate;
+    NSURL *support = [[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask] lastObject];
+    NSString *file = [NSString stringWithFormat:@"%@.mwas", self.device.identifier.UUIDString];
+    pipeline.sessionURL = [[support URLByAppendingPathComponent:@"AccelerometerSessions" isDirectory:YES] URLByAppendingPathComponent:file];
+    
+    if (!self.accelerometerLogJournal) {
+        self.accelerometerLogJournal = [[AccelerometerLogJournal alloc] initWithDevice:self.device event:self.device.accelerometer.dataReadyEvent name:@"dataReady"];
+    }
+    // Entries left over from an earlier download are filtered out, array only holds this recording.
+    [self.accelerometerLogJournal downloadAndStopLogging:YES handler:^(NSArray *array, NSError *error) {
+        if (error) {
+            [hud hide:YES];
+            return;
         }
+        hud.mode = MBProgressHUDModeIndeterminate;
+        hud.labelText = @"Processing...";
+        [pipeline processEntries:array handler:^(AccelerometerLogSummary summary, AccelerometerSampleStore *store, AccelerometerLODPyramid *pyramid, NSData *session) {
+            if (!store) {
+                hud.mode = MBProgressHUDModeText;
+                hud.labelText = @"Not enough memory for the log";
+                [hud hide:YES afterDelay:2.0];
+                return;
+            }
+            self.accelerometerSamples = store;
+            self.accelerometerSession = session;
+            [self showHistoryGraphWithPyramid:pyramid];
+            
+            hud.mode = MBProgressHUDModeText;
+            hud.labelText = [NSString stringWithFormat:@"%lu samples, %.1f s", (unsigned long)summary.count, summary.duration];
+            hud.detailsLabelText = [NSString stringWithFormat:@"RMS %.0f, %.0f, %.0f mG", summary.rms[0], summary.rms[1], summary.rms[2]];
+            [hud hide:YES afterDelay:2.0];
+        }];
     } progressHandler:^(float number, NSError *error) {
         hud.progress = number;
     }];
@@ -462,20 +586,51 @@
 
 - (IBAction)sendDataPressed:(id)sender
 {
-    NSMutableData *accelerometerData = [NSMutableData data];
-    for (MBLAccelerometerData *dataElement in self.accelerometerDataArray) {
-        @autoreleasepool {
-            [accelerometerData appendData:[[NSString stringWithFormat:@"%f,%d,%d,%d\n",
-                                            dataElement.timestamp.timeIntervalSince1970,
-                                            dataElement.x,
-                                            dataElement.y,
-                                            dataElement.z] dataUsingEncoding:NSUTF8StringEncoding]];
+    // The store is filled on the streaming worker while recording, send a copy taken between two of its
+    // batches and leave the recording running.
+    AccelerometerSampleStore *samples = self.accelerometerSamples;
+    __block AccelerometerSampleStore *snapshot = samples;
+    if (self.accelerometerRunning) {
+        [self.streamingManager performOnDrainQueueOfDevice:self.device block:^{
+            snapshot = [samples copy];
+        }];
+        if (!snapshot) {
+            [[[UIAlertView alloc] initWithTitle:@"Mail Error" message:@"Not enough memory to copy the recording" delegate:nil cancelButtonTitle:@"Okay" otherButtonTitles:nil] show];
+            return;
         }
     }
-    [self sendMail:accelerometerData];
+    // The CSV stays the primary attachment for existing readers, the binary session rides along.
+    NSData *csv = [AccelerometerCSVExporter CSVDataWithSampleStore:snapshot];
+    if (!csv) {
+        [[[UIAlertView alloc] initWithTitle:@"Mail Error" message:@"Not enough memory to export the recording" delegate:nil cancelButtonTitle:@"Okay" otherButtonTitles:nil] show];
+        return;
+    }
+    NSData *session = self.accelerometerSession;
+    if (!session) {
+        session = [AccelerometerSessionWriter dataWithSampleStore:snapshot settings:[self sessionSettings]];
+    }
+    [self sendMail:csv session:session];
+}
+
+- (AccelerometerSessionSettings)sessionSettings
+{
+    AccelerometerSessionSettings settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.fullScaleRange = self.accelerometerScale.selectedSegmentIndex;
+    settings.sampleFrequency = self.sampleFrequency.selectedSegmentIndex;
+    settings.highPassFilter = self.highPassFilterSwitch.on;
+    settings.filterCutoffFreq = self.hpfCutoffFreq.selectedSegmentIndex;
+    settings.lowNoise = self.lowNoiseSwitch.on;
+    settings.activePowerScheme = self.activePowerScheme.selectedSegmentIndex;
+    settings.autoSleep = self.autoSleepSwitch.on;
+    settings.sleepSampleFrequency = self.sleepSampleFrequency.selectedSegmentIndex;
+    settings.sleepPowerScheme = self.sleepPowerScheme.selectedSegmentIndex;
+    settings.tapDetectionAxis = self.tapDetectionAxis.selectedSegmentIndex;
+    settings.tapType = self.tapDetectionType.selectedSegmentIndex;
+    return settings;
 }
 
-- (void)sendMail:(NSData *)attachment
+- (void)sendMail:(NSData *)attachment session:(NSData *)session
 {
     if (![MFMailComposeViewController canSendMail]) {
         [[[UIAlertView alloc] initWithTitle:@"Mail Error" message:@"This device does not have an email account setup" delegate:nil cancelButtonTitle:@"Okay" otherButtonTitles:nil] show];
@@ -500,6 +655,10 @@
     // attachment
     NSString *name = [NSString stringWithFormat:@"AccData_%@.txt", dateString, nil];
     [emailController addAttachmentData:attachment mimeType:@"text/plain" fileName:name];
+    if (session) {
+        NSString *sessionName = [NSString stringWithFormat:@"AccData_%@.mwas", dateString, nil];
+        [emailController addAttachmentData:session mimeType:@"application/octet-stream" fileName:sessionName];
+    }
     
     // subject
     NSString *subject = [NSString stringWithFormat:@"Accelerometer Data %@.txt", dateString, nil];
@@ -532,7 +691,9 @@
     
     [self updateAccelerometerSettings];
     [self.device.accelerometer.tapEvent startNotificationsWithHandler:^(id obj, NSError *error) {
-        self.tapLabel.text = [NSString stringWithFormat:@"Tap Count: %d", ++self.tapCount];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.tapLabel.text = [NSString stringWithFormat:@"Tap Count: %d", ++self.tapCount];
+        }];
     }];
 }
 
@@ -553,7 +714,9 @@
     
     [self updateAccelerometerSettings];
     [self.device.accelerometer.shakeEvent startNotificationsWithHandler:^(id obj, NSError *error) {
-        self.shakeLabel.text = [NSString stringWithFormat:@"Shakes: %d", ++self.shakeCount];
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            self.shakeLabel.text = [NSString stringWithFormat:@"Shakes: %d", ++self.shakeCount];
+        }];
     }];
 }
 
@@ -574,21 +737,23 @@
     
     [self updateAccelerometerSettings];
     [self.device.accelerometer.orientationEvent startNotificationsWithHandler:^(id obj, NSError *error) {
-        MBLOrientationData *data = obj;
-        switch (data.orientation) {
-            case MBLAccelerometerOrientationPortrait:
-                self.orientationLabel.text = @"Portrait";
-                break;
-            case MBLAccelerometerOrientationPortraitUpsideDown:
-                self.orientationLabel.text = @"PortraitUpsideDown";
-                break;
-            case MBLAccelerometerOrientationLandscapeLeft:
-                self.orientationLabel.text = @"LandscapeLeft";
-                break;
-            case MBLAccelerometerOrientationLandscapeRight:
-                self.orientationLabel.text = @"LandscapeRight";
-                break;
-        }
+        [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+            MBLOrientationData *data = obj;
+            switch (data.orientation) {
+                case MBLAccelerometerOrientationPortrait:
+                    self.orientationLabel.text = @"Portrait";
+                    break;
+                case MBLAccelerometerOrientationPortraitUpsideDown:
+                    self.orientationLabel.text = @"PortraitUpsideDown";
+                    break;
+                case MBLAccelerometerOrientationLandscapeLeft:
+                    self.orientationLabel.text = @"LandscapeLeft";
+                    break;
+                case MBLAccelerometerOrientationLandscapeRight:
+                    self.orientationLabel.text = @"LandscapeRight";
+                    break;
+            }
+        }];
     }];
 }
 
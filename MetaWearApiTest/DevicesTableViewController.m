@@ -36,10 +36,12 @@
 #import "DevicesTableViewController.h"
 #import "DeviceDetailViewController.h"
 #import "MBProgressHUD.h"
+#import "ScanAggregator.h"
 #import <MetaWear/MetaWear.h>
 
 @interface DevicesTableViewController ()
 @property (nonatomic, strong) NSArray *devices;
+@property (nonatomic, strong) ScanAggregator *scanAggregator;
 @property (strong, nonatomic) UIActivityIndicatorView *activity;
 
 @property (weak, nonatomic) IBOutlet UISwitch *scanningSwitch;
@@ -55,6 +57,43 @@
     self.activity = [[UIActivityIndicatorView alloc] initWithActivityIndicatorStyle:UIActivityIndicatorViewStyleGray];
     self.activity.center = CGPointMake(95, 138);
     [self.tableView addSubview:self.activity];
+    
+    // Scan callbacks come in per advertisement, the table is only updated with what changed at a capped rate.
+    self.scanAggregator = [[ScanAggregator alloc] init];
+    self.scanAggregator.sortsByProximity = YES;
+    __weak DevicesTableViewController *weakSelf = self;
+    self.scanAggregator.handler = ^(NSArray *devices, ScanAggregatorChanges *changes) {
+        [weakSelf updateDevices:devices changes:changes];
+    };
+}
+
+- (void)updateDevices:(NSArray *)devices changes:(ScanAggregatorChanges *)changes
+{
+    self.devices = devices;
+    [self.tableView beginUpdates];
+    [self.tableView deleteRowsAtIndexPaths:[self indexPathsForRows:changes.removed] withRowAnimation:UITableViewRowAnimationAutomatic];
+    [self.tableView insertRowsAtIndexPaths:[self indexPathsForRows:changes.inserted] withRowAnimation:UITableViewRowAnimationAutomatic];
+    [changes enumerateMovesUsingBlock:^(NSUInteger from, NSUInteger to) {
+        [self.tableView moveRowAtIndexPath:[NSIndexPath indexPathForRow:from inSection:0] toIndexPath:[NSIndexPath indexPathForRow:to inSection:0]];
+    }];
+    [self.tableView endUpdates];
+    
+    // A row can't be moved and reloaded in one batch, so changed rows are refreshed in place afterwards.
+    [changes.updated enumerateIndexesUsingBlock:^(NSUInteger row, BOOL *stop) {
+        UITableViewCell *cell = [self.tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:row inSection:0]];
+        if (cell) {
+            [self configureCell:cell withDevice:devices[row]];
+        }
+    }];
+}
+
+- (NSArray *)indexPathsForRows:(NSIndexSet *)rows
+{
+    NSMutableArray *indexPaths = [NSMutableArray arrayWithCapacity:rows.count];
+    [rows enumerateIndexesUsingBlock:^(NSUInteger row, BOOL *stop) {
+        [indexPaths addObject:[NSIndexPath indexPathForRow:row inSection:0]];
+    }];
+    return indexPaths;
 }
 
 - (void)viewWillAppear:(BOOL)animated
@@ -77,13 +116,15 @@
         [self.activity startAnimating];
         if (self.metaBootSwitch.on) {
             [[MBLMetaWearManager sharedManager] startScanForMetaBootsAllowDuplicates:YES handler:^(NSArray *array) {
-                self.devices = array;
-                [self.tableView reloadData];
+                [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                    [self.scanAggregator updateWithDevices:array];
+                }];
             }];
         } else {
             [[MBLMetaWearManager sharedManager] startScanForMetaWearsAllowDuplicates:YES handler:^(NSArray *array) {
-                self.devices = array;
-                [self.tableView reloadData];
+                [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                    [self.scanAggregator updateWithDevices:array];
+                }];
             }];
         }
     } else {
@@ -110,6 +151,7 @@
     }
     // Wait a split second for any final callbacks to fire before starting up scanning again
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [self.scanAggregator reset];
         self.devices = nil;
         [self.tableView reloadData];
         [self setScanning:self.scanningSwitch.on];
@@ -127,13 +169,18 @@
 {
     NSString *identifier = self.metaBootSwitch.on ? @"MetaBootCell" : @"Cell";
     UITableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:identifier forIndexPath:indexPath];
-    MBLMetaWear *cur = self.devices[indexPath.row];
-    
+    [self configureCell:cell withDevice:self.devices[indexPath.row]];
+    return cell;
+}
+
+- (void)configureCell:(UITableViewCell *)cell withDevice:(MBLMetaWear *)cur
+{
     UILabel *uuid = (UILabel *)[cell viewWithTag:1];
     uuid.text = cur.identifier.UUIDString;
     
+    // Smoothed, the raw discovery RSSI jumps around from one advertisement to the next.
     UILabel *rssi = (UILabel *)[cell viewWithTag:2];
-    rssi.text = [cur.discoveryTimeRSSI stringValue];
+    rssi.text = [NSString stringWithFormat:@"%.0f", [self.scanAggregator smoothedRSSIForDevice:cur]];
     
     UILabel *connected = (UILabel *)[cell viewWithTag:3];
     if (cur.state == CBPeripheralStateConnected) {
@@ -141,8 +188,6 @@
     } else {
         [connected setHidden:YES];
     }
-    
-    return cell;
 }
 
 - (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath
@@ -159,27 +204,31 @@
         hud.mode = MBProgressHUDModeDeterminateHorizontalBar;
         hud.labelText = @"Updating...";
         [selected updateFirmwareWithHandler:^(NSError *error) {
-            hud.mode = MBProgressHUDModeText;
-            if (error) {
-                NSLog(@"Firmware update error: %@", error.localizedDescription);
-                [[[UIAlertView alloc] initWithTitle:@"Update Error"
-                                            message:[@"Please re-connect and try again, if you can't connect, try MetaBoot Mode to recover.\nError: " stringByAppendingString:error.localizedDescription]
-                                           delegate:nil
-                                  cancelButtonTitle:@"Okay"
-                                  otherButtonTitles:nil] show];
-                [hud hide:YES];
-            } else {
-                hud.labelText = @"Success!";
-                [hud hide:YES afterDelay:2.0];
-            }
+            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                hud.mode = MBProgressHUDModeText;
+                if (error) {
+                    NSLog(@"Firmware update error: %@", error.localizedDescription);
+                    [[[UIAlertView alloc] initWithTitle:@"Update Error"
+                                                message:[@"Please re-connect and try again, if you can't connect, try MetaBoot Mode to recover.\nError: " stringByAppendingString:error.localizedDescription]
+                                               delegate:nil
+                                      cancelButtonTitle:@"Okay"
+                                      otherButtonTitles:nil] show];
+                    [hud hide:YES];
+                } else {
+                    hud.labelText = @"Success!";
+                    [hud hide:YES afterDelay:2.0];
+                }
+            }];
         } progressHandler:^(float number, NSError *error) {
-            if (number != hud.progress) {
-                hud.progress = number;
-                if (number == 1.0) {
-                    hud.mode = MBProgressHUDModeIndeterminate;
-                    hud.labelText = @"Resetting...";
+            [[NSOperationQueue mainQueue] addOperationWithBlock:^{
+                if (number != hud.progress) {
+                    hud.progress = number;
+                    if (number == 1.0) {
+                        hud.mode = MBProgressHUDModeIndeterminate;
+                        hud.labelText = @"Resetting...";
+                    }
                 }
-            }
+            }];
         }];
     } else {
         [self performSegueWithIdentifier:@"DeviceDetails" sender:selected];
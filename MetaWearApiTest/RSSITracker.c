@@ -0,0 +1,83 @@
+/**
+ * RSSITracker.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "RSSITracker.h"
+#include <string.h>
+
+void RSSITrackerReset(RSSITracker *tracker)
+{
+	memset(tracker, 0, sizeof(*tracker));
+}
+
+static void RSSITrackerStart(RSSITracker *tracker, long rssi, double time)
+{
+	tracker->estimate = rssi;
+	tracker->variance = kRSSITrackerMeasurementNoise;
+	tracker->lastTime = time;
+	tracker->rejections = 0;
+	tracker->valid = 1;
+}
+
+int RSSITrackerUpdate(RSSITracker *tracker, long rssi, double time)
+{
+	double variance, innovation, spread, gain;
+	
+	if(rssi == kRSSITrackerInvalid || rssi >= 0)
+		return 0;
+	if(!tracker->valid)
+	{
+		RSSITrackerStart(tracker, rssi, time);
+		return 1;
+	}
+	
+	// Predict, then gate the innovation against its expected spread.
+	variance = tracker->variance + kRSSITrackerProcessNoise * (time > tracker->lastTime ? time - tracker->lastTime : 0.0);
+	innovation = rssi - tracker->estimate;
+	spread = variance + kRSSITrackerMeasurementNoise;
+	if(innovation * innovation > kRSSITrackerGate * kRSSITrackerGate * spread)
+	{
+		if(++tracker->rejections < kRSSITrackerMaxRejections)
+			return 0;
+		RSSITrackerStart(tracker, rssi, time);
+		return 1;
+	}
+	
+	gain = variance / spread;
+	tracker->estimate += gain * innovation;
+	tracker->variance = (1.0 - gain) * variance;
+	tracker->lastTime = time;
+	tracker->rejections = 0;
+	return 1;
+}
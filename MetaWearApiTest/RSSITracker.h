@@ -0,0 +1,77 @@
+/**
+ * RSSITracker.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Smoothing of the RSSI readings of one device. Plain C, so the scan core is shared by the app and the
+ Linux tests.
+ 
+ A scalar Kalman filter with a random walk model: the estimate is allowed to wander by
+ kRSSITrackerProcessNoise dB² per second between readings, and every reading is trusted according to
+ kRSSITrackerMeasurementNoise. A reading further than kRSSITrackerGate standard deviations from the
+ estimate is dropped as multipath noise, unless kRSSITrackerMaxRejections readings in a row are, in
+ which case the device has really moved and the filter starts over from the newest one.
+ */
+
+#ifndef RSSITracker_h
+#define RSSITracker_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define kRSSITrackerProcessNoise		4.0
+#define kRSSITrackerMeasurementNoise	16.0
+#define kRSSITrackerGate				3.0
+#define kRSSITrackerMaxRejections		3
+// Reported by CoreBluetooth when no reading is available.
+#define kRSSITrackerInvalid				127
+
+typedef struct {
+	double estimate;
+	double variance;
+	double lastTime;
+	unsigned rejections;
+	int valid;
+} RSSITracker;
+
+void RSSITrackerReset(RSSITracker *tracker);
+// Feed a reading taken at time seconds, returns 0 when it was rejected.
+int RSSITrackerUpdate(RSSITracker *tracker, long rssi, double time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * ScanAggregator.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import <Foundation/Foundation.h>
+#import <MetaWear/MetaWear.h>
+
+/*
+ Coalesces scan callbacks into row level changes.
+ 
+ Scanning with duplicates allowed calls back with the full device list on every advertisement. The
+ aggregator keeps one record per identifier with a short RSSI history and an RSSITracker, which get
+ the current discoveryTimeRSSI of every listed device on every callback, and at most
+ maximumRate times a second publishes what changed since the last time: devices that left the list,
+ devices that joined it, devices that moved and devices whose smoothed RSSI or connection state
+ changed. Removed indices and move sources refer to the previous list, everything else to the new
+ one, which is what UITableView batch updates expect, so a table only touches the rows that changed.
+ 
+ With sortsByProximity the list is ordered by smoothed RSSI in whole dB, strongest first and in
+ order of discovery between equals. The order is a ScanOrder treap whose nodes live in the records,
+ so a reading that changes a record's rank, a new device and a device that left are O(log n) each
+ and nothing is sorted again. A callback is O(n) for the readings it feeds plus O(log n) for each
+ rank they change. A publish walks the order once and finds the moves in O(n log n), and
+ publishes are capped at maximumRate.
+ */
+
+#define kScanAggregatorHistoryLength    32
+#define kScanAggregatorDefaultRate      10.0
+
+@interface ScanAggregatorChanges : NSObject
+@property (nonatomic, readonly) NSIndexSet *removed;
+@property (nonatomic, readonly) NSIndexSet *inserted;
+@property (nonatomic, readonly) NSIndexSet *updated;
+@property (nonatomic, readonly) NSUInteger moveCount;
+- (void)enumerateMovesUsingBlock:(void (^)(NSUInteger from, NSUInteger to))block;
+@end
+
+typedef void (^ScanAggregatorHandler)(NSArray *devices, ScanAggregatorChanges *changes);
+
+@interface ScanAggregator : NSObject
+
+- (id)initWithMaximumRate:(double)rate;
+
+// Feed the array from a scan handler, on the main queue.
+- (void)updateWithDevices:(NSArray *)devices;
+// Forget every device without publishing, devices is empty afterwards.
+- (void)reset;
+// Recent RSSI readings of a device as NSNumbers, oldest first.
+- (NSArray *)RSSIHistoryForDevice:(MBLMetaWear *)device;
+// Filtered RSSI in dB, the raw discovery RSSI for a device without a valid reading yet.
+- (double)smoothedRSSIForDevice:(MBLMetaWear *)device;
+
+// Called on the main queue with the devices in display order.
+@property (nonatomic, copy) ScanAggregatorHandler handler;
+@property (nonatomic, readonly) NSArray *devices;
+@property (nonatomic, readonly) double maximumRate;
+// Order by proximity instead of discovery, takes effect from the next publish.
+@property (nonatomic) BOOL sortsByProximity;
+
+@end
@@ -0,0 +1,337 @@
+/**
+ * ScanAggregator.m
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#import "ScanAggregator.h"
+#import "RSSITracker.h"
+#import "ScanOrder.h"
+#import <QuartzCore/QuartzCore.h>
+
+// Rank of a device without a valid reading, behind every real one.
+#define kScanAggregatorNoRank   (-1000)
+
+@interface ScanAggregatorChanges ()
+@property (nonatomic, readwrite) NSIndexSet *removed;
+@property (nonatomic, readwrite) NSIndexSet *inserted;
+@property (nonatomic, readwrite) NSIndexSet *updated;
+@property (nonatomic) NSMutableData *moves;
+@end
+
+@implementation ScanAggregatorChanges
+
+- (NSUInteger)moveCount
+{
+    return self.moves.length / (2 * sizeof(NSUInteger));
+}
+
+- (void)enumerateMovesUsingBlock:(void (^)(NSUInteger from, NSUInteger to))block
+{
+    const NSUInteger *pairs = self.moves.bytes;
+    for (NSUInteger i = 0; i < self.moveCount; i++) {
+        block(pairs[2 * i], pairs[2 * i + 1]);
+    }
+}
+
+@end
+
+@interface ScanRecord : NSObject
+@property (nonatomic, strong) MBLMetaWear *device;
+// Generation of the last scan callback that listed the device.
+@property (nonatomic) NSUInteger generation;
+@property (nonatomic) NSUInteger publishedIndex;
+@property (nonatomic) BOOL changed;
+@property (nonatomic) NSInteger displayedRSSI;
+@property (nonatomic) CBPeripheralState lastState;
+@end
+
+@implementation ScanRecord
+{
+    @public
+    RSSITracker tracker;
+    // Place in the proximity order, the serial is the discovery order and breaks ties between ranks.
+    ScanOrderNode node;
+    int16_t history[kScanAggregatorHistoryLength];
+    NSUInteger historyCount;
+    NSUInteger historyHead;
+}
+
+- (void)addRSSI:(NSInteger)rssi
+{
+    history[(historyHead + historyCount) % kScanAggregatorHistoryLength] = (int16_t)rssi;
+    if (historyCount < kScanAggregatorHistoryLength) {
+        historyCount++;
+    } else {
+        historyHead = (historyHead + 1) % kScanAggregatorHistoryLength;
+    }
+    RSSITrackerUpdate(&tracker, rssi, CACurrentMediaTime());
+}
+
+- (NSInteger)currentRank
+{
+    return tracker.valid ? lround(tracker.estimate) : kScanAggregatorNoRank;
+}
+
+@end
+
+@interface ScanAggregator ()
+@property (nonatomic, readwrite) NSArray *devices;
+@end
+
+@implementation ScanAggregator
+{
+    NSMutableDictionary *records;
+    NSMutableArray *discoveryOrder;
+    ScanOrder proximityOrder;
+    NSArray *publishedRecords;
+    NSUInteger generation;
+    NSUInteger nextSerial;
+    CFTimeInterval lastPublish;
+    BOOL publishScheduled;
+}
+
+- (id)init
+{
+    return [self initWithMaximumRate:kScanAggregatorDefaultRate];
+}
+
+- (id)initWithMaximumRate:(double)rate
+{
+    self = [super init];
+    if (self != nil) {
+        _maximumRate = rate;
+        _devices = @[];
+        records = [NSMutableDictionary dictionary];
+        discoveryOrder = [NSMutableArray array];
+        ScanOrderInit(&proximityOrder);
+        publishedRecords = @[];
+    }
+    return self;
+}
+
+- (void)reset
+{
+    [records removeAllObjects];
+    [discoveryOrder removeAllObjects];
+    ScanOrderInit(&proximityOrder);
+    publishedRecords = @[];
+    self.devices = @[];
+    // Any publish already scheduled finds nothing to do.
+    generation++;
+}
+
+- (void)setSortsByProximity:(BOOL)sortsByProximity
+{
+    _sortsByProximity = sortsByProximity;
+    [self schedulePublish];
+}
+
+- (void)updateWithDevices:(NSArray *)devices
+{
+    generation++;
+    BOOL changed = NO;
+    for (MBLMetaWear *device in devices) {
+        ScanRecord *record = records[device.identifier];
+        NSInteger rssi = device.discoveryTimeRSSI.integerValue;
+        if (!record) {
+            record = [[ScanRecord alloc] init];
+            record.device = device;
+            record->node.serial = nextSerial++;
+            record->node.context = (__bridge void *)record;
+            record.publishedIndex = NSNotFound;
+            record.lastState = device.state;
+            [record addRSSI:rssi];
+            record->node.rank = [record currentRank];
+            record.displayedRSSI = lround([self smoothedRSSIForRecord:record]);
+            records[device.identifier] = record;
+            [discoveryOrder addObject:record];
+            ScanOrderInsert(&proximityOrder, &record->node);
+            changed = YES;
+        } else {
+            record.device = device;
+            /*
+             The callback does not say which device advertised, and an advertisement repeating the last
+             RSSI leaves nothing to tell it apart by. So every callback is one reading for every listed
+             device, repeats included. Feeding only readings that differ from the last one would hand
+             the tracker the transitions alone, with its process noise growing over the repeats left out.
+             */
+            [record addRSSI:rssi];
+            ScanOrderSetRank(&proximityOrder, &record->node, [record currentRank]);
+            NSInteger displayed = lround([self smoothedRSSIForRecord:record]);
+            if (displayed != record.displayedRSSI || record.lastState != device.state) {
+                record.displayedRSSI = displayed;
+                record.lastState = device.state;
+                record.changed = YES;
+                changed = YES;
+            }
+        }
+        record.generation = generation;
+    }
+    // A device that dropped out of the list is a change too.
+    if (!changed && records.count != devices.count) {
+        changed = YES;
+    }
+    if (changed) {
+        [self schedulePublish];
+    }
+}
+
+- (void)schedulePublish
+{
+    if (publishScheduled) {
+        return;
+    }
+    publishScheduled = YES;
+    CFTimeInterval wait = MAX(0.0, lastPublish + 1.0 / self.maximumRate - CACurrentMediaTime());
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(wait * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        publishScheduled = NO;
+        [self publish];
+    });
+}
+
+- (void)publish
+{
+    lastPublish = CACurrentMediaTime();
+    NSPredicate *listed = [NSPredicate predicateWithBlock:^BOOL(ScanRecord *record, NSDictionary *bindings) {
+        return record.generation == generation;
+    }];
+    NSMutableIndexSet *removed = [NSMutableIndexSet indexSet];
+    for (ScanRecord *record in publishedRecords) {
+        if (record.generation != generation) {
+            [removed addIndex:record.publishedIndex];
+        }
+    }
+    BOOL dropped = NO;
+    for (ScanRecord *record in discoveryOrder) {
+        if (record.generation != generation) {
+            ScanOrderRemove(&proximityOrder, &record->node);
+            [records removeObjectForKey:record.device.identifier];
+            dropped = YES;
+        }
+    }
+    // Filtering keeps the discovery order sorted.
+    if (dropped) {
+        [discoveryOrder filterUsingPredicate:listed];
+    }
+    
+    NSArray *order = self.sortsByProximity ? [self proximityRecords] : [discoveryOrder copy];
+    NSMutableIndexSet *inserted = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *updated = [NSMutableIndexSet indexSet];
+    NSMutableData *moves = [self movesFromOrder:order];
+    [order enumerateObjectsUsingBlock:^(ScanRecord *record, NSUInteger index, BOOL *stop) {
+        if (record.publishedIndex == NSNotFound) {
+            [inserted addIndex:index];
+        } else if (record.changed) {
+            [updated addIndex:index];
+        }
+        record.changed = NO;
+        record.publishedIndex = index;
+    }];
+    publishedRecords = order;
+    
+    if (!removed.count && !inserted.count && !updated.count && !moves.length) {
+        return;
+    }
+    ScanAggregatorChanges *changes = [[ScanAggregatorChanges alloc] init];
+    changes.removed = removed;
+    changes.inserted = inserted;
+    changes.updated = updated;
+    changes.moves = moves;
+    self.devices = [order valueForKey:@"device"];
+    if (self.handler) {
+        self.handler(self.devices, changes);
+    }
+}
+
+- (NSArray *)proximityRecords
+{
+    NSUInteger count = proximityOrder.count;
+    ScanOrderNode **nodes = malloc(count * sizeof(ScanOrderNode *));
+    ScanOrderCollect(&proximityOrder, nodes);
+    NSMutableArray *order = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [order addObject:(__bridge ScanRecord *)nodes[i]->context];
+    }
+    free(nodes);
+    return order;
+}
+
+// Moves between the published list and order, see ScanOrderMoves.
+- (NSMutableData *)movesFromOrder:(NSArray *)order
+{
+    NSUInteger count = order.count;
+    NSMutableData *moves = [NSMutableData data];
+    if (count == 0) {
+        return moves;
+    }
+    size_t *previous = malloc(count * sizeof(size_t));
+    size_t *pairs = malloc(2 * count * sizeof(size_t));
+    size_t *scratch = malloc(3 * count * sizeof(size_t));
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger old = ((ScanRecord *)order[i]).publishedIndex;
+        previous[i] = old == NSNotFound ? kScanOrderNew : old;
+    }
+    size_t moveCount = ScanOrderMoves(previous, count, pairs, scratch);
+    for (size_t i = 0; i < moveCount; i++) {
+        NSUInteger pair[2] = { pairs[2 * i], pairs[2 * i + 1] };
+        [moves appendBytes:pair length:sizeof(pair)];
+    }
+    
+    free(previous);
+    free(pairs);
+    free(scratch);
+    return moves;
+}
+
+- (double)smoothedRSSIForRecord:(ScanRecord *)record
+{
+    return record->tracker.valid ? record->tracker.estimate : record.device.discoveryTimeRSSI.doubleValue;
+}
+
+- (double)smoothedRSSIForDevice:(MBLMetaWear *)device
+{
+    ScanRecord *record = records[device.identifier];
+    return record ? [self smoothedRSSIForRecord:record] : device.discoveryTimeRSSI.doubleValue;
+}
+
+- (NSArray *)RSSIHistoryForDevice:(MBLMetaWear *)device
+{
+    ScanRecord *record = records[device.identifier];
+    NSMutableArray *history = [NSMutableArray arrayWithCapacity:record ? record->historyCount : 0];
+    for (NSUInteger i = 0; record && i < record->historyCount; i++) {
+        [history addObject:@(record->history[(record->historyHead + i) % kScanAggregatorHistoryLength])];
+    }
+    return history;
+}
+
+@end
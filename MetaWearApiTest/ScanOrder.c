@@ -0,0 +1,200 @@
+/**
+ * ScanOrder.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+#include "ScanOrder.h"
+
+// Higher rank first and earlier discovery between equal ranks.
+static inline int Precedes(const ScanOrderNode *a, const ScanOrderNode *b)
+{
+	return a->rank > b->rank || (a->rank == b->rank && a->serial < b->serial);
+}
+
+// Murmur3 finalizer, serials are consecutive so they need mixing to make good priorities.
+static uint32_t Priority(unsigned long serial)
+{
+	uint64_t h = serial;
+	
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return (uint32_t)h;
+}
+
+static ScanOrderNode *Insert(ScanOrderNode *root, ScanOrderNode *node)
+{
+	ScanOrderNode *child;
+	
+	if(!root)
+		return node;
+	if(Precedes(node, root))
+	{
+		root->left = Insert(root->left, node);
+		if(root->left->priority > root->priority)
+		{
+			child = root->left;
+			root->left = child->right;
+			child->right = root;
+			return child;
+		}
+	}
+	else
+	{
+		root->right = Insert(root->right, node);
+		if(root->right->priority > root->priority)
+		{
+			child = root->right;
+			root->right = child->left;
+			child->left = root;
+			return child;
+		}
+	}
+	return root;
+}
+
+// Join two subtrees where everything in a comes before everything in b.
+static ScanOrderNode *Merge(ScanOrderNode *a, ScanOrderNode *b)
+{
+	if(!a)
+		return b;
+	if(!b)
+		return a;
+	if(a->priority > b->priority)
+	{
+		a->right = Merge(a->right, b);
+		return a;
+	}
+	b->left = Merge(a, b->left);
+	return b;
+}
+
+static ScanOrderNode *Remove(ScanOrderNode *root, const ScanOrderNode *node)
+{
+	if(!root)
+		return NULL;
+	if(root == node)
+		return Merge(root->left, root->right);
+	if(Precedes(node, root))
+		root->left = Remove(root->left, node);
+	else
+		root->right = Remove(root->right, node);
+	return root;
+}
+
+static ScanOrderNode **Collect(const ScanOrderNode *root, ScanOrderNode **out)
+{
+	while(root)
+	{
+		out = Collect(root->left, out);
+		*out++ = (ScanOrderNode *)root;
+		root = root->right;
+	}
+	return out;
+}
+
+void ScanOrderInit(ScanOrder *order)
+{
+	order->root = NULL;
+	order->count = 0;
+}
+
+void ScanOrderInsert(ScanOrder *order, ScanOrderNode *node)
+{
+	node->left = node->right = NULL;
+	node->priority = Priority(node->serial);
+	order->root = Insert(order->root, node);
+	order->count++;
+}
+
+void ScanOrderRemove(ScanOrder *order, ScanOrderNode *node)
+{
+	order->root = Remove(order->root, node);
+	order->count--;
+}
+
+void ScanOrderSetRank(ScanOrder *order, ScanOrderNode *node, long rank)
+{
+	if(node->rank == rank)
+		return;
+	order->root = Remove(order->root, node);
+	node->rank = rank;
+	node->left = node->right = NULL;
+	order->root = Insert(order->root, node);
+}
+
+void ScanOrderCollect(const ScanOrder *order, ScanOrderNode **nodes)
+{
+	Collect(order->root, nodes);
+}
+
+size_t ScanOrderMoves(const size_t *previous, size_t count, size_t *moves, size_t *scratch)
+{
+	size_t *tails = scratch, *links = scratch + count, *stays = scratch + 2 * count;
+	size_t length = 0, moveCount = 0, i;
+	
+	for(i = 0; i < count; ++i)
+	{
+		size_t low = 0, high = length;
+		
+		stays[i] = 0;
+		if(previous[i] == kScanOrderNew)
+			continue;
+		while(low < high)
+		{
+			size_t mid = low + (high - low) / 2;
+			if(previous[tails[mid]] < previous[i])
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		links[i] = low ? tails[low - 1] : kScanOrderNew;
+		tails[low] = i;
+		if(low == length)
+			length++;
+	}
+	for(i = length ? tails[length - 1] : kScanOrderNew; i != kScanOrderNew; i = links[i])
+		stays[i] = 1;
+	for(i = 0; i < count; ++i)
+	{
+		if(previous[i] != kScanOrderNew && !stays[i])
+		{
+			moves[2 * moveCount] = previous[i];
+			moves[2 * moveCount + 1] = i;
+			moveCount++;
+		}
+	}
+	return moveCount;
+}
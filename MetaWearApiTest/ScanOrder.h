@@ -0,0 +1,99 @@
+/**
+ * ScanOrder.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Proximity order of the scan list and the row moves between two published lists. Plain C, so the
+ scan core is shared by the app and the Linux tests.
+ 
+ The order is a treap keyed by rank, higher first, and by discovery serial between equal ranks. Every
+ node carries a priority hashed from its serial and the tree is kept a heap on those, which makes its
+ shape that of a random binary search tree whatever order devices show up and move in. Inserting,
+ removing and re-ranking a device are O(log n) expected, no other node moves in memory, and the
+ nodes live inside the caller's records so nothing is allocated.
+ */
+
+#ifndef ScanOrder_h
+#define ScanOrder_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Published index of a row that was not in the previous list.
+#define kScanOrderNew	((size_t)-1)
+
+typedef struct ScanOrderNode {
+	struct ScanOrderNode *left, *right;
+	long rank;
+	// Unique per node, set before inserting and never changed while in an order.
+	unsigned long serial;
+	uint32_t priority;
+	// The record the node belongs to.
+	void *context;
+} ScanOrderNode;
+
+typedef struct {
+	ScanOrderNode *root;
+	size_t count;
+} ScanOrder;
+
+void ScanOrderInit(ScanOrder *order);
+// Insert a node with rank and serial set.
+void ScanOrderInsert(ScanOrder *order, ScanOrderNode *node);
+void ScanOrderRemove(ScanOrder *order, ScanOrderNode *node);
+// Move a node of the order to its place for a new rank.
+void ScanOrderSetRank(ScanOrder *order, ScanOrderNode *node, long rank);
+// Write the nodes in order into nodes, which must hold order->count entries.
+void ScanOrderCollect(const ScanOrder *order, ScanOrderNode **nodes);
+
+/*
+ Rows that kept their relative order need no move, the deletes and inserts around them shift them
+ into place. The largest such set is the longest increasing run of previous indices along the new
+ order, found by patience sorting in O(n log n), and only the rows outside it are moved.
+ 
+ previous[i] is the published index of the row now at i, or kScanOrderNew. Writes a (from, to) pair
+ per move into moves, which must hold 2 * count entries, and returns the number of moves. scratch
+ must hold 3 * count entries.
+ */
+size_t ScanOrderMoves(const size_t *previous, size_t count, size_t *moves, size_t *scratch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * SessionSamples.h
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Synthetic recordings for the tests and benchmarks: 800 Hz ticks with BLE jitter and a board held
+ in the hand, milli-G around 1 g with noise and slow movement.
+ */
+
+#ifndef SessionSamples_h
+#define SessionSamples_h
+
+#include "TestSupport.h"
+#include <math.h>
+
+static void MakeSession(uint64_t *seed, uint64_t *tick, int16_t *x, int16_t *y, int16_t *z, size_t count)
+{
+	double phase = 0.0;
+	size_t i;
+	
+	for(i = 0; i < count; ++i)
+	{
+		phase += 0.004;
+		tick[i] = (uint64_t)(i * 1250) + (uint64_t)TestRandomRange(seed, 0, 40);
+		x[i] = (int16_t)(120.0 * sin(phase) + TestRandomRange(seed, -12, 12));
+		y[i] = (int16_t)(80.0 * cos(0.7 * phase) + TestRandomRange(seed, -12, 12));
+		z[i] = (int16_t)(1000.0 + 40.0 * sin(1.3 * phase) + TestRandomRange(seed, -12, 12));
+	}
+}
+
+// The same line the app's CSV export writes, "%f,%d,%d,%d\n" of seconds since 1970 and milli-G.
+static inline size_t FormatCSVLine(char *out, double epoch, uint64_t tick, int16_t x, int16_t y, int16_t z)
+{
+	return (size_t)sprintf(out, "%f,%d,%d,%d\n", epoch + tick / 1e6, x, y, z);
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * bench_csv_export.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Throughput of the CSV export over ten minutes of synthetic 800 Hz samples: AccelerometerCSVFormat
+ against one sprintf("%f,%d,%d,%d\n") per line, the C core of the stringWithFormat: call per row the
+ exporter used to make. The ObjC path also allocated an NSString per row on top of that.
+ */
+
+#include "AccelerometerCSVFormat.h"
+#include "SessionSamples.h"
+#include <string.h>
+
+#define kCount	(10 * 60 * 800)
+#define kRepeat	4
+
+static uint64_t tick[kCount];
+static int16_t x[kCount], y[kCount], z[kCount];
+
+static void Report(const char *name, double seconds, size_t bytes)
+{
+	printf("  %-22s %8.1f Msamples/s %9.1f MB/s\n", name, kCount * (double)kRepeat / seconds / 1e6, bytes * (double)kRepeat / seconds / 1e6);
+}
+
+int main(void)
+{
+	char *csv = malloc((size_t)kCount * kAccelerometerCSVMaxLineLength);
+	char *reference = malloc((size_t)kCount * kAccelerometerCSVMaxLineLength);
+	const uint64_t epochMicros = 1760000000123456ull;
+	size_t length = 0, referenceLength = 0, i;
+	uint64_t seed = 5;
+	double start, formatted, printed;
+	int r;
+	
+	CHECK(csv && reference, "out of memory");
+	MakeSession(&seed, tick, x, y, z, kCount);
+	printf("%d samples\n", kCount);
+	
+	start = TestSeconds();
+	for(r = 0; r < kRepeat; ++r)
+	{
+		referenceLength = 0;
+		for(i = 0; i < kCount; ++i)
+			referenceLength += (size_t)sprintf(reference + referenceLength, "%f,%d,%d,%d\n", (double)(epochMicros + tick[i]) / 1e6, x[i], y[i], z[i]);
+	}
+	printed = TestSeconds() - start;
+	Report("sprintf per line", printed, referenceLength);
+	
+	start = TestSeconds();
+	for(r = 0; r < kRepeat; ++r)
+		length = AccelerometerCSVFormat(csv, tick, x, y, z, kCount, epochMicros);
+	formatted = TestSeconds() - start;
+	Report("AccelerometerCSVFormat", formatted, length);
+	
+	CHECK(length == referenceLength && memcmp(csv, reference, length) == 0, "output differs from sprintf");
+	printf("  %.1fx faster, identical output\n", printed / formatted);
+	free(csv);
+	free(reference);
+	return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * bench_filter_kernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Throughput of the one pole filters in samples per second: the per-sample Norm/Clamp recurrences the
+ ObjC classes used to run, and the block drivers in each adaptive mode. Every variant reads the same
+ int16 input and stores every output, so they all do the same work. Also reports the largest
+ difference between AccelerometerAdaptiveFast and the exact mode, which should be zero, and the
+ cost of the biquad cascades by order next to the one pole lowpass. bench_filter_kernels_scalar is
+ the same without the SSE2/NEON loops.
+ */
+
+#include "AccelerometerFilterKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+#include <string.h>
+
+#define kSampleCount	(1 << 20)
+#define kRepeat			8
+
+static int16_t x[kSampleCount], y[kSampleCount], z[kSampleCount];
+static double outX[kSampleCount], outY[kSampleCount], outZ[kSampleCount];
+static double exactX[kSampleCount], exactY[kSampleCount], exactZ[kSampleCount];
+
+static double sink;
+
+static void Report(const char *name, double seconds)
+{
+	printf("  %-28s %8.1f Msamples/s\n", name, kSampleCount * (double)kRepeat / seconds / 1e6);
+}
+
+static void PerSampleLowpass(double filterConstant)
+{
+	double fx = 0.0, fy = 0.0, fz = 0.0;
+	size_t i;
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		double d = Clamp(fabs(Norm(fx, fy, fz) - Norm(x[i], y[i], z[i])) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+		double alpha = (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
+		
+		fx = x[i] * alpha + fx * (1.0 - alpha);
+		fy = y[i] * alpha + fy * (1.0 - alpha);
+		fz = z[i] * alpha + fz * (1.0 - alpha);
+		outX[i] = fx;
+		outY[i] = fy;
+		outZ[i] = fz;
+	}
+	sink += fx + fy + fz;
+}
+
+static void PerSampleHighpass(double filterConstant)
+{
+	double fx = 0.0, fy = 0.0, fz = 0.0, lastX = 0.0, lastY = 0.0, lastZ = 0.0;
+	size_t i;
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		double d = Clamp(fabs(Norm(fx, fy, fz) - Norm(x[i], y[i], z[i])) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+		double alpha = d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+		
+		fx = alpha * (fx + x[i] - lastX);
+		fy = alpha * (fy + y[i] - lastY);
+		fz = alpha * (fz + z[i] - lastZ);
+		lastX = x[i];
+		lastY = y[i];
+		lastZ = z[i];
+		outX[i] = fx;
+		outY[i] = fy;
+		outZ[i] = fz;
+	}
+	sink += fx + fy + fz;
+}
+
+static void BenchPerSample(int highpass)
+{
+	double start = TestSeconds();
+	int r;
+	
+	for(r = 0; r < kRepeat; ++r)
+	{
+		if(highpass)
+			PerSampleHighpass(0.9);
+		else
+			PerSampleLowpass(0.1);
+	}
+	Report("per-sample Norm/Clamp", TestSeconds() - start);
+}
+
+static void BenchDriver(const char *name, int highpass, AccelerometerAdaptiveMode adaptive, double *ox, double *oy, double *oz)
+{
+	double start = TestSeconds();
+	int r;
+	
+	for(r = 0; r < kRepeat; ++r)
+	{
+		AccelerometerFilterState state = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+		if(highpass)
+			AccelerometerHighpassRun(&state, 0.9, adaptive, x, y, z, ox, oy, oz, kSampleCount);
+		else
+			AccelerometerLowpassRun(&state, 0.1, adaptive, x, y, z, ox, oy, oz, kSampleCount);
+		sink += state.x;
+	}
+	Report(name, TestSeconds() - start);
+}
+
+static double BenchBiquad(unsigned order)
+{
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	size_t count = AccelerometerBiquadDesign(sections, order, AccelerometerBiquadLowpass, 800.0, 25.0, 0.0);
+	char name[32];
+	double start = TestSeconds(), seconds;
+	int r;
+	
+	for(r = 0; r < kRepeat; ++r)
+	{
+		AccelerometerBiquadState states[kAccelerometerBiquadMaxSections];
+		AccelerometerFilterState state = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+		
+		memset(states, 0, sizeof(states));
+		AccelerometerBiquadRun(sections, states, count, &state, x, y, z, outX, outY, outZ, kSampleCount);
+		sink += state.x;
+	}
+	seconds = TestSeconds() - start;
+	snprintf(name, sizeof(name), "biquad, order %u", order);
+	Report(name, seconds);
+	return seconds;
+}
+
+static double MaxDifference(void)
+{
+	double worst = 0.0;
+	size_t i;
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		worst = fmax(worst, fabs(outX[i] - exactX[i]));
+		worst = fmax(worst, fabs(outY[i] - exactY[i]));
+		worst = fmax(worst, fabs(outZ[i] - exactZ[i]));
+	}
+	return worst;
+}
+
+int main(void)
+{
+	uint64_t seed = 42;
+	int vx = 0, vy = 0, vz = 1000;
+	double first;
+	size_t i;
+	
+	// Sensor noise around 1 g in mg with now and then a movement.
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		int step = TestRandomRange(&seed, 0, 99) < 2 ? 300 : 3;
+		vx += TestRandomRange(&seed, -step, step) - vx / 64;
+		vy += TestRandomRange(&seed, -step, step) - vy / 64;
+		vz += TestRandomRange(&seed, -step, step) - (vz - 1000) / 64;
+		x[i] = (int16_t)vx;
+		y[i] = (int16_t)vy;
+		z[i] = (int16_t)vz;
+	}
+	
+	printf("lowpass, %d samples\n", kSampleCount);
+	BenchPerSample(0);
+	BenchDriver("block, not adaptive", 0, AccelerometerAdaptiveOff, outX, outY, outZ);
+	BenchDriver("block, adaptive exact", 0, AccelerometerAdaptiveExact, exactX, exactY, exactZ);
+	BenchDriver("block, adaptive fast", 0, AccelerometerAdaptiveFast, outX, outY, outZ);
+	printf("  fast vs exact, max difference %g\n", MaxDifference());
+	
+	printf("highpass, %d samples\n", kSampleCount);
+	BenchPerSample(1);
+	BenchDriver("block, not adaptive", 1, AccelerometerAdaptiveOff, outX, outY, outZ);
+	BenchDriver("block, adaptive exact", 1, AccelerometerAdaptiveExact, exactX, exactY, exactZ);
+	BenchDriver("block, adaptive fast", 1, AccelerometerAdaptiveFast, outX, outY, outZ);
+	printf("  fast vs exact, max difference %g\n", MaxDifference());
+	
+	printf("butterworth lowpass, %d samples\n", kSampleCount);
+	first = BenchBiquad(1);
+	BenchBiquad(2);
+	printf("  order 4 vs order 1, %.2fx the time\n", BenchBiquad(4) / first);
+	printf("  order 8 vs order 1, %.2fx the time\n", BenchBiquad(8) / first);
+	
+	return sink == 0.12345 ? 1 : 0;
+}
@@ -0,0 +1,321 @@
+/**
+ * bench_graph_frame.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Headless frame cost of the scrolling graph. Core Animation is not available here, so the renderers
+ are replayed against a model of APLGraphView: the same segment bookkeeping, the segment drawing
+ -displayLayer: does through APLGraphRaster, and a count of the layer properties written, each of
+ which Core Animation has to commit.
+ 
+ Per sample is the renderer before the display link: every value moved every segment layer and
+ invalidated the current one. Per frame is the current one fed a column per sample: values queue in
+ a ring and are drained once per display frame, scrolling a single container layer, and a frame
+ never takes more columns than fit across the graph. Setting a layer dirty more than once in a frame
+ still draws it once, so these two redraw the same segments and their cost still grows with the rate
+ until the cap is reached.
+ 
+ Decimated is what the app does: samples go through the min/max decimator of AccelerometerDecimator
+ into columns of 10 ms, so the graph gets 100 columns a second whatever the sample rate and only the
+ decimation itself grows with it.
+ */
+
+#include "APLGraphRaster.h"
+#include "TestSupport.h"
+#include <math.h>
+#include <string.h>
+
+#define kGraphWidth			320
+#define kGraphHeight		112
+#define kSegmentWidth		32
+#define kChannels			3
+#define kSegmentCount		(kGraphWidth / kSegmentWidth + 2)
+#define kPendingCapacity	2048
+// Columns a frame takes at most, as -drawPendingValues works it out from the graph width.
+#define kVisibleColumns		(kGraphWidth + kSegmentWidth)
+#define kFramesPerSecond	60
+#define kSeconds			20
+#define kColumnDuration		0.01
+#define kMaxRate			6400
+#define kSamples			(kMaxRate * kSeconds)
+
+typedef struct {
+	float history[2 * kChannels * (kSegmentWidth + 1)];
+	int index;
+	double x;
+	int dirty;
+} Segment;
+
+typedef struct {
+	Segment segments[kSegmentCount];
+	int current;
+	double scrollOffset;
+	double pendingMin[kPendingCapacity][kChannels];
+	double pendingMax[kPendingCapacity][kChannels];
+	size_t pendingStart, pendingCount;
+	unsigned long layerWrites;
+	unsigned long columns;
+	// Decimator state, a column closes once remaining reaches 0.
+	double perColumn, remaining;
+	double min[kChannels], max[kChannels];
+	int filled;
+} Graph;
+
+static uint32_t pixels[kSegmentWidth * kGraphHeight];
+static float rows[2 * kChannels * (kSegmentWidth + 1)];
+static double samples[kSamples][kChannels];
+
+static void ResetGraph(Graph *graph, double rate)
+{
+	int i;
+	
+	memset(graph, 0, sizeof(*graph));
+	for(i = 0; i < kSegmentCount; i++)
+	{
+		graph->segments[i].index = kSegmentWidth + 1;
+		graph->segments[i].x = kGraphWidth - (double)i * kSegmentWidth;
+	}
+	graph->perColumn = rate * kColumnDuration;
+	graph->remaining = graph->perColumn;
+}
+
+// Returns non-zero once the segment is full, like -[APLGraphViewSegment addMin:max:].
+static int AddColumn(Segment *segment, const double *min, const double *max)
+{
+	int channel, columns = kSegmentWidth + 1;
+	
+	if(segment->index > 0)
+	{
+		--segment->index;
+		for(channel = 0; channel < kChannels; channel++)
+		{
+			segment->history[channel * columns + segment->index] = (float)min[channel];
+			segment->history[(kChannels + channel) * columns + segment->index] = (float)max[channel];
+		}
+	}
+	return segment->index == 0;
+}
+
+// The oldest segment becomes the new current one at the left edge.
+static void Recycle(Graph *graph, double x)
+{
+	Segment *segment;
+	
+	graph->current = (graph->current + 1) % kSegmentCount;
+	segment = &graph->segments[graph->current];
+	memset(segment->history, 0, sizeof(segment->history));
+	segment->index = kSegmentWidth + 1;
+	segment->x = x;
+	segment->dirty = 1;
+	graph->layerWrites++;
+}
+
+static void Append(Graph *graph, const double *min, const double *max)
+{
+	if(AddColumn(&graph->segments[graph->current], min, max))
+	{
+		Recycle(graph, -graph->scrollOffset);
+		AddColumn(&graph->segments[graph->current], min, max);
+	}
+	graph->segments[graph->current].dirty = 1;
+	graph->columns++;
+}
+
+// What -displayLayer: draws for one segment.
+static void DrawSegment(const Segment *segment)
+{
+	APLGraphRaster raster = { pixels, kSegmentWidth, kGraphHeight, kSegmentWidth };
+	const float scale = -16.0f, half = kGraphHeight / 2.0f;
+	const int columns = kSegmentWidth + 1;
+	int i, channel;
+	double y;
+	
+	APLGraphRasterFill(&raster, APLGraphRasterColor(0, 0, 0, 255));
+	for(y = -(half - 8.0) - 0.5; y <= half - 8.0 + 0.5; y += 16.0)
+	{
+		APLGraphRasterHorizontalLine(&raster, y + half, 0, kSegmentWidth, APLGraphRasterColor(64, 64, 64, 255));
+	}
+	for(i = 0; i < 2 * kChannels * columns; i++)
+	{
+		rows[i] = segment->history[i] * scale + half;
+	}
+	for(channel = 0; channel < kChannels; channel++)
+	{
+		uint32_t color = APLGraphRasterColor(255, (uint8_t)(80 * channel), 0, 255);
+		APLGraphRasterPolyline(&raster, rows + channel * columns, columns, color);
+		APLGraphRasterPolyline(&raster, rows + (kChannels + channel) * columns, columns, color);
+	}
+}
+
+static void DrawDirty(Graph *graph)
+{
+	int i;
+	
+	for(i = 0; i < kSegmentCount; i++)
+	{
+		if(graph->segments[i].dirty)
+		{
+			DrawSegment(&graph->segments[i]);
+			graph->segments[i].dirty = 0;
+		}
+	}
+}
+
+static void PerSampleAdd(Graph *graph, const double *values)
+{
+	int i;
+	
+	Append(graph, values, values);
+	for(i = 0; i < kSegmentCount; i++)
+	{
+		graph->segments[i].x += 1.0;
+		graph->layerWrites++;
+	}
+}
+
+static void PerSampleFrame(Graph *graph)
+{
+	DrawDirty(graph);
+}
+
+static void Enqueue(Graph *graph, const double *min, const double *max)
+{
+	size_t slot;
+	
+	if(graph->pendingCount == kPendingCapacity)
+	{
+		graph->pendingStart = (graph->pendingStart + 1) % kPendingCapacity;
+		--graph->pendingCount;
+	}
+	slot = (graph->pendingStart + graph->pendingCount) % kPendingCapacity;
+	memcpy(graph->pendingMin[slot], min, sizeof(graph->pendingMin[slot]));
+	memcpy(graph->pendingMax[slot], max, sizeof(graph->pendingMax[slot]));
+	graph->pendingCount++;
+}
+
+static void PerFrameAdd(Graph *graph, const double *values)
+{
+	Enqueue(graph, values, values);
+}
+
+// A sample longer than a column fills every column it spans, like AccelerometerDecimator.
+static void DecimatedAdd(Graph *graph, const double *values)
+{
+	int channel;
+	
+	for(channel = 0; channel < kChannels; channel++)
+	{
+		if(!graph->filled || values[channel] < graph->min[channel])
+			graph->min[channel] = values[channel];
+		if(!graph->filled || values[channel] > graph->max[channel])
+			graph->max[channel] = values[channel];
+	}
+	graph->filled = 1;
+	graph->remaining -= 1.0;
+	while(graph->remaining < 1e-9)
+	{
+		Enqueue(graph, graph->min, graph->max);
+		graph->remaining += graph->perColumn;
+		graph->filled = 0;
+	}
+}
+
+static void PerFrameFrame(Graph *graph)
+{
+	if(graph->pendingCount == 0)
+	{
+		return;
+	}
+	if(graph->pendingCount > kVisibleColumns)
+	{
+		graph->pendingStart = (graph->pendingStart + graph->pendingCount - kVisibleColumns) % kPendingCapacity;
+		graph->pendingCount = kVisibleColumns;
+	}
+	for(; graph->pendingCount > 0; --graph->pendingCount, graph->pendingStart = (graph->pendingStart + 1) % kPendingCapacity)
+	{
+		Append(graph, graph->pendingMin[graph->pendingStart], graph->pendingMax[graph->pendingStart]);
+		graph->scrollOffset += 1.0;
+	}
+	DrawDirty(graph);
+	// The container position.
+	graph->layerWrites++;
+}
+
+static void Run(const char *name, double rate, void (*add)(Graph *, const double *), void (*frame)(Graph *))
+{
+	static Graph graph;
+	const int frames = kFramesPerSecond * kSeconds;
+	double due = 0.0, start, seconds;
+	size_t next = 0;
+	int f;
+	
+	ResetGraph(&graph, rate);
+	start = TestSeconds();
+	for(f = 0; f < frames; f++)
+	{
+		// Samples arriving until this frame, BLE delivers them in bursts so the count varies per frame.
+		for(due += rate / kFramesPerSecond; due >= 1.0; due -= 1.0)
+		{
+			add(&graph, samples[next++ % kSamples]);
+		}
+		frame(&graph);
+	}
+	seconds = TestSeconds() - start;
+	printf("  %-10s %6.0f Hz %8.2f us/frame %6.1f columns/frame %6.1f layer writes/frame\n", name, rate, seconds / frames * 1e6,
+		   (double)graph.columns / frames, (double)graph.layerWrites / frames);
+}
+
+int main(void)
+{
+	static const double rates[] = { 50.0, 100.0, 200.0, 400.0, 800.0, 1600.0, 6400.0, 25600.0 };
+	uint64_t seed = 0x5eedULL;
+	size_t i;
+	int channel;
+	
+	// Generated up front so only the graph is timed.
+	for(i = 0; i < kSamples; i++)
+	{
+		for(channel = 0; channel < kChannels; channel++)
+		{
+			samples[i][channel] = TestRandomRange(&seed, -3000, 3000) / 1000.0;
+		}
+	}
+	for(i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+	{
+		Run("per sample", rates[i], PerSampleAdd, PerSampleFrame);
+		Run("per frame", rates[i], PerFrameAdd, PerFrameFrame);
+		Run("decimated", rates[i], DecimatedAdd, PerFrameFrame);
+	}
+	return 0;
+}
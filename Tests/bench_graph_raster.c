@@ -0,0 +1,174 @@
+/**
+ * bench_graph_raster.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Throughput of APLGraphRaster on the work -displayLayer: does for one segment: turning the float
+ history into pixel rows, fill, grid lines and three channels of min and max polylines with a bar
+ per column, at the default segment size and at twice that in both directions for a Retina screen.
+ 
+ The row generation is also timed on its own against the point preparation it replaced, which
+ rebuilt a CGPoint line segment array per axis from three double histories. vDSP_vsmsa is not
+ available here, RowsFromHistory is the same multiply-add over the whole buffer as a plain loop.
+ */
+
+#include "APLGraphRaster.h"
+#include "TestSupport.h"
+
+#define kSegmentWidth	32
+#define kRepeat			200000
+#define kPrepareRepeat	2000000
+
+typedef struct {
+	double x, y;
+} Point;
+
+static float history[2 * 3 * (2 * kSegmentWidth + 1)], rows[2 * 3 * (2 * kSegmentWidth + 1)];
+static uint32_t pixels[2 * kSegmentWidth * 2 * 112];
+static double oldHistory[3][kSegmentWidth + 1];
+static Point points[2 * kSegmentWidth];
+static double sink;
+
+// rows = history * scale + offset, what vDSP_vsmsa computes in -displayLayer:.
+static void RowsFromHistory(const float *restrict values, float scale, float offset, float *restrict out, size_t count)
+{
+	size_t i;
+	
+	for(i = 0; i < count; i++)
+		out[i] = values[i] * scale + offset;
+}
+
+static void BenchPrepare(void)
+{
+	const size_t columns = kSegmentWidth + 1;
+	const float graphScale = 16.0f, half = 56.0f;
+	uint64_t seed = 0x5e6dULL;
+	double start, seconds;
+	size_t axis, i;
+	int r;
+	
+	for(i = 0; i < 2 * 3 * columns; i++)
+		history[i] = (float)(TestRandomRange(&seed, -3000, 3000) / 1000.0);
+	for(axis = 0; axis < 3; axis++)
+		for(i = 0; i < columns; i++)
+			oldHistory[axis][i] = history[axis * columns + i];
+	
+	start = TestSeconds();
+	for(r = 0; r < kPrepareRepeat; r++)
+	{
+		for(axis = 0; axis < 3; axis++)
+		{
+			for(i = 0; i < kSegmentWidth; i++)
+			{
+				points[2 * i].x = (double)i;
+				points[2 * i].y = -oldHistory[axis][i] * graphScale;
+				points[2 * i + 1].x = (double)(i + 1);
+				points[2 * i + 1].y = -oldHistory[axis][i + 1] * graphScale;
+			}
+			sink += points[r % (2 * kSegmentWidth)].y;
+		}
+	}
+	seconds = TestSeconds() - start;
+	printf("  points per axis, double  %10.0f segments/s\n", kPrepareRepeat / seconds);
+	
+	start = TestSeconds();
+	for(r = 0; r < kPrepareRepeat; r++)
+	{
+		// Minimums and maximums of all three channels in one pass, twice the values of the old points.
+		RowsFromHistory(history, -graphScale, half, rows, 2 * 3 * columns);
+		sink += rows[r % (2 * 3 * columns)];
+	}
+	seconds = TestSeconds() - start;
+	printf("  rows in one pass, float  %10.0f segments/s\n", kPrepareRepeat / seconds);
+}
+
+static void Bench(size_t width, size_t height, double scale)
+{
+	APLGraphRaster raster = { pixels, width, height, width };
+	const uint32_t background = APLGraphRasterColor(0, 0, 0, 255), grid = APLGraphRasterColor(64, 64, 64, 255);
+	const uint32_t colors[3] = { APLGraphRasterColor(255, 0, 0, 255), APLGraphRasterColor(0, 255, 0, 255), APLGraphRasterColor(0, 0, 255, 255) };
+	const double half = height / 2.0;
+	const float rowScale = (float)(-16.0 * scale);
+	uint64_t seed = 0xbe7cULL;
+	const size_t columns = width + 1;
+	double start, seconds, y;
+	size_t channel, i;
+	int r;
+	
+	// History in g, within the rows the graph shows.
+	for(channel = 0; channel < 3; channel++)
+	{
+		for(i = 0; i < columns; i++)
+		{
+			float a = (float)(TestRandomRange(&seed, -(int)height * 10, (int)height * 10) / 10.0 / (2.0 * 16.0 * scale));
+			float b = (float)(TestRandomRange(&seed, -(int)height * 10, (int)height * 10) / 10.0 / (2.0 * 16.0 * scale));
+			history[channel * columns + i] = a < b ? a : b;
+			history[(3 + channel) * columns + i] = a < b ? b : a;
+		}
+	}
+	
+	start = TestSeconds();
+	for(r = 0; r < kRepeat; r++)
+	{
+		RowsFromHistory(history, rowScale, (float)half, rows, 2 * 3 * columns);
+		APLGraphRasterFill(&raster, background);
+		for(y = -(half - 8.0 * scale) - 0.5; y <= half - 8.0 * scale + 0.5; y += 16.0 * scale)
+			APLGraphRasterHorizontalLine(&raster, y + half, 0, width, grid);
+		for(channel = 0; channel < 3; channel++)
+		{
+			const float *low = history + channel * columns, *high = history + (3 + channel) * columns;
+			const float *lowRows = rows + channel * columns, *highRows = rows + (3 + channel) * columns;
+			
+			APLGraphRasterPolyline(&raster, lowRows, columns, colors[channel]);
+			APLGraphRasterPolyline(&raster, highRows, columns, colors[channel]);
+			for(i = 0; i < columns; i++)
+			{
+				if(high[i] > low[i])
+					APLGraphRasterVerticalLine(&raster, i < width ? i : width - 1, lowRows[i], highRows[i], colors[channel]);
+			}
+		}
+	}
+	seconds = TestSeconds() - start;
+	printf("  %3zux%-3zu %10.0f segments/s %8.1f Mpixels/s\n", width, height, kRepeat / seconds, kRepeat * (double)(width * height) / seconds / 1e6);
+}
+
+int main(void)
+{
+	printf("point preparation, %d columns of three channels\n", kSegmentWidth);
+	BenchPrepare();
+	printf("segments\n");
+	Bench(kSegmentWidth, 112, 1.0);
+	Bench(2 * kSegmentWidth, 2 * 112, 2.0);
+	return sink == 0.12345 ? 1 : 0;
+}
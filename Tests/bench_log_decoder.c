@@ -0,0 +1,77 @@
+/**
+ * bench_log_decoder.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Decode throughput of the scalar loop and of AccelerometerLogDecodeInt16x3 with whatever vector path
+ the build has, in bytes of payload per second. On x86 "make bench" also runs bench_log_decoder_ssse3,
+ the same benchmark built with -mssse3 to time the shuffle path.
+ */
+
+#include "AccelerometerLogDecoder.h"
+#include "TestSupport.h"
+
+#define kSampleCount	(1 << 20)
+#define kRepeat			200
+
+static uint8_t src[kSampleCount * kAccelerometerLogPayloadSize];
+static int16_t x[kSampleCount], y[kSampleCount], z[kSampleCount];
+
+static void Bench(const char *name, void (*decode)(const uint8_t *, size_t, int16_t *, int16_t *, int16_t *))
+{
+	double start = TestSeconds(), seconds;
+	long sum = 0;
+	int r;
+	
+	for(r = 0; r < kRepeat; r++)
+	{
+		decode(src, kSampleCount, x, y, z);
+		sum += x[r] + y[r] + z[r];
+	}
+	seconds = TestSeconds() - start;
+	printf("  %-8s %8.2f GB/s %8.1f Msamples/s (%ld)\n", name, sizeof(src) * (double)kRepeat / seconds / 1e9,
+		   kSampleCount * (double)kRepeat / seconds / 1e6, sum % 10);
+}
+
+int main(void)
+{
+	uint64_t seed = 0xbe7cULL;
+	size_t i;
+	
+	for(i = 0; i < sizeof(src); i++)
+		src[i] = (uint8_t)TestRandom(&seed);
+	Bench("scalar", AccelerometerLogDecodeInt16x3Scalar);
+	Bench("default", AccelerometerLogDecodeInt16x3);
+	return 0;
+}
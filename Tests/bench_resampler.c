@@ -0,0 +1,159 @@
+/**
+ * bench_resampler.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Throughput of AccelerometerResamplerKernels putting many 800 Hz devices onto one 800 Hz grid, the
+ way a multi-device stream is synchronized: every device has its own resampler following its own
+ clock with the running estimate, and samples arrive in BLE notifications of six, one device after
+ the other. Also the log pipeline case of one long recording with a fitted timebase in large pieces.
+ */
+
+#include "AccelerometerResamplerKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+
+#define kRate			800.0
+#define kSeconds		20
+#define kCount			(kSeconds * 800)
+#define kPiece			6
+#define kMaxDevices		64
+
+static float x[kCount], y[kCount], z[kCount];
+static uint64_t ticks[kMaxDevices][kCount];
+static float outX[256], outY[256], outZ[256];
+static double sink;
+
+static size_t Drain(AccelerometerResamplerState *state)
+{
+	size_t total = 0, n;
+	int64_t first;
+	
+	while((n = AccelerometerResamplerProduce(state, outX, outY, outZ, 256, &first)) > 0)
+	{
+		total += n;
+		sink += outX[n - 1];
+	}
+	return total;
+}
+
+static void BenchDevices(size_t devices)
+{
+	AccelerometerResamplerState *states[kMaxDevices];
+	size_t outputs = 0, done, piece, d;
+	double start, seconds;
+	
+	for(d = 0; d < devices; d++)
+	{
+		states[d] = AccelerometerResamplerCreate(kRate, kRate, NULL);
+		CHECK(states[d], "out of memory");
+	}
+	start = TestSeconds();
+	for(done = 0; done < kCount; done += piece)
+	{
+		piece = kCount - done < kPiece ? kCount - done : kPiece;
+		for(d = 0; d < devices; d++)
+		{
+			CHECK(AccelerometerResamplerAdd(states[d], x + done, y + done, z + done, ticks[d] + done, piece) == piece, "history full");
+			outputs += Drain(states[d]);
+		}
+	}
+	for(d = 0; d < devices; d++)
+	{
+		AccelerometerResamplerFinish(states[d]);
+		outputs += Drain(states[d]);
+	}
+	seconds = TestSeconds() - start;
+	printf("  %2zu devices %8.2f Msamples/s %9.0f devices at 800 Hz per core\n", devices, devices * (double)kCount / seconds / 1e6,
+		   devices * (double)kCount / seconds / kRate);
+	CHECK(outputs + devices * kAccelerometerResamplerTaps >= devices * kCount, "only %zu outputs", outputs);
+	for(d = 0; d < devices; d++)
+		AccelerometerResamplerDestroy(states[d]);
+}
+
+static void BenchLog(void)
+{
+	const AccelerometerTimebase timebase = { 0.0004, 1.0 + 60e-6 };
+	AccelerometerResamplerState *state = AccelerometerResamplerCreate(kRate, kRate, &timebase);
+	size_t done, outputs = 0;
+	double start, seconds;
+	int r;
+	
+	CHECK(state, "out of memory");
+	start = TestSeconds();
+	for(r = 0; r < 16; r++)
+	{
+		AccelerometerResamplerReset(state);
+		for(done = 0; done < kCount;)
+		{
+			done += AccelerometerResamplerAdd(state, x + done, y + done, z + done, ticks[0] + done, kCount - done < 4096 ? kCount - done : 4096);
+			outputs += Drain(state);
+		}
+		AccelerometerResamplerFinish(state);
+		outputs += Drain(state);
+	}
+	seconds = TestSeconds() - start;
+	printf("  log, fitted %8.2f Msamples/s\n", 16 * (double)kCount / seconds / 1e6);
+	CHECK(outputs + 16 * kAccelerometerResamplerTaps >= 16 * kCount, "only %zu outputs", outputs);
+	AccelerometerResamplerDestroy(state);
+}
+
+int main(void)
+{
+	uint64_t seed = 23;
+	size_t i, d;
+	
+	for(i = 0; i < kCount; i++)
+	{
+		double t = i / kRate;
+		x[i] = (float)(120.0 * sin(2.0 * 3.14159265358979323846 * 1.3 * t) + TestRandomRange(&seed, -12, 12));
+		y[i] = (float)(80.0 * cos(2.0 * 3.14159265358979323846 * 0.7 * t) + TestRandomRange(&seed, -12, 12));
+		z[i] = (float)(1000.0 + TestRandomRange(&seed, -12, 12));
+	}
+	// Each board a little fast or slow, with BLE jitter on every tick.
+	for(d = 0; d < kMaxDevices; d++)
+	{
+		double ppm = TestRandomRange(&seed, -100, 100);
+		for(i = 0; i < kCount; i++)
+			ticks[d][i] = (uint64_t)(i * 1250.0 * (1.0 + ppm * 1e-6)) + (uint64_t)TestRandomRange(&seed, 0, 400);
+	}
+	
+	printf("%d s at 800 Hz per device, notifications of %d samples\n", kSeconds, kPiece);
+	BenchDevices(1);
+	BenchDevices(4);
+	BenchDevices(16);
+	BenchDevices(64);
+	BenchLog();
+	return sink == 0.12345 ? 1 : 0;
+}
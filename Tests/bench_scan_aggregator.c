@@ -0,0 +1,205 @@
+/**
+ * bench_scan_aggregator.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Cost of keeping the scan list in proximity order as readings arrive, ScanOrder against the sorted
+ array with binary searches and memmove it replaced. Every update moves one advertiser a few dB,
+ the way smoothed RSSI drifts in a crowded scan. Also the cost of collecting the order and finding
+ the moves for a publish.
+ */
+
+#include "ScanOrder.h"
+#include "TestSupport.h"
+#include <string.h>
+
+#define kMaxAdvertisers	100000
+#define kUpdates		2000000
+
+static ScanOrderNode nodes[kMaxAdvertisers];
+static ScanOrderNode *sorted[kMaxAdvertisers];
+static ScanOrderNode *collected[kMaxAdvertisers];
+static long ranks[kMaxAdvertisers];
+static size_t targets[kUpdates];
+static long steps[kUpdates];
+static size_t previous[kMaxAdvertisers], moves[2 * kMaxAdvertisers], scratch[3 * kMaxAdvertisers];
+
+static int Precedes(const ScanOrderNode *a, long rank, unsigned long serial)
+{
+	return a->rank > rank || (a->rank == rank && a->serial < serial);
+}
+
+static size_t LowerBound(size_t count, long rank, unsigned long serial)
+{
+	size_t low = 0, high = count;
+	
+	while(low < high)
+	{
+		size_t mid = low + (high - low) / 2;
+		if(Precedes(sorted[mid], rank, serial))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+static void Setup(size_t count)
+{
+	uint64_t seed = 41;
+	size_t i;
+	
+	for(i = 0; i < count; i++)
+		ranks[i] = TestRandomRange(&seed, -100, -30);
+	for(i = 0; i < kUpdates; i++)
+	{
+		targets[i] = (size_t)TestRandomRange(&seed, 0, (int)count - 1);
+		steps[i] = TestRandomRange(&seed, -3, 3);
+	}
+}
+
+static double BenchTree(size_t count)
+{
+	ScanOrder order;
+	double start, seconds;
+	size_t i;
+	
+	ScanOrderInit(&order);
+	for(i = 0; i < count; i++)
+	{
+		nodes[i].serial = i;
+		nodes[i].rank = ranks[i];
+		ScanOrderInsert(&order, &nodes[i]);
+	}
+	start = TestSeconds();
+	for(i = 0; i < kUpdates; i++)
+	{
+		ScanOrderNode *node = &nodes[targets[i]];
+		ScanOrderSetRank(&order, node, node->rank + steps[i]);
+	}
+	seconds = TestSeconds() - start;
+	
+	ScanOrderCollect(&order, collected);
+	for(i = 1; i < count; i++)
+		CHECK(Precedes(collected[i - 1], collected[i]->rank, collected[i]->serial), "tree out of order at %zu", i);
+	return seconds;
+}
+
+static double BenchArray(size_t count)
+{
+	double start, seconds;
+	size_t i, from, to;
+	
+	for(i = 0; i < count; i++)
+	{
+		nodes[i].serial = i;
+		nodes[i].rank = ranks[i];
+		to = LowerBound(i, ranks[i], i);
+		memmove(sorted + to + 1, sorted + to, (i - to) * sizeof(*sorted));
+		sorted[to] = &nodes[i];
+	}
+	start = TestSeconds();
+	for(i = 0; i < kUpdates; i++)
+	{
+		ScanOrderNode *node = &nodes[targets[i]];
+		long rank = node->rank + steps[i];
+		
+		if(rank == node->rank)
+			continue;
+		from = LowerBound(count, node->rank, node->serial);
+		CHECK(from < count && sorted[from] == node, "update %zu lost its node", i);
+		memmove(sorted + from, sorted + from + 1, (count - from - 1) * sizeof(*sorted));
+		node->rank = rank;
+		to = LowerBound(count - 1, rank, node->serial);
+		memmove(sorted + to + 1, sorted + to, (count - 1 - to) * sizeof(*sorted));
+		sorted[to] = node;
+	}
+	seconds = TestSeconds() - start;
+	
+	for(i = 0; i < count; i++)
+		CHECK(sorted[i] == collected[i], "array and tree disagree at %zu", i);
+	return seconds;
+}
+
+// One publish: collect the order and find the moves from the order before the updates.
+static double BenchPublish(size_t count)
+{
+	double start, seconds;
+	size_t i, moveCount = 0;
+	ScanOrder order;
+	int repeat;
+	
+	ScanOrderInit(&order);
+	for(i = 0; i < count; i++)
+	{
+		nodes[i].serial = i;
+		nodes[i].rank = ranks[i];
+		ScanOrderInsert(&order, &nodes[i]);
+	}
+	ScanOrderCollect(&order, collected);
+	for(i = 0; i < count; i++)
+		collected[i]->context = (void *)(uintptr_t)i;
+	for(i = 0; i < count; i++)
+		ScanOrderSetRank(&order, &nodes[i], nodes[i].rank + steps[i]);
+	
+	start = TestSeconds();
+	for(repeat = 0; repeat < 20; repeat++)
+	{
+		ScanOrderCollect(&order, collected);
+		for(i = 0; i < count; i++)
+			previous[i] = (size_t)(uintptr_t)collected[i]->context;
+		moveCount += ScanOrderMoves(previous, count, moves, scratch);
+	}
+	seconds = (TestSeconds() - start) / 20;
+	CHECK(moveCount > 0 && moveCount < 20 * count, "%zu moves", moveCount);
+	return seconds;
+}
+
+int main(void)
+{
+	static const size_t counts[] = { 1000, 10000, 100000 };
+	double tree, array;
+	size_t i;
+	
+	printf("%d rank updates of -3..3 dB\n", kUpdates);
+	for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+	{
+		Setup(counts[i]);
+		tree = BenchTree(counts[i]);
+		array = BenchArray(counts[i]);
+		printf("  %6zu advertisers: tree %7.2f Mupdates/s, sorted array %7.2f Mupdates/s, publish %7.3f ms\n",
+			counts[i], kUpdates / tree / 1e6, kUpdates / array / 1e6, BenchPublish(counts[i]) * 1e3);
+	}
+	return 0;
+}
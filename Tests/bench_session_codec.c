@@ -0,0 +1,114 @@
+/**
+ * bench_session_codec.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Throughput of the session block codec against writing and parsing the CSV the app used to mail,
+ over ten minutes of synthetic 800 Hz samples.
+ */
+
+#include "AccelerometerSessionCodec.h"
+#include "SessionSamples.h"
+#include <string.h>
+
+#define kCount	(10 * 60 * 800)
+#define kBlock	kAccelerometerSessionBlockSize
+
+static uint64_t tick[kCount], decodedTick[kCount], scratch[2 * kBlock];
+static int16_t x[kCount], y[kCount], z[kCount], decodedX[kCount], decodedY[kCount], decodedZ[kCount];
+
+static void Report(const char *name, double seconds, size_t bytes)
+{
+	printf("  %-14s %8.1f Msamples/s %9.1f MB/s\n", name, kCount / seconds / 1e6, bytes / seconds / 1e6);
+}
+
+int main(void)
+{
+	size_t blocks = (kCount + kBlock - 1) / kBlock, binary = 0, csvLength = 0, i, done;
+	uint8_t *file = malloc(blocks * (sizeof(AccelerometerSessionBlockHeader) + AccelerometerSessionRawPayloadSize(kBlock)));
+	char *csv = malloc((size_t)kCount * 64), *cursor;
+	uint64_t seed = 5;
+	double start;
+	
+	CHECK(file && csv, "out of memory");
+	MakeSession(&seed, tick, x, y, z, kCount);
+	printf("%d samples\n", kCount);
+	
+	start = TestSeconds();
+	for(done = 0; done < kCount; done += kBlock)
+	{
+		uint32_t count = (uint32_t)(kCount - done < kBlock ? kCount - done : kBlock);
+		AccelerometerSessionBlockHeader *header = (AccelerometerSessionBlockHeader *)(file + binary);
+		
+		AccelerometerSessionEncodeBlock(header, (uint8_t *)(header + 1), scratch, tick + done, x + done, y + done, z + done, count);
+		binary += sizeof(*header) + header->payloadSize;
+	}
+	Report("encode", TestSeconds() - start, binary);
+	
+	start = TestSeconds();
+	for(done = 0, i = 0; done < kCount;)
+	{
+		const AccelerometerSessionBlockHeader *header = (const AccelerometerSessionBlockHeader *)(file + i);
+		AccelerometerSessionDecodeBlock(header, (const uint8_t *)(header + 1), scratch,
+										decodedTick + done, decodedX + done, decodedY + done, decodedZ + done);
+		done += header->count;
+		i += sizeof(*header) + header->payloadSize;
+	}
+	Report("decode", TestSeconds() - start, binary);
+	CHECK(memcmp(decodedTick, tick, sizeof(tick)) == 0 && memcmp(decodedZ, z, sizeof(z)) == 0, "round trip failed");
+	
+	start = TestSeconds();
+	for(i = 0; i < kCount; ++i)
+		csvLength += FormatCSVLine(csv + csvLength, 1760000000.0, tick[i], x[i], y[i], z[i]);
+	Report("CSV format", TestSeconds() - start, csvLength);
+	
+	start = TestSeconds();
+	cursor = csv;
+	for(i = 0; i < kCount; ++i)
+	{
+		double seconds = strtod(cursor, &cursor);
+		decodedTick[i] = (uint64_t)((seconds - 1760000000.0) * 1e6 + 0.5);
+		decodedX[i] = (int16_t)strtol(cursor + 1, &cursor, 10);
+		decodedY[i] = (int16_t)strtol(cursor + 1, &cursor, 10);
+		decodedZ[i] = (int16_t)strtol(cursor + 1, &cursor, 10);
+		cursor++;
+	}
+	Report("CSV parse", TestSeconds() - start, csvLength);
+	CHECK(memcmp(decodedZ, z, sizeof(z)) == 0, "CSV round trip failed");
+	
+	printf("  %zu bytes of blocks, %zu bytes of CSV, %.1fx smaller\n", binary, csvLength, (double)csvLength / binary);
+	free(file);
+	free(csv);
+	return 0;
+}
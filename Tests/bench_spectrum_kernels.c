@@ -0,0 +1,138 @@
+/**
+ * bench_spectrum_kernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Streaming spectral analysis throughput at 800 Hz, the way AccelerometerSpectrum runs it: circular
+ buffers per axis, one spectrum per hop.
+ 
+   bench_spectrum_kernels [AccData.csv ...]
+ 
+ Takes the CSV files mailed by the app, lines of "seconds,x,y,z". Without any, a minute of
+ synthetic samples is used instead.
+ */
+
+#include "AccelerometerSpectrumKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+
+#define kRate		800.0
+#define kWindow		1024
+#define kHop		256
+
+typedef struct {
+	int16_t *x, *y, *z;
+	size_t count, capacity;
+} Samples;
+
+static void Append(Samples *samples, int x, int y, int z)
+{
+	if(samples->count == samples->capacity)
+	{
+		samples->capacity = samples->capacity ? samples->capacity * 2 : 65536;
+		samples->x = realloc(samples->x, samples->capacity * sizeof(int16_t));
+		samples->y = realloc(samples->y, samples->capacity * sizeof(int16_t));
+		samples->z = realloc(samples->z, samples->capacity * sizeof(int16_t));
+		CHECK(samples->x && samples->y && samples->z, "out of memory");
+	}
+	samples->x[samples->count] = (int16_t)x;
+	samples->y[samples->count] = (int16_t)y;
+	samples->z[samples->count] = (int16_t)z;
+	samples->count++;
+}
+
+static void ReadCSV(const char *path, Samples *samples)
+{
+	FILE *file = fopen(path, "r");
+	double seconds;
+	int x, y, z;
+	
+	CHECK(file, "cannot open %s", path);
+	while(fscanf(file, "%lf,%d,%d,%d", &seconds, &x, &y, &z) == 4)
+		Append(samples, x, y, z);
+	fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+	static float ring[3][kWindow], power[3][kWindow / 2 + 1];
+	AccelerometerSpectrumPlan *plan = AccelerometerSpectrumPlanCreate(kWindow);
+	Samples samples = { NULL, NULL, NULL, 0, 0 };
+	size_t i, next = 0, filled = 0, sinceHop = 0, windows = 0;
+	double start, seconds, dominant = 0.0;
+	uint64_t seed = 3;
+	int axis;
+	
+	for(i = 1; i < (size_t)argc; ++i)
+		ReadCSV(argv[i], &samples);
+	if(samples.count == 0)
+	{
+		for(i = 0; i < 60 * (size_t)kRate; ++i)
+			Append(&samples, (int)(200.0 * sin(i * 0.1)) + TestRandomRange(&seed, -20, 20), TestRandomRange(&seed, -20, 20),
+				   1000 + (int)(50.0 * sin(i * 0.37)) + TestRandomRange(&seed, -20, 20));
+	}
+	
+	start = TestSeconds();
+	for(i = 0; i < samples.count; ++i)
+	{
+		ring[0][next] = samples.x[i];
+		ring[1][next] = samples.y[i];
+		ring[2][next] = samples.z[i];
+		next = (next + 1) & (kWindow - 1);
+		filled += filled < kWindow;
+		if(filled == kWindow && ++sinceHop >= kHop)
+		{
+			sinceHop = 0;
+			for(axis = 0; axis < 3; ++axis)
+			{
+				AccelerometerSpectrumPower(plan, ring[axis], next, power[axis]);
+				dominant += AccelerometerSpectrumPeak(power[axis], kWindow / 2 + 1, kRate / kWindow, NULL);
+			}
+			windows++;
+		}
+	}
+	seconds = TestSeconds() - start;
+	
+	printf("%zu samples, %zu windows of %d with hop %d\n", samples.count, windows, kWindow, kHop);
+	printf("  %.1f Msamples/s, %.1f us per window of three axes\n", samples.count / seconds / 1e6, windows ? seconds / windows * 1e6 : 0.0);
+	printf("  %.0fx real time at %.0f Hz, latency at most %.0f ms after the first window\n",
+		   samples.count / kRate / seconds, kRate, kHop / kRate * 1000.0);
+	printf("  mean dominant frequency %.2f Hz\n", windows ? dominant / (3 * windows) : 0.0);
+	
+	AccelerometerSpectrumPlanDestroy(plan);
+	free(samples.x);
+	free(samples.y);
+	free(samples.z);
+	return 0;
+}
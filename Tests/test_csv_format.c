@@ -0,0 +1,101 @@
+/**
+ * test_csv_format.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Checks that AccelerometerCSVFormat writes byte for byte what printf("%f,%d,%d,%d\n") gives for the
+ same samples, the text the exporter produced through stringWithFormat: before.
+ */
+
+#include "AccelerometerCSVFormat.h"
+#include "SessionSamples.h"
+#include <string.h>
+
+#define kCount	20000
+
+static uint64_t tick[kCount];
+static int16_t x[kCount], y[kCount], z[kCount];
+static char formatted[kCount * kAccelerometerCSVMaxLineLength], expected[kCount * kAccelerometerCSVMaxLineLength];
+
+static void CheckMatchesPrintf(const char *name, size_t count, uint64_t epochMicros)
+{
+	size_t length = AccelerometerCSVFormat(formatted, tick, x, y, z, count, epochMicros), expectedLength = 0, i;
+	
+	for(i = 0; i < count; ++i)
+	{
+		size_t line = (size_t)sprintf(expected + expectedLength, "%f,%d,%d,%d\n", (double)(epochMicros + tick[i]) / 1e6, x[i], y[i], z[i]);
+		
+		CHECK(line <= kAccelerometerCSVMaxLineLength, "%s: line %zu is %zu bytes", name, i, line);
+		expectedLength += line;
+	}
+	CHECK(length == expectedLength, "%s: %zu bytes, printf wrote %zu", name, length, expectedLength);
+	for(i = 0; i < length; ++i)
+		CHECK(formatted[i] == expected[i], "%s: byte %zu is '%c', printf wrote '%c'", name, i, formatted[i], expected[i]);
+}
+
+int main(void)
+{
+	static const int16_t edges[] = { 0, 1, -1, 9, 10, -10, 999, 1000, -1000, INT16_MAX, INT16_MIN, INT16_MIN + 1 };
+	static const uint64_t fractions[] = { 0, 1, 9, 10, 99999, 100000, 500000, 999999, 1000000, 1000001 };
+	const size_t edgeCount = sizeof(edges) / sizeof(edges[0]), fractionCount = sizeof(fractions) / sizeof(fractions[0]);
+	uint64_t seed = 77;
+	size_t i;
+	
+	MakeSession(&seed, tick, x, y, z, kCount);
+	CheckMatchesPrintf("session", kCount, 1760000000123456ull);
+	printf("an 800 Hz session matches printf\n");
+	
+	for(i = 0; i < edgeCount * fractionCount; ++i)
+	{
+		tick[i] = fractions[i % fractionCount];
+		x[i] = edges[i % edgeCount];
+		y[i] = edges[(i / edgeCount) % edgeCount];
+		z[i] = edges[(edgeCount - 1 - i % edgeCount)];
+	}
+	CheckMatchesPrintf("edges at epoch 0", edgeCount * fractionCount, 0);
+	CheckMatchesPrintf("edges", edgeCount * fractionCount, 1760000000000000ull);
+	printf("leading and trailing zeros, signs and int16 limits match printf\n");
+	
+	// Any time up to 2100, where a double still resolves microseconds.
+	for(i = 0; i < kCount; ++i)
+	{
+		tick[i] = TestRandom(&seed) % 4102444800000000ull;
+		x[i] = (int16_t)TestRandomRange(&seed, INT16_MIN, INT16_MAX);
+		y[i] = (int16_t)TestRandomRange(&seed, INT16_MIN, INT16_MAX);
+		z[i] = (int16_t)TestRandomRange(&seed, INT16_MIN, INT16_MAX);
+	}
+	CheckMatchesPrintf("random", kCount, 0);
+	printf("%d random samples match printf\n", kCount);
+	return 0;
+}
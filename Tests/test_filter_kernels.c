@@ -0,0 +1,435 @@
+/**
+ * test_filter_kernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Checks the block drivers and single sample steps in AccelerometerFilterKernels.c against the
+ per-sample recurrences of the original -[LowpassFilter addAcceleration:] and
+ -[HighpassFilter addAcceleration:], which are copied below. The one pole filters must match bit for
+ bit, the biquad cascade is compared against a direct form I evaluation within a tolerance and its
+ step against its block driver bit for bit. The designed magnitude responses are checked against the
+ analog prototypes: -3.01 dB at the cutoff and a monotonic passband for Butterworth, a ripple of
+ exactly rippleDB for Chebyshev and the prototype attenuation in the stopband for both.
+ */
+
+#include "AccelerometerFilterKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+#include <string.h>
+
+#define kSampleCount	5000
+
+static const double kPi = 3.14159265358979323846;
+
+typedef struct {
+	double x, y, z;
+	double lastX, lastY, lastZ;
+} ReferenceFilter;
+
+static void ReferenceLowpass(ReferenceFilter *f, double filterConstant, int adaptive, double ax, double ay, double az)
+{
+	double alpha = filterConstant;
+	
+	if(adaptive)
+	{
+		double d = Clamp(fabs(Norm(f->x, f->y, f->z) - Norm(ax, ay, az)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+		alpha = (1.0 - d) * filterConstant / kAccelerometerNoiseAttenuation + d * filterConstant;
+	}
+	
+	f->x = ax * alpha + f->x * (1.0 - alpha);
+	f->y = ay * alpha + f->y * (1.0 - alpha);
+	f->z = az * alpha + f->z * (1.0 - alpha);
+}
+
+static void ReferenceHighpass(ReferenceFilter *f, double filterConstant, int adaptive, double ax, double ay, double az)
+{
+	double alpha = filterConstant;
+	
+	if(adaptive)
+	{
+		double d = Clamp(fabs(Norm(f->x, f->y, f->z) - Norm(ax, ay, az)) / kAccelerometerMinStep - 1.0, 0.0, 1.0);
+		alpha = d * filterConstant / kAccelerometerNoiseAttenuation + (1.0 - d) * filterConstant;
+	}
+	
+	f->x = alpha * (f->x + ax - f->lastX);
+	f->y = alpha * (f->y + ay - f->lastY);
+	f->z = alpha * (f->z + az - f->lastZ);
+	
+	f->lastX = ax;
+	f->lastY = ay;
+	f->lastZ = az;
+}
+
+// A slow random walk around 1 g with occasional jumps, so the adaptive weight takes every value.
+static void MakeSamples(uint64_t *seed, int16_t *x, int16_t *y, int16_t *z, size_t count)
+{
+	int vx = 0, vy = 0, vz = 1000;
+	size_t i;
+	
+	for(i = 0; i < count; ++i)
+	{
+		int step = TestRandomRange(seed, 0, 99) < 5 ? 400 : 2;
+		vx += TestRandomRange(seed, -step, step);
+		vy += TestRandomRange(seed, -step, step);
+		vz += TestRandomRange(seed, -step, step);
+		vx = vx > 16000 ? 16000 : (vx < -16000 ? -16000 : vx);
+		vy = vy > 16000 ? 16000 : (vy < -16000 ? -16000 : vy);
+		vz = vz > 16000 ? 16000 : (vz < -16000 ? -16000 : vz);
+		x[i] = (int16_t)vx;
+		y[i] = (int16_t)vy;
+		z[i] = (int16_t)vz;
+	}
+}
+
+static void CheckOnePole(int highpass, AccelerometerAdaptiveMode adaptive, const int16_t *x, const int16_t *y, const int16_t *z)
+{
+	static int32_t x32[kSampleCount], y32[kSampleCount], z32[kSampleCount];
+	static double outX[kSampleCount], outY[kSampleCount], outZ[kSampleCount];
+	static double outX32[kSampleCount], outY32[kSampleCount], outZ32[kSampleCount];
+	double filterConstant = highpass ? 0.9 : 0.1;
+	AccelerometerFilterState state, state32, quiet, stepped;
+	ReferenceFilter reference;
+	size_t i, done, n;
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		x32[i] = x[i];
+		y32[i] = y[i];
+		z32[i] = z[i];
+	}
+	memset(&state, 0, sizeof(state));
+	memset(&state32, 0, sizeof(state32));
+	memset(&quiet, 0, sizeof(quiet));
+	memset(&stepped, 0, sizeof(stepped));
+	memset(&reference, 0, sizeof(reference));
+	
+	// Uneven call sizes, so blocks end at every kind of boundary.
+	for(done = 0; done < kSampleCount; done += n)
+	{
+		n = kSampleCount - done < 1 + done % 700 ? kSampleCount - done : 1 + done % 700;
+		if(highpass)
+		{
+			AccelerometerHighpassRun(&state, filterConstant, adaptive, x + done, y + done, z + done, outX + done, outY + done, outZ + done, n);
+			AccelerometerHighpassRun32(&state32, filterConstant, adaptive, x32 + done, y32 + done, z32 + done, outX32 + done, outY32 + done, outZ32 + done, n);
+			AccelerometerHighpassRun(&quiet, filterConstant, adaptive, x + done, y + done, z + done, NULL, NULL, NULL, n);
+		}
+		else
+		{
+			AccelerometerLowpassRun(&state, filterConstant, adaptive, x + done, y + done, z + done, outX + done, outY + done, outZ + done, n);
+			AccelerometerLowpassRun32(&state32, filterConstant, adaptive, x32 + done, y32 + done, z32 + done, outX32 + done, outY32 + done, outZ32 + done, n);
+			AccelerometerLowpassRun(&quiet, filterConstant, adaptive, x + done, y + done, z + done, NULL, NULL, NULL, n);
+		}
+	}
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		if(highpass)
+		{
+			ReferenceHighpass(&reference, filterConstant, adaptive, x[i], y[i], z[i]);
+			AccelerometerHighpassStep(&stepped, filterConstant, adaptive, x[i], y[i], z[i]);
+		}
+		else
+		{
+			ReferenceLowpass(&reference, filterConstant, adaptive, x[i], y[i], z[i]);
+			AccelerometerLowpassStep(&stepped, filterConstant, adaptive, x[i], y[i], z[i]);
+		}
+		CHECK(outX[i] == reference.x && outY[i] == reference.y && outZ[i] == reference.z,
+			  "%s adaptive %d sample %zu: %.17g %.17g %.17g, expected %.17g %.17g %.17g", highpass ? "highpass" : "lowpass",
+			  adaptive, i, outX[i], outY[i], outZ[i], reference.x, reference.y, reference.z);
+		CHECK(outX32[i] == outX[i] && outY32[i] == outY[i] && outZ32[i] == outZ[i], "int32 driver differs at sample %zu", i);
+		CHECK(stepped.x == outX[i] && stepped.y == outY[i] && stepped.z == outZ[i], "step differs at sample %zu", i);
+	}
+	CHECK(memcmp(&state, &quiet, sizeof(state)) == 0, "running without outputs ends in a different state");
+	CHECK(memcmp(&state, &stepped, sizeof(state)) == 0, "stepping ends in a different state");
+	CHECK(state.x == reference.x && state.lastX == x[kSampleCount - 1], "final state does not match");
+}
+
+/*
+ One sample from a filter output placed right at the thresholds of the adaptive weight, where the
+ squared comparisons of AccelerometerAdaptiveFast could round the other way than the exact formula.
+ */
+static void CheckAdaptiveThresholds(uint64_t *seed)
+{
+	static const double steps[] = { -2.0, -1.0, 1.0, 2.0 };
+	int trial, highpass;
+	
+	for(trial = 0; trial < 200000; ++trial)
+	{
+		int16_t ax = (int16_t)TestRandomRange(seed, -2000, 2000), ay = (int16_t)TestRandomRange(seed, -2000, 2000);
+		int16_t az = (int16_t)TestRandomRange(seed, -2000, 2000);
+		double b = Norm(ax, ay, az);
+		// Within a few ulps of the threshold, or a little further out now and then.
+		double jitter = (TestRandomRange(seed, -1000, 1000) * 1e-16 + (trial % 7 == 0 ? TestRandomRange(seed, -100, 100) * 1e-11 : 0.0)) * (1.0 + b);
+		double a = b + steps[trial % 4] * kAccelerometerMinStep + jitter;
+		double scale = b > 0.0 ? a / b : 0.0;
+		
+		if(a < 0.0 || b == 0.0)
+			continue;
+		for(highpass = 0; highpass < 2; ++highpass)
+		{
+			AccelerometerFilterState exact = { ax * scale, ay * scale, az * scale, 3.0, -5.0, 7.0 };
+			AccelerometerFilterState fast = exact;
+			double exactOut[3], fastOut[3];
+			
+			if(highpass)
+			{
+				AccelerometerHighpassRun(&exact, 0.9, AccelerometerAdaptiveExact, &ax, &ay, &az, &exactOut[0], &exactOut[1], &exactOut[2], 1);
+				AccelerometerHighpassRun(&fast, 0.9, AccelerometerAdaptiveFast, &ax, &ay, &az, &fastOut[0], &fastOut[1], &fastOut[2], 1);
+			}
+			else
+			{
+				AccelerometerLowpassRun(&exact, 0.1, AccelerometerAdaptiveExact, &ax, &ay, &az, &exactOut[0], &exactOut[1], &exactOut[2], 1);
+				AccelerometerLowpassRun(&fast, 0.1, AccelerometerAdaptiveFast, &ax, &ay, &az, &fastOut[0], &fastOut[1], &fastOut[2], 1);
+			}
+			CHECK(memcmp(exactOut, fastOut, sizeof(exactOut)) == 0, "%s at |a| - |b| = %.17g: fast %.17g, exact %.17g",
+				  highpass ? "highpass" : "lowpass", a - b, fastOut[0], exactOut[0]);
+		}
+	}
+}
+
+static void CheckBiquad(unsigned order, AccelerometerBiquadResponse response, double rippleDB,
+						const int16_t *x, const int16_t *y, const int16_t *z)
+{
+	static double outX[kSampleCount], outY[kSampleCount], outZ[kSampleCount];
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	AccelerometerBiquadState states[kAccelerometerBiquadMaxSections], steppedStates[kAccelerometerBiquadMaxSections];
+	double history[kAccelerometerBiquadMaxSections][3][4];
+	AccelerometerFilterState state, stepped;
+	size_t count, i, k;
+	int axis;
+	
+	count = AccelerometerBiquadDesign(sections, order, response, 800.0, 25.0, rippleDB);
+	CHECK(count == (order + 1) / 2, "order %u designed %zu sections", order, count);
+	memset(states, 0, sizeof(states));
+	memset(steppedStates, 0, sizeof(steppedStates));
+	memset(history, 0, sizeof(history));
+	memset(&state, 0, sizeof(state));
+	memset(&stepped, 0, sizeof(stepped));
+	AccelerometerBiquadRun(sections, states, count, &state, x, y, z, outX, outY, outZ, 1000);
+	AccelerometerBiquadRun(sections, states, count, &state, x + 1000, y + 1000, z + 1000, outX + 1000, outY + 1000, outZ + 1000, kSampleCount - 1000);
+	
+	for(i = 0; i < kSampleCount; ++i)
+	{
+		double v[3] = { x[i], y[i], z[i] };
+		const double *out[3] = { outX, outY, outZ };
+		
+		for(k = 0; k < count; ++k)
+		{
+			for(axis = 0; axis < 3; ++axis)
+			{
+				// Direct form I, history holds x[n-1], x[n-2], y[n-1], y[n-2].
+				double *h = history[k][axis];
+				double o = sections[k].b0 * v[axis] + sections[k].b1 * h[0] + sections[k].b2 * h[1] - sections[k].a1 * h[2] - sections[k].a2 * h[3];
+				h[1] = h[0];
+				h[0] = v[axis];
+				h[3] = h[2];
+				h[2] = o;
+				v[axis] = o;
+			}
+		}
+		for(axis = 0; axis < 3; ++axis)
+			CHECK(fabs(out[axis][i] - v[axis]) <= 1e-9 * (1.0 + fabs(v[axis])),
+				  "order %u response %d ripple %g sample %zu axis %d: %.17g, expected %.17g", order, response, rippleDB, i, axis, out[axis][i], v[axis]);
+		AccelerometerBiquadStep(sections, steppedStates, count, &stepped, x[i], y[i], z[i]);
+		CHECK(stepped.x == outX[i] && stepped.y == outY[i] && stepped.z == outZ[i], "order %u biquad step differs at sample %zu", order, i);
+	}
+	CHECK(state.x == outX[kSampleCount - 1], "biquad state does not hold the last output");
+}
+
+// Gain of the cascade in dB at frequency f, evaluated on the unit circle section by section.
+static double ResponseDB(const AccelerometerBiquad *sections, size_t count, double rate, double f)
+{
+	double w = 2.0 * kPi * f / rate, c1 = cos(w), s1 = sin(w), c2 = cos(2.0 * w), s2 = sin(2.0 * w);
+	double gain = 0.0;
+	size_t k;
+	
+	for(k = 0; k < count; ++k)
+	{
+		const AccelerometerBiquad *c = &sections[k];
+		double numRe = c->b0 + c->b1 * c1 + c->b2 * c2, numIm = -c->b1 * s1 - c->b2 * s2;
+		double denRe = 1.0 + c->a1 * c1 + c->a2 * c2, denIm = -c->a1 * s1 - c->a2 * s2;
+		gain += 10.0 * log10((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+	}
+	return gain;
+}
+
+/*
+ Gain of the analog prototype in dB. The bilinear transform maps f to the prototype frequency
+ tan(pi f / rate) / tan(pi cutoff / rate), inverted for highpass, so the digital design must match
+ the prototype exactly at every frequency.
+ */
+static double PrototypeDB(unsigned order, AccelerometerBiquadResponse response, double rippleDB, double rate, double cutoff, double f)
+{
+	double omega = tan(kPi * f / rate) / tan(kPi * cutoff / rate);
+	double epsilonSquared = 1.0, t;
+	
+	if(response == AccelerometerBiquadHighpass)
+		omega = 1.0 / omega;
+	if(rippleDB <= 0.0)
+		return -10.0 * log10(1.0 + pow(omega, 2.0 * order));
+	epsilonSquared = pow(10.0, rippleDB / 10.0) - 1.0;
+	t = omega <= 1.0 ? cos(order * acos(omega)) : cosh(order * acosh(omega));
+	return -10.0 * log10(1.0 + epsilonSquared * t * t);
+}
+
+static void CheckResponse(unsigned order, AccelerometerBiquadResponse response, double rippleDB)
+{
+	const double rate = 800.0, cutoff = 25.0;
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	double previous = 0.0, highest = -INFINITY, lowest = INFINITY, atCutoff;
+	size_t count;
+	int i;
+	
+	count = AccelerometerBiquadDesign(sections, order, response, rate, cutoff, rippleDB);
+	atCutoff = ResponseDB(sections, count, rate, cutoff);
+	if(rippleDB <= 0.0)
+		CHECK(fabs(atCutoff + 3.0103) < 1e-3, "butterworth order %u response %d is %.4f dB at the cutoff", order, response, atCutoff);
+	else
+		CHECK(fabs(atCutoff + rippleDB) < 1e-3, "chebyshev order %u response %d is %.4f dB at the cutoff", order, response, atCutoff);
+	
+	// Passband from the far end in towards the cutoff.
+	for(i = 0; i <= 2000; ++i)
+	{
+		double f = response == AccelerometerBiquadLowpass ? cutoff * i / 2000.0 : cutoff + (rate / 2.0 - 1e-6 - cutoff) * (2000 - i) / 2000.0;
+		double gain = ResponseDB(sections, count, rate, f);
+		
+		if(rippleDB <= 0.0 && i > 0)
+			CHECK(gain <= previous + 1e-9, "butterworth order %u response %d passband rises to %.6f dB at %g Hz", order, response, gain, f);
+		CHECK(fabs(gain - PrototypeDB(order, response, rippleDB, rate, cutoff, f)) < 1e-6,
+			  "order %u response %d ripple %g: %.6f dB at %g Hz, prototype %.6f dB", order, response, rippleDB, gain, f,
+			  PrototypeDB(order, response, rippleDB, rate, cutoff, f));
+		previous = gain;
+		highest = fmax(highest, gain);
+		lowest = fmin(lowest, gain);
+	}
+	CHECK(highest < 1e-9 && highest > -1e-3, "order %u response %d ripple %g passband peaks at %.6f dB", order, response, rippleDB, highest);
+	if(rippleDB > 0.0)
+		CHECK(fabs(lowest + rippleDB) < 1e-3, "chebyshev order %u response %d ripples down to %.6f dB", order, response, lowest);
+	
+	// Stopband at a factor of two and four from the cutoff.
+	for(i = 1; i <= 2; ++i)
+	{
+		double f = response == AccelerometerBiquadLowpass ? cutoff * (2 << i) / 2.0 : cutoff / (2 << i) * 2.0;
+		double gain = ResponseDB(sections, count, rate, f);
+		double expected = PrototypeDB(order, response, rippleDB, rate, cutoff, f);
+		// Butterworth falls faster than its asymptote of 20 order dB per decade, Chebyshev at least below its ripple.
+		double omega = tan(kPi * f / rate) / tan(kPi * cutoff / rate);
+		double asymptote = rippleDB <= 0.0 ? 20.0 * order * log10(response == AccelerometerBiquadLowpass ? omega : 1.0 / omega) : rippleDB;
+		
+		CHECK(fabs(gain - expected) < 1e-6 * (1.0 - expected), "order %u response %d ripple %g: %.6f dB at %g Hz, prototype %.6f dB",
+			  order, response, rippleDB, gain, f, expected);
+		CHECK(gain < -asymptote, "order %u response %d ripple %g attenuates only %.2f dB at %g Hz", order, response, rippleDB, -gain, f);
+	}
+}
+
+static void CheckFiltfiltSettled(void)
+{
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	double samples[300];
+	size_t count, i;
+	
+	count = AccelerometerBiquadDesign(sections, 4, AccelerometerBiquadLowpass, 800.0, 25.0, 0.0);
+	for(i = 0; i < 300; ++i)
+		samples[i] = 1000.0;
+	AccelerometerBiquadFiltfilt(sections, count, samples, 300);
+	for(i = 0; i < 300; ++i)
+		CHECK(fabs(samples[i] - 1000.0) < 1e-6, "constant input moved to %.17g at %zu", samples[i], i);
+}
+
+static void CheckSettle(AccelerometerBiquadResponse response)
+{
+	AccelerometerBiquad sections[kAccelerometerBiquadMaxSections];
+	AccelerometerBiquadState states[kAccelerometerBiquadMaxSections];
+	AccelerometerFilterState state;
+	int16_t x[300], y[300], z[300];
+	double outX[300], outY[300], outZ[300];
+	double gain = response == AccelerometerBiquadLowpass ? 1.0 : 0.0;
+	size_t count, i;
+	
+	count = AccelerometerBiquadDesign(sections, 5, response, 800.0, 25.0, 0.0);
+	for(i = 0; i < 300; ++i)
+	{
+		x[i] = 1000;
+		y[i] = -500;
+		z[i] = 0;
+	}
+	AccelerometerBiquadSettle(sections, states, count, 1000.0, -500.0, 0.0);
+	AccelerometerBiquadRun(sections, states, count, &state, x, y, z, outX, outY, outZ, 300);
+	for(i = 0; i < 300; ++i)
+	{
+		CHECK(fabs(outX[i] - 1000.0 * gain) < 1e-6 && fabs(outY[i] + 500.0 * gain) < 1e-6 && fabs(outZ[i]) < 1e-6,
+			  "response %d settled run moved to %.17g, %.17g, %.17g at %zu", response, outX[i], outY[i], outZ[i], i);
+	}
+}
+
+int main(void)
+{
+	static int16_t x[kSampleCount], y[kSampleCount], z[kSampleCount];
+	uint64_t seed = 0x9E3779B97F4A7C15ull;
+	unsigned order;
+	int highpass;
+	
+	MakeSamples(&seed, x, y, z, kSampleCount);
+	for(highpass = 0; highpass < 2; ++highpass)
+	{
+		CheckOnePole(highpass, AccelerometerAdaptiveOff, x, y, z);
+		CheckOnePole(highpass, AccelerometerAdaptiveExact, x, y, z);
+		CheckOnePole(highpass, AccelerometerAdaptiveFast, x, y, z);
+	}
+	printf("one pole filters and their steps bit-exact with the per-sample recurrences\n");
+	
+	CheckAdaptiveThresholds(&seed);
+	printf("squared magnitude adaptive mode bit-exact at the thresholds\n");
+	
+	for(order = 1; order <= kAccelerometerBiquadMaxOrder; ++order)
+	{
+		CheckBiquad(order, AccelerometerBiquadLowpass, 0.0, x, y, z);
+		CheckBiquad(order, AccelerometerBiquadHighpass, 0.0, x, y, z);
+		CheckBiquad(order, AccelerometerBiquadLowpass, 0.5, x, y, z);
+		CheckResponse(order, AccelerometerBiquadLowpass, 0.0);
+		CheckResponse(order, AccelerometerBiquadHighpass, 0.0);
+		CheckResponse(order, AccelerometerBiquadLowpass, 0.5);
+		CheckResponse(order, AccelerometerBiquadHighpass, 0.5);
+		CheckResponse(order, AccelerometerBiquadLowpass, 1.0);
+	}
+	CHECK(AccelerometerBiquadDesign(NULL, 0, AccelerometerBiquadLowpass, 800.0, 25.0, 0.0) == 0, "order 0 accepted");
+	CHECK(AccelerometerBiquadDesign(NULL, 2, AccelerometerBiquadLowpass, 800.0, 400.0, 0.0) == 0, "cutoff at Nyquist accepted");
+	printf("biquad cascades match direct form I and their prototypes, steps match blocks\n");
+	
+	CheckFiltfiltSettled();
+	CheckSettle(AccelerometerBiquadLowpass);
+	CheckSettle(AccelerometerBiquadHighpass);
+	printf("filtfilt and settled causal runs start settled\n");
+	return 0;
+}
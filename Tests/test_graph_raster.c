@@ -0,0 +1,239 @@
+/**
+ * test_graph_raster.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Golden images for APLGraphRaster. Small scenes are spelled out pixel by pixel, one character per
+ color, so a failure shows exactly which pixels moved. A full segment drawn the way -displayLayer:
+ draws it is compared by hash, the hash being that of the reviewed output.
+ */
+
+#include "APLGraphRaster.h"
+#include "TestSupport.h"
+#include <string.h>
+
+#define kSegmentWidth	32
+#define kSegmentHeight	112
+#define kSegmentHash	0x1ce9c9c75854914dULL
+
+static const struct {
+	char symbol;
+	uint8_t r, g, b;
+} palette[] = {
+	{ '.', 0, 0, 0 },
+	{ '-', 64, 64, 64 },
+	{ '#', 255, 0, 0 },
+	{ '|', 0, 0, 255 },
+};
+
+static uint32_t Color(char symbol)
+{
+	size_t i;
+	
+	for(i = 0; i < sizeof(palette) / sizeof(palette[0]); i++)
+	{
+		if(palette[i].symbol == symbol)
+			return APLGraphRasterColor(palette[i].r, palette[i].g, palette[i].b, 255);
+	}
+	CHECK(0, "no color for '%c'", symbol);
+	return 0;
+}
+
+static char Symbol(uint32_t color)
+{
+	size_t i;
+	
+	for(i = 0; i < sizeof(palette) / sizeof(palette[0]); i++)
+	{
+		if(APLGraphRasterColor(palette[i].r, palette[i].g, palette[i].b, 255) == color)
+			return palette[i].symbol;
+	}
+	return '?';
+}
+
+static void CheckImage(const char *name, const APLGraphRaster *raster, const char *const *golden)
+{
+	size_t x, y;
+	
+	for(y = 0; y < raster->height; y++)
+	{
+		for(x = 0; x < raster->width; x++)
+		{
+			char actual = Symbol(raster->pixels[y * raster->stride + x]);
+			if(actual != golden[y][x])
+			{
+				for(y = 0; y < raster->height; y++)
+				{
+					for(x = 0; x < raster->width; x++)
+						fputc(Symbol(raster->pixels[y * raster->stride + x]), stderr);
+					fprintf(stderr, "    %s\n", golden[y]);
+				}
+				CHECK(0, "%s differs from the golden image, drawn on the left", name);
+			}
+		}
+	}
+	printf("  %s matches\n", name);
+}
+
+static void CheckPrimitives(void)
+{
+	static const char *const golden[] = {
+		"#.......",
+		"#..#..|.",
+		"##-#--|.",
+		".#.#..|.",
+		".#.#..|.",
+		".###....",
+	};
+	static const float ys[] = { 0.0f, 2.0f, 5.0f, 5.0f, 1.0f };
+	uint32_t pixels[8 * 6];
+	APLGraphRaster raster = { pixels, 8, 6, 8 };
+	
+	APLGraphRasterFill(&raster, Color('.'));
+	APLGraphRasterHorizontalLine(&raster, 2.5, 1, 7, Color('-'));
+	APLGraphRasterPolyline(&raster, ys, 5, Color('#'));
+	APLGraphRasterVerticalLine(&raster, 6, 4.9, 1.2, Color('|'));
+	CheckImage("primitives", &raster, golden);
+}
+
+static void CheckClipping(void)
+{
+	static const char *const golden[] = {
+		"#.##.|",
+		"####..",
+		"##.#..",
+		"##....",
+	};
+	static const float ys[] = { -3.0f, 10.0f, 1.5f, -1.0f, 2.0f };
+	uint32_t pixels[6 * 4];
+	APLGraphRaster raster = { pixels, 6, 4, 6 };
+	
+	APLGraphRasterFill(&raster, Color('.'));
+	APLGraphRasterHorizontalLine(&raster, -0.5, 0, 6, Color('-'));
+	APLGraphRasterHorizontalLine(&raster, 4.0, 0, 6, Color('-'));
+	APLGraphRasterPolyline(&raster, ys, 5, Color('#'));
+	APLGraphRasterVerticalLine(&raster, 9, 0.0, 3.0, Color('|'));
+	APLGraphRasterVerticalLine(&raster, 5, 10.0, 20.0, Color('|'));
+	APLGraphRasterVerticalLine(&raster, 5, -5.0, 0.2, Color('|'));
+	CheckImage("clipping", &raster, golden);
+}
+
+// Drawing into a window of a larger buffer leaves the pixels around it alone.
+static void CheckStride(void)
+{
+	static const char *const golden[] = {
+		"----",
+		"-#|-",
+		"-#|-",
+		"----",
+	};
+	static const float ys[] = { -10.0f, 10.0f, 10.0f, 10.0f };
+	uint32_t pixels[4 * 4];
+	APLGraphRaster outer = { pixels, 4, 4, 4 };
+	APLGraphRaster inner = { pixels + 4 + 1, 2, 2, 4 };
+	
+	APLGraphRasterFill(&outer, Color('-'));
+	APLGraphRasterFill(&inner, Color('.'));
+	APLGraphRasterPolyline(&inner, ys, 4, Color('#'));
+	APLGraphRasterVerticalLine(&inner, 1, -100.0, 100.0, Color('|'));
+	APLGraphRasterHorizontalLine(&inner, 0.0, 2, 10, Color('#'));
+	CheckImage("stride", &outer, golden);
+}
+
+// FNV-1a over the bytes, which are R, G, B, A whatever the byte order of the machine.
+static uint64_t Hash(const APLGraphRaster *raster)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	size_t y, i;
+	
+	for(y = 0; y < raster->height; y++)
+	{
+		const uint8_t *bytes = (const uint8_t *)(raster->pixels + y * raster->stride);
+		for(i = 0; i < raster->width * sizeof(uint32_t); i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ULL;
+		}
+	}
+	return hash;
+}
+
+// Background, grid and three channels of min, max and bars like -displayLayer:.
+static void DrawSegment(APLGraphRaster *raster, uint64_t seed)
+{
+	float rows[2 * 3][kSegmentWidth + 1];
+	const double half = kSegmentHeight / 2.0;
+	size_t channel, i;
+	double y;
+	
+	APLGraphRasterFill(raster, Color('.'));
+	for(y = -(half - 8.0) - 0.5; y <= half - 8.0 + 0.5; y += 16.0)
+		APLGraphRasterHorizontalLine(raster, y + half, 0, kSegmentWidth, Color('-'));
+	for(channel = 0; channel < 3; channel++)
+	{
+		for(i = 0; i <= kSegmentWidth; i++)
+		{
+			// Tenths of a row, exact in float, reaching past both edges.
+			float a = TestRandomRange(&seed, -200, 10 * kSegmentHeight + 200) / 10.0f;
+			float b = TestRandomRange(&seed, -200, 10 * kSegmentHeight + 200) / 10.0f;
+			rows[channel][i] = a < b ? b : a;
+			rows[3 + channel][i] = a < b ? a : b;
+		}
+		APLGraphRasterPolyline(raster, rows[channel], kSegmentWidth + 1, Color(channel == 1 ? '|' : '#'));
+		APLGraphRasterPolyline(raster, rows[3 + channel], kSegmentWidth + 1, Color(channel == 1 ? '|' : '#'));
+		for(i = 0; i <= kSegmentWidth; i++)
+			APLGraphRasterVerticalLine(raster, i < kSegmentWidth ? i : kSegmentWidth - 1, rows[3 + channel][i], rows[channel][i], Color('#'));
+	}
+}
+
+static void CheckSegment(void)
+{
+	static uint32_t pixels[kSegmentWidth * kSegmentHeight];
+	APLGraphRaster raster = { pixels, kSegmentWidth, kSegmentHeight, kSegmentWidth };
+	uint64_t hash;
+	
+	DrawSegment(&raster, 0x5e9ULL);
+	hash = Hash(&raster);
+	CHECK(hash == kSegmentHash, "segment hash %016llx, golden %016llx", (unsigned long long)hash, (unsigned long long)kSegmentHash);
+	printf("  segment matches\n");
+}
+
+int main(void)
+{
+	CheckPrimitives();
+	CheckClipping();
+	CheckStride();
+	CheckSegment();
+	return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * test_log_cursor.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerLogCursor: overlapping downloads are cut after the journal tail, ties are counted, and
+ downloads whose clock went back are kept instead of thrown away.
+ */
+
+#include "AccelerometerLogCursor.h"
+#include "TestSupport.h"
+
+#define kEntries	20000
+
+static double board[kEntries];
+static double journal[kEntries];
+
+static AccelerometerLogCursor CursorOf(const double *times, size_t count)
+{
+	AccelerometerLogCursor cursor = AccelerometerLogCursorEmpty;
+	
+	AccelerometerLogCursorAdvance(&cursor, times, count);
+	return cursor;
+}
+
+static void CheckOverlap(void)
+{
+	double log[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	AccelerometerLogCursor cursor = CursorOf(log, 5);
+	
+	CHECK(AccelerometerLogCursorFirstNew(&AccelerometerLogCursorEmpty, log, 8) == 0, "empty journal skipped entries");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, log, 8) == 5, "overlap not cut at the cursor");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, log + 3, 5) == 2, "partial overlap not cut at the cursor");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, log + 5, 3) == 0, "erased log lost entries");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, log, 5) == 5, "repeated download not dropped");
+	printf("  overlap cut after the journal tail\n");
+}
+
+static void CheckTies(void)
+{
+	double stored[] = { 8, 9, 10, 10 };
+	double download[] = { 9, 10, 10, 10, 11 };
+	double start[] = { 10, 11 };
+	AccelerometerLogCursor cursor = CursorOf(stored, 4);
+	
+	CHECK(cursor.count == 4 && cursor.time == 10 && cursor.ties == 2, "cursor %g with %zu ties", cursor.time, cursor.ties);
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, download, 5) == 3, "third entry at the cursor time not new");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, start, 2) == 1, "download starting inside the ties");
+	
+	// A batch only at the cursor time adds to its ties.
+	AccelerometerLogCursorAdvance(&cursor, download + 3, 1);
+	CHECK(cursor.count == 5 && cursor.time == 10 && cursor.ties == 3, "ties %zu after another entry at 10", cursor.ties);
+	AccelerometerLogCursorAdvance(&cursor, download + 4, 1);
+	CHECK(cursor.count == 6 && cursor.time == 11 && cursor.ties == 1, "ties %zu after moving on", cursor.ties);
+	printf("  ties at the cursor counted\n");
+}
+
+static void CheckRegression(void)
+{
+	double stored[] = { 100, 101, 102 };
+	double reset[] = { 3, 4, 5 };
+	double corrected[] = { 99.5, 100.5, 101.5, 102.5 };
+	double inside[] = { 100, 101, 102, 103, 1, 2, 3 };
+	double again[] = { 100, 101, 102, 103, 1, 2, 3, 4, 5 };
+	AccelerometerLogCursor cursor = CursorOf(stored, 3);
+	
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, reset, 3) == 0, "entries before the cursor after a reset dropped");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, corrected, 4) == 0, "restamped download without the cursor cut");
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, inside, 7) == 3, "reset inside the download");
+	
+	// The journal now ends in the run after the reset, the cursor is found there and not in the first run.
+	AccelerometerLogCursorAdvance(&cursor, inside + 3, 4);
+	CHECK(cursor.count == 7 && cursor.time == 3 && cursor.ties == 1, "cursor %g after the reset", cursor.time);
+	CHECK(AccelerometerLogCursorFirstNew(&cursor, again, 9) == 7, "cursor looked for in the wrong run");
+	printf("  clock going back keeps the new entries\n");
+}
+
+// A board logging at random with ties and now and then a reset that restarts its clock below the
+// journal, downloaded at random points with a random part of the journal still on it. Whatever the
+// downloads overlap, the journal ends up holding the log exactly once.
+static void CheckRandomSyncs(void)
+{
+	uint64_t seed = 7;
+	size_t logged = 0, stored = 0;
+	double now = 1000.0;
+	AccelerometerLogCursor cursor = AccelerometerLogCursorEmpty;
+	
+	while(logged < kEntries)
+	{
+		size_t burst = (size_t)TestRandomRange(&seed, 1, 400);
+		if(burst > kEntries - logged)
+			burst = kEntries - logged;
+		if(TestRandomRange(&seed, 0, 9) == 0 && stored == logged)
+			now = TestRandomRange(&seed, 0, 999) / 10.0;
+		for(size_t i = 0; i < burst; i++)
+		{
+			now += TestRandomRange(&seed, 0, 3) ? 1.0 : 0.0;
+			board[logged++] = now;
+		}
+		
+		// The board still holds a random amount of what was downloaded before, but a first new entry
+		// at the cursor time cannot be told apart from the journal, so it holds all the ties then.
+		size_t kept = stored - (size_t)TestRandomRange(&seed, 0, (int)(stored < 50 ? stored : 50));
+		if(stored && kept > stored - cursor.ties && (kept < stored || board[stored] == cursor.time))
+			kept = stored - cursor.ties;
+		size_t first = AccelerometerLogCursorFirstNew(&cursor, board + kept, logged - kept);
+		CHECK(kept + first == stored, "download from %zu kept %zu new entries past %zu stored", kept, logged - kept - first, stored);
+		for(size_t i = kept + first; i < logged; i++)
+			journal[stored++] = board[i];
+		AccelerometerLogCursorAdvance(&cursor, board + kept + first, logged - kept - first);
+		CHECK(cursor.count == stored, "cursor counts %zu of %zu", cursor.count, stored);
+	}
+	for(size_t i = 0; i < kEntries; i++)
+		CHECK(journal[i] == board[i], "journal entry %zu is %g, logged %g", i, journal[i], board[i]);
+	printf("  %d entries journaled once over random downloads\n", kEntries);
+}
+
+int main(void)
+{
+	CheckOverlap();
+	CheckTies();
+	CheckRegression();
+	CheckRandomSyncs();
+	return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * test_log_decoder.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerLogDecodeInt16x3 against known payloads and, on random bytes, against the scalar
+ loop. The Makefile builds this once as is and, on x86, once more with SSSE3 so both the fallback
+ and the shuffle path are checked; on ARM the NEON path is the default build.
+ */
+
+#include "AccelerometerLogDecoder.h"
+#include "TestSupport.h"
+#include <string.h>
+
+#define kMaxCount	1000
+#define kTrials		20000
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && defined(__LITTLE_ENDIAN__)
+#define kVectorPath "NEON"
+#elif defined(__SSSE3__)
+#define kVectorPath "SSSE3"
+#else
+#define kVectorPath "none"
+#endif
+
+// Little endian words covering both signs and both extremes.
+static void CheckKnown(void)
+{
+	static const uint8_t payloads[] = {
+		0x10, 0x00, 0xf0, 0xff, 0x00, 0x04,
+		0xff, 0x7f, 0x00, 0x80, 0x00, 0x00,
+		0x34, 0x12, 0xcc, 0xed, 0x01, 0xfc,
+	};
+	static const int16_t expected[3][3] = {
+		{ 16, -16, 1024 },
+		{ 32767, -32768, 0 },
+		{ 0x1234, -0x1234, -1023 },
+	};
+	int16_t x[3], y[3], z[3];
+	int i;
+	
+	AccelerometerLogDecodeInt16x3(payloads, 3, x, y, z);
+	for(i = 0; i < 3; i++)
+	{
+		CHECK(x[i] == expected[i][0] && y[i] == expected[i][1] && z[i] == expected[i][2],
+			  "sample %d decoded as %d, %d, %d", i, x[i], y[i], z[i]);
+	}
+	printf("  known payloads decode\n");
+}
+
+// Random lengths, contents and alignments of both input and output, with guards around the outputs.
+static void CheckRandom(void)
+{
+	static uint8_t src[kMaxCount * kAccelerometerLogPayloadSize + 16];
+	static int16_t x[kMaxCount + 16], y[kMaxCount + 16], z[kMaxCount + 16];
+	static int16_t ex[kMaxCount], ey[kMaxCount], ez[kMaxCount];
+	uint64_t seed = 0xdec0deULL;
+	int trial;
+	
+	for(trial = 0; trial < kTrials; trial++)
+	{
+		size_t count = (size_t)TestRandomRange(&seed, 0, trial < 100 ? 40 : kMaxCount);
+		size_t offset = (size_t)TestRandomRange(&seed, 0, 15), outset = (size_t)TestRandomRange(&seed, 0, 7);
+		size_t i;
+		
+		for(i = 0; i < sizeof(src); i++)
+			src[i] = (uint8_t)TestRandom(&seed);
+		memset(x, 0x5a, sizeof(x));
+		memset(y, 0x5a, sizeof(y));
+		memset(z, 0x5a, sizeof(z));
+		
+		AccelerometerLogDecodeInt16x3Scalar(src + offset, count, ex, ey, ez);
+		AccelerometerLogDecodeInt16x3(src + offset, count, x + outset, y + outset, z + outset);
+		CHECK(!memcmp(x + outset, ex, count * sizeof(int16_t)) && !memcmp(y + outset, ey, count * sizeof(int16_t)) &&
+			  !memcmp(z + outset, ez, count * sizeof(int16_t)), "trial %d, %zu samples at offset %zu differ from scalar", trial, count, offset);
+		for(i = 0; i < outset; i++)
+			CHECK(x[i] == 0x5a5a && y[i] == 0x5a5a && z[i] == 0x5a5a, "trial %d wrote before the output", trial);
+		for(i = outset + count; i < kMaxCount + 16; i++)
+			CHECK(x[i] == 0x5a5a && y[i] == 0x5a5a && z[i] == 0x5a5a, "trial %d wrote past the output", trial);
+	}
+	printf("  %d random batches match the scalar loop\n", kTrials);
+}
+
+int main(void)
+{
+	printf("  vector path: %s\n", kVectorPath);
+	CheckKnown();
+	CheckRandom();
+	return 0;
+}
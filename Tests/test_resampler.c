@@ -0,0 +1,232 @@
+/**
+ * test_resampler.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerResamplerKernels: a sine comes out at the right value on the output grid when up and
+ downsampling, a constant keeps its level up to the last output after finishing, the input can be
+ split anywhere without changing a bit of the output, and a long stream runs in bounded memory.
+ */
+
+#include "AccelerometerResamplerKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+#include <string.h>
+
+#define kInputRate	800.0
+#define kMaxOutputs	40000
+
+static const double kPi = 3.14159265358979323846;
+
+static float inX[kMaxOutputs], inY[kMaxOutputs], inZ[kMaxOutputs];
+static uint64_t ticks[kMaxOutputs];
+static float outX[kMaxOutputs], outY[kMaxOutputs], outZ[kMaxOutputs];
+static float chunkedX[kMaxOutputs], chunkedY[kMaxOutputs], chunkedZ[kMaxOutputs];
+
+// Collect every ready output into x, y, z from *count on, checking the grid stays contiguous.
+static void Drain(AccelerometerResamplerState *state, float *x, float *y, float *z, size_t *count, int64_t *firstIndex)
+{
+	int64_t first;
+	size_t n;
+	
+	while((n = AccelerometerResamplerProduce(state, x + *count, y + *count, z + *count, 100, &first)) > 0)
+	{
+		if(*count == 0)
+			*firstIndex = first;
+		CHECK(first == *firstIndex + (int64_t)*count, "grid index %lld after %zu outputs from %lld", (long long)first, *count, (long long)*firstIndex);
+		*count += n;
+		CHECK(*count + 100 <= kMaxOutputs, "too many outputs");
+	}
+}
+
+// Add count samples in chunks of at most chunk, draining after each, then finish.
+static size_t Resample(AccelerometerResamplerState *state, size_t count, size_t chunk, uint64_t *seed,
+					   float *x, float *y, float *z, int64_t *firstIndex)
+{
+	size_t done = 0, outputs = 0;
+	
+	while(done < count)
+	{
+		size_t n = chunk ? (size_t)TestRandomRange(seed, 1, (int)chunk) : count - done;
+		if(n > count - done)
+			n = count - done;
+		while(n)
+		{
+			size_t taken = AccelerometerResamplerAdd(state, inX + done, inY + done, inZ + done, ticks + done, n);
+			CHECK(taken > 0, "history could not grow");
+			done += taken;
+			n -= taken;
+			Drain(state, x, y, z, &outputs, firstIndex);
+		}
+	}
+	AccelerometerResamplerFinish(state);
+	Drain(state, x, y, z, &outputs, firstIndex);
+	return outputs;
+}
+
+static void CheckSine(double outputRate)
+{
+	const AccelerometerTimebase timebase = { 0.0, 1.0 };
+	const double frequency = 5.0, amplitude = 1000.0;
+	const size_t count = 8000;
+	AccelerometerResamplerState *state = AccelerometerResamplerCreate(kInputRate, outputRate, &timebase);
+	int64_t first = 0;
+	size_t outputs, i;
+	
+	CHECK(state, "out of memory");
+	for(i = 0; i < count; i++)
+	{
+		double t = i / kInputRate;
+		inX[i] = (float)(amplitude * sin(2.0 * kPi * frequency * t));
+		inY[i] = (float)(amplitude * cos(2.0 * kPi * frequency * t));
+		inZ[i] = 1000.0f;
+		ticks[i] = (uint64_t)llround(t * kAccelerometerTimebaseTicksPerSecond);
+	}
+	outputs = Resample(state, count, 0, NULL, outX, outY, outZ, &first);
+	CHECK(outputs > 0, "no outputs at %g Hz", outputRate);
+	
+	// Outputs start once a full set of taps is in and stop at the last input.
+	CHECK(first / outputRate >= (kAccelerometerResamplerTaps / 2 - 1) / kInputRate - 1e-9, "first output at %g s", first / outputRate);
+	CHECK((first + (int64_t)outputs - 1) / outputRate <= (count - 1) / kInputRate + 1e-9, "last output past the input");
+	CHECK((first + (int64_t)outputs) / outputRate > (count - 1) / kInputRate - 1.0 / outputRate - 1e-9, "outputs stop early");
+	/*
+	 16 taps only approximate a flat passband when they also have to low pass at 45 Hz for 100 Hz out.
+	 The last half window reads the last sample repeated, which bends a sine a little but not a constant.
+	 */
+	for(i = 0; i < outputs; i++)
+	{
+		double t = (first + (int64_t)i) / outputRate;
+		double x = amplitude * sin(2.0 * kPi * frequency * t), y = amplitude * cos(2.0 * kPi * frequency * t);
+		int tail = t > (count - kAccelerometerResamplerTaps / 2) / kInputRate;
+		double tolerance = amplitude * (outputRate < kInputRate || tail ? 5e-3 : 1e-3);
+		
+		CHECK(fabs(outX[i] - x) < tolerance && fabs(outY[i] - y) < tolerance && fabs(outZ[i] - 1000.0) < 0.1,
+			  "%g Hz output %zu at %g s: %g %g %g, expected %g %g 1000", outputRate, i, t, outX[i], outY[i], outZ[i], x, y);
+	}
+	AccelerometerResamplerDestroy(state);
+}
+
+// With the running estimate and BLE jitter on the ticks, as the log pipeline uses it without a fit.
+static void CheckConstantTail(void)
+{
+	AccelerometerResamplerState *state = AccelerometerResamplerCreate(kInputRate, kInputRate, NULL);
+	const size_t count = 4000;
+	uint64_t seed = 3;
+	int64_t first = 0;
+	size_t outputs, i;
+	
+	CHECK(state, "out of memory");
+	for(i = 0; i < count; i++)
+	{
+		inX[i] = 1000.0f;
+		inY[i] = -500.0f;
+		inZ[i] = 0.0f;
+		ticks[i] = (uint64_t)(i * 1250) + (uint64_t)TestRandomRange(&seed, 0, 400);
+	}
+	outputs = Resample(state, count, 20, &seed, outX, outY, outZ, &first);
+	CHECK(outputs + kAccelerometerResamplerTaps >= count, "only %zu outputs for %zu inputs", outputs, count);
+	for(i = 0; i < outputs; i++)
+		CHECK(fabs(outX[i] - 1000.0f) < 0.01f && fabs(outY[i] + 500.0f) < 0.01f && fabs(outZ[i]) < 0.01f,
+			  "constant input moved to %g %g %g at output %zu of %zu", outX[i], outY[i], outZ[i], i, outputs);
+	AccelerometerResamplerDestroy(state);
+}
+
+static void CheckChunking(void)
+{
+	const AccelerometerTimebase timebase = { 0.0123, 1.0 + 80e-6 };
+	const size_t count = 20000;
+	AccelerometerResamplerState *state = AccelerometerResamplerCreate(kInputRate, 1000.0, &timebase);
+	uint64_t seed = 11;
+	int64_t first = 0, chunkedFirst = 0;
+	size_t outputs, chunkedOutputs, i;
+	
+	CHECK(state, "out of memory");
+	for(i = 0; i < count; i++)
+	{
+		inX[i] = (float)TestRandomRange(&seed, -2000, 2000);
+		inY[i] = (float)TestRandomRange(&seed, -2000, 2000);
+		inZ[i] = (float)TestRandomRange(&seed, -2000, 2000);
+		ticks[i] = (uint64_t)(i * 1250);
+	}
+	outputs = Resample(state, count, 0, NULL, outX, outY, outZ, &first);
+	AccelerometerResamplerReset(state);
+	chunkedOutputs = Resample(state, count, 300, &seed, chunkedX, chunkedY, chunkedZ, &chunkedFirst);
+	CHECK(outputs == chunkedOutputs && first == chunkedFirst, "%zu outputs from %lld, chunked %zu from %lld",
+		  outputs, (long long)first, chunkedOutputs, (long long)chunkedFirst);
+	CHECK(memcmp(outX, chunkedX, outputs * sizeof(float)) == 0 && memcmp(outY, chunkedY, outputs * sizeof(float)) == 0 &&
+		  memcmp(outZ, chunkedZ, outputs * sizeof(float)) == 0, "chunked input changed the output");
+	AccelerometerResamplerDestroy(state);
+}
+
+// An hour at 800 Hz in BLE sized pieces never grows the history past its first allocation.
+static void CheckBounded(void)
+{
+	AccelerometerResamplerState *state = AccelerometerResamplerCreate(kInputRate, kInputRate, NULL);
+	const size_t capacity = state ? state->historyCapacity : 0;
+	uint64_t seed = 19, total = 0;
+	float x[6] = { 0 }, y[6] = { 0 }, z[6] = { 0 }, ox[100], oy[100], oz[100];
+	uint64_t t[6];
+	int64_t first;
+	size_t i;
+	
+	CHECK(state, "out of memory");
+	while(total < 3600 * 800)
+	{
+		for(i = 0; i < 6; i++, total++)
+			t[i] = total * 1250 + (uint64_t)TestRandomRange(&seed, 0, 400);
+		CHECK(AccelerometerResamplerAdd(state, x, y, z, t, 6) == 6, "history full");
+		while(AccelerometerResamplerProduce(state, ox, oy, oz, 100, &first) > 0)
+			;
+	}
+	CHECK(state->historyCapacity == capacity, "history grew from %zu to %zu", capacity, state->historyCapacity);
+	AccelerometerResamplerDestroy(state);
+}
+
+int main(void)
+{
+	CheckSine(800.0);
+	CheckSine(100.0);
+	CheckSine(1000.0);
+	printf("sine lands on the output grid at 800, 100 and 1000 Hz\n");
+	
+	CheckConstantTail();
+	printf("a constant keeps its level through the tail\n");
+	
+	CheckChunking();
+	printf("chunked input gives bit-identical output\n");
+	
+	CheckBounded();
+	printf("an hour of streaming stays in the first history allocation\n");
+	return 0;
+}
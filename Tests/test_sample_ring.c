@@ -0,0 +1,230 @@
+/**
+ * test_sample_ring.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerSampleRing: order, capacity and drop counting on one thread, then a producer and a
+ consumer thread moving a numbered sequence through a small ring. Without overwriting it has to
+ arrive complete and in order. With overwriting, what arrives has to be in order and never torn, and
+ together with the drops account for every sample.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "AccelerometerSampleRing.h"
+#include "TestSupport.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define kThreadedCount	2000000
+#define kBatch			64
+
+static AccelerometerRingSample Sample(uint64_t n)
+{
+	AccelerometerRingSample sample;
+	
+	sample.timestamp = (double)n;
+	sample.x = (int16_t)n;
+	sample.y = (int16_t)(n >> 16);
+	sample.z = (int16_t)(n >> 32);
+	sample.reserved = 0;
+	return sample;
+}
+
+static uint64_t Number(int16_t x, int16_t y, int16_t z)
+{
+	return (uint64_t)(uint16_t)x | (uint64_t)(uint16_t)y << 16 | (uint64_t)(uint16_t)z << 32;
+}
+
+static void CheckSingleThread(void)
+{
+	AccelerometerSampleRing *ring = AccelerometerSampleRingCreate(5);
+	int16_t x[16], y[16], z[16];
+	double timestamps[16];
+	AccelerometerRingSample sample;
+	uint64_t n;
+	size_t i, count;
+	
+	CHECK(ring && ring->mask == 7, "capacity 5 rounds up to 8");
+	CHECK(AccelerometerSampleRingPop(ring, x, y, z, timestamps, 16) == 0, "pop from an empty ring");
+	for(n = 0; n < 10; n++)
+	{
+		sample = Sample(n);
+		CHECK(AccelerometerSampleRingPush(ring, &sample) == (n < 8), "push %llu", (unsigned long long)n);
+	}
+	CHECK(AccelerometerSampleRingCount(ring) == 8 && AccelerometerSampleRingDropped(ring) == 2, "full ring keeps 8, drops 2");
+	
+	count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, 3);
+	CHECK(count == 3, "pop limited by max");
+	for(i = 0; i < count; i++)
+		CHECK(Number(x[i], y[i], z[i]) == i && timestamps[i] == (double)i, "sample %zu out of order", i);
+	
+	// Wrap around the end of the buffer.
+	for(n = 8; n < 11; n++)
+	{
+		sample = Sample(n);
+		CHECK(AccelerometerSampleRingPush(ring, &sample), "push after pop");
+	}
+	count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, 16);
+	CHECK(count == 8, "pop the rest, got %zu", count);
+	for(i = 0; i < count; i++)
+		CHECK(Number(x[i], y[i], z[i]) == i + 3, "wrapped sample %zu is %llu", i, (unsigned long long)Number(x[i], y[i], z[i]));
+	AccelerometerSampleRingDestroy(ring);
+	AccelerometerSampleRingDestroy(NULL);
+	printf("  order, capacity and drops\n");
+}
+
+static void CheckOverwrite(void)
+{
+	AccelerometerSampleRing *ring = AccelerometerSampleRingCreate(4);
+	int16_t x[8], y[8], z[8];
+	double timestamps[8];
+	AccelerometerRingSample sample;
+	uint64_t n;
+	size_t i, count;
+	
+	for(n = 0; n < 10; n++)
+	{
+		sample = Sample(n);
+		AccelerometerSampleRingPushOverwrite(ring, &sample);
+	}
+	CHECK(AccelerometerSampleRingCount(ring) == 4, "overwriting ring holds %zu", AccelerometerSampleRingCount(ring));
+	count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, 8);
+	CHECK(count == 4 && AccelerometerSampleRingDropped(ring) == 6, "kept %zu, dropped %llu", count, (unsigned long long)AccelerometerSampleRingDropped(ring));
+	for(i = 0; i < count; i++)
+		CHECK(Number(x[i], y[i], z[i]) == i + 6, "newest samples kept, got %llu", (unsigned long long)Number(x[i], y[i], z[i]));
+	AccelerometerSampleRingDestroy(ring);
+	printf("  overwrite keeps the newest\n");
+}
+
+static void *Produce(void *argument)
+{
+	AccelerometerSampleRing *ring = argument;
+	uint64_t n = 0;
+	
+	while(n < kThreadedCount)
+	{
+		AccelerometerRingSample sample = Sample(n);
+		if(AccelerometerSampleRingPush(ring, &sample))
+			n++;
+		else
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void *ProduceOverwriting(void *argument)
+{
+	AccelerometerSampleRing *ring = argument;
+	uint64_t n;
+	
+	for(n = 0; n < kThreadedCount; n++)
+	{
+		AccelerometerRingSample sample = Sample(n);
+		AccelerometerSampleRingPushOverwrite(ring, &sample);
+		if(n % 1024 == 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void CheckThreaded(void)
+{
+	AccelerometerSampleRing *ring = AccelerometerSampleRingCreate(256);
+	int16_t x[kBatch], y[kBatch], z[kBatch];
+	double timestamps[kBatch];
+	pthread_t producer;
+	uint64_t expected = 0;
+	size_t i, count;
+	
+	CHECK(pthread_create(&producer, NULL, Produce, ring) == 0, "no producer thread");
+	while(expected < kThreadedCount)
+	{
+		count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, kBatch);
+		for(i = 0; i < count; i++, expected++)
+		{
+			CHECK(Number(x[i], y[i], z[i]) == expected && timestamps[i] == (double)expected,
+				  "got %llu, expected %llu", (unsigned long long)Number(x[i], y[i], z[i]), (unsigned long long)expected);
+		}
+		if(!count)
+			sched_yield();
+	}
+	pthread_join(producer, NULL);
+	CHECK(AccelerometerSampleRingCount(ring) == 0, "ring not empty at the end");
+	AccelerometerSampleRingDestroy(ring);
+	printf("  %d samples across threads in order\n", kThreadedCount);
+}
+
+// Both sides yield often so the producer laps the consumer many times, mid-copy included.
+static void CheckThreadedOverwrite(void)
+{
+	AccelerometerSampleRing *ring = AccelerometerSampleRingCreate(64);
+	int16_t x[kBatch], y[kBatch], z[kBatch];
+	double timestamps[kBatch];
+	pthread_t producer;
+	uint64_t received = 0, last = 0, number;
+	int first = 1, done = 0;
+	size_t i, count;
+	
+	CHECK(pthread_create(&producer, NULL, ProduceOverwriting, ring) == 0, "no producer thread");
+	while(!done)
+	{
+		count = AccelerometerSampleRingPop(ring, x, y, z, timestamps, 8);
+		for(i = 0; i < count; i++)
+		{
+			number = Number(x[i], y[i], z[i]);
+			CHECK(timestamps[i] == (double)number, "torn sample, columns say %llu, timestamp %.0f", (unsigned long long)number, timestamps[i]);
+			CHECK(first || number > last, "got %llu after %llu", (unsigned long long)number, (unsigned long long)last);
+			last = number;
+			first = 0;
+		}
+		received += count;
+		done = !first && last == kThreadedCount - 1;
+		sched_yield();
+	}
+	pthread_join(producer, NULL);
+	CHECK(received + AccelerometerSampleRingDropped(ring) == kThreadedCount, "%llu received and %llu dropped of %d",
+		  (unsigned long long)received, (unsigned long long)AccelerometerSampleRingDropped(ring), kThreadedCount);
+	AccelerometerSampleRingDestroy(ring);
+	printf("  %llu of %d samples overwriting across threads, in order and whole\n", (unsigned long long)received, kThreadedCount);
+}
+
+int main(void)
+{
+	CheckSingleThread();
+	CheckOverwrite();
+	CheckThreaded();
+	CheckThreadedOverwrite();
+	return 0;
+}
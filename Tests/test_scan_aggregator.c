@@ -0,0 +1,257 @@
+/**
+ * test_scan_aggregator.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ The C core of ScanAggregator. ScanOrder against a plain sorted array through random inserts,
+ removals and rank changes, with the tree depth staying logarithmic even when devices are found
+ in rank order. ScanOrderMoves against a quadratic longest increasing run, and the moves it leaves
+ out having to be in order. RSSITracker gating, restarting and ignoring invalid readings.
+ */
+
+#include "ScanOrder.h"
+#include "RSSITracker.h"
+#include "TestSupport.h"
+#include <math.h>
+#include <string.h>
+
+#define kNodes		3000
+#define kRounds		40000
+#define kRows		300
+
+static ScanOrderNode nodes[kNodes];
+static ScanOrderNode *collected[kNodes];
+static int inOrder[kNodes];
+
+static int Precedes(const ScanOrderNode *a, const ScanOrderNode *b)
+{
+	return a->rank > b->rank || (a->rank == b->rank && a->serial < b->serial);
+}
+
+static size_t Depth(const ScanOrderNode *node)
+{
+	size_t left, right;
+	
+	if(!node)
+		return 0;
+	left = Depth(node->left);
+	right = Depth(node->right);
+	return 1 + (left > right ? left : right);
+}
+
+// Collected order has to hold exactly the nodes marked in, sorted, and the tree has to stay shallow.
+static void CheckOrder(const ScanOrder *order)
+{
+	size_t count = 0, i;
+	
+	for(i = 0; i < kNodes; i++)
+		count += inOrder[i];
+	CHECK(order->count == count, "count %zu, expected %zu", order->count, count);
+	ScanOrderCollect(order, collected);
+	for(i = 0; i < count; i++)
+	{
+		CHECK(inOrder[collected[i] - nodes], "node %zu collected but not in the order", (size_t)(collected[i] - nodes));
+		CHECK(i == 0 || Precedes(collected[i - 1], collected[i]), "out of order at %zu", i);
+	}
+	CHECK(Depth(order->root) <= 4 * (size_t)ceil(log2((double)count + 1)) + 4, "depth %zu for %zu nodes", Depth(order->root), count);
+}
+
+static void CheckTree(void)
+{
+	ScanOrder order;
+	uint64_t seed = 5;
+	size_t i, round;
+	
+	// Found strongest first, which degenerates an unbalanced tree into a list.
+	ScanOrderInit(&order);
+	memset(inOrder, 0, sizeof(inOrder));
+	for(i = 0; i < kNodes; i++)
+	{
+		nodes[i].serial = i;
+		nodes[i].rank = -(long)i;
+		nodes[i].context = &nodes[i];
+		ScanOrderInsert(&order, &nodes[i]);
+		inOrder[i] = 1;
+	}
+	CheckOrder(&order);
+	printf("  %d nodes inserted in order, depth %zu\n", kNodes, Depth(order.root));
+	
+	// Mostly rank changes of a few dB, the rest devices leaving and coming back, ranks often tied.
+	for(round = 0; round < kRounds; round++)
+	{
+		ScanOrderNode *node = &nodes[TestRandomRange(&seed, 0, kNodes - 1)];
+		int action = TestRandomRange(&seed, 0, 9);
+		
+		if(!inOrder[node - nodes])
+		{
+			node->rank = TestRandomRange(&seed, -100, -30);
+			ScanOrderInsert(&order, node);
+			inOrder[node - nodes] = 1;
+		}
+		else if(action == 0)
+		{
+			ScanOrderRemove(&order, node);
+			inOrder[node - nodes] = 0;
+		}
+		else
+		{
+			ScanOrderSetRank(&order, node, node->rank + TestRandomRange(&seed, -3, 3));
+		}
+		if(round % 4000 == 0)
+			CheckOrder(&order);
+	}
+	CheckOrder(&order);
+	ScanOrderCollect(&order, collected);
+	CHECK(order.count == 0 || collected[0]->context == collected[0], "context kept");
+	printf("  %d random updates over %zu nodes, depth %zu\n", kRounds, order.count, Depth(order.root));
+	
+	for(i = 0; i < kNodes; i++)
+	{
+		if(inOrder[i])
+			ScanOrderRemove(&order, &nodes[i]);
+	}
+	CHECK(order.count == 0 && !order.root, "empty after removing everything");
+}
+
+static size_t LongestRun(const size_t *previous, size_t count)
+{
+	static size_t lengths[kRows];
+	size_t best = 0, i, j;
+	
+	for(i = 0; i < count; i++)
+	{
+		lengths[i] = 0;
+		if(previous[i] == kScanOrderNew)
+			continue;
+		lengths[i] = 1;
+		for(j = 0; j < i; j++)
+		{
+			if(previous[j] != kScanOrderNew && previous[j] < previous[i] && lengths[j] + 1 > lengths[i])
+				lengths[i] = lengths[j] + 1;
+		}
+		if(lengths[i] > best)
+			best = lengths[i];
+	}
+	return best;
+}
+
+static void CheckMoves(void)
+{
+	size_t previous[kRows], moves[2 * kRows], scratch[3 * kRows];
+	int moved[kRows];
+	uint64_t seed = 17;
+	size_t trial, count, kept, moveCount, last, i;
+	
+	CHECK(ScanOrderMoves(NULL, 0, moves, scratch) == 0, "no moves for no rows");
+	for(trial = 0; trial < 200; trial++)
+	{
+		// A previous list of old rows, shuffled a little, with some new rows and some old ones gone.
+		count = (size_t)TestRandomRange(&seed, 1, kRows);
+		for(i = 0; i < count; i++)
+			previous[i] = i;
+		for(i = 0; i < count / 8 + 1; i++)
+		{
+			size_t a = (size_t)TestRandomRange(&seed, 0, (int)count - 1), b = (size_t)TestRandomRange(&seed, 0, (int)count - 1), t = previous[a];
+			previous[a] = previous[b];
+			previous[b] = t;
+		}
+		kept = 0;
+		for(i = 0; i < count; i++)
+		{
+			if(TestRandomRange(&seed, 0, 9) == 0)
+				previous[i] = kScanOrderNew;
+			else
+				kept++;
+		}
+		
+		moveCount = ScanOrderMoves(previous, count, moves, scratch);
+		CHECK(moveCount == kept - LongestRun(previous, count), "%zu moves, %zu rows and a run of %zu", moveCount, kept, LongestRun(previous, count));
+		memset(moved, 0, sizeof(moved));
+		for(i = 0; i < moveCount; i++)
+		{
+			CHECK(moves[2 * i + 1] < count && previous[moves[2 * i + 1]] == moves[2 * i], "move %zu pairs the wrong rows", i);
+			moved[moves[2 * i + 1]] = 1;
+		}
+		last = kScanOrderNew;
+		for(i = 0; i < count; i++)
+		{
+			if(previous[i] == kScanOrderNew || moved[i])
+				continue;
+			CHECK(last == kScanOrderNew || previous[i] > last, "row %zu stays but is out of order", i);
+			last = previous[i];
+		}
+	}
+	printf("  moves are the rows outside the longest run\n");
+}
+
+static void CheckTracker(void)
+{
+	RSSITracker tracker;
+	double estimate;
+	int i;
+	
+	RSSITrackerReset(&tracker);
+	CHECK(!tracker.valid, "reset tracker is not valid");
+	CHECK(!RSSITrackerUpdate(&tracker, kRSSITrackerInvalid, 0.0), "127 is no reading");
+	CHECK(!RSSITrackerUpdate(&tracker, 0, 0.0), "0 dB is no reading");
+	CHECK(!tracker.valid, "invalid readings do not start the filter");
+	CHECK(RSSITrackerUpdate(&tracker, -60, 0.0) && tracker.valid && tracker.estimate == -60.0, "first reading starts the filter");
+	
+	for(i = 1; i <= 50; i++)
+		CHECK(RSSITrackerUpdate(&tracker, i % 2 ? -56 : -64, i * 0.1), "reading %d within the noise", i);
+	CHECK(fabs(tracker.estimate + 60.0) < 2.0, "noise averages out, estimate %f", tracker.estimate);
+	
+	// One multipath dip is dropped, and the count of rejections starts over after a good reading.
+	estimate = tracker.estimate;
+	CHECK(!RSSITrackerUpdate(&tracker, -95, 5.1) && tracker.estimate == estimate, "outlier rejected");
+	CHECK(!RSSITrackerUpdate(&tracker, -95, 5.2), "second outlier rejected");
+	CHECK(RSSITrackerUpdate(&tracker, -60, 5.3) && tracker.rejections == 0, "good reading clears the rejections");
+	
+	// A device that really moved is followed after kRSSITrackerMaxRejections readings.
+	for(i = 1; i < kRSSITrackerMaxRejections; i++)
+		CHECK(!RSSITrackerUpdate(&tracker, -90, 5.3 + i * 0.1), "rejection %d", i);
+	CHECK(RSSITrackerUpdate(&tracker, -91, 6.0) && tracker.estimate == -91.0, "restarted from the newest reading");
+	
+	// A long gap lets the estimate follow a bigger step.
+	CHECK(RSSITrackerUpdate(&tracker, -75, 100.0) && tracker.estimate > -80.0, "followed after a gap, estimate %f", tracker.estimate);
+	printf("  RSSI tracker gates, restarts and skips invalid readings\n");
+}
+
+int main(void)
+{
+	CheckTree();
+	CheckMoves();
+	CheckTracker();
+	return 0;
+}
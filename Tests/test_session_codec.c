@@ -0,0 +1,190 @@
+/**
+ * test_session_codec.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Round trips blocks through AccelerometerSessionEncodeBlock and AccelerometerSessionDecodeBlock,
+ covering every packed bit width from 0 to 64, raw fallback and damaged headers, and checks that a
+ recording comes out 5 to 10 times smaller than the CSV the app mails.
+ */
+
+#include "AccelerometerSessionCodec.h"
+#include "SessionSamples.h"
+#include <string.h>
+
+#define kBlock	kAccelerometerSessionBlockSize
+
+static uint64_t tick[kBlock], decodedTick[kBlock], scratch[2 * kBlock];
+static int16_t x[kBlock], y[kBlock], z[kBlock], decodedX[kBlock], decodedY[kBlock], decodedZ[kBlock];
+static uint8_t payload[kBlock * (sizeof(uint64_t) + 3 * sizeof(int16_t))];
+
+static AccelerometerSessionBlockHeader RoundTrip(uint32_t count, const char *what)
+{
+	AccelerometerSessionBlockHeader header;
+	uint32_t i;
+	
+	AccelerometerSessionEncodeBlock(&header, payload, scratch, tick, x, y, z, count);
+	CHECK(header.count == count, "%s: header count %u", what, header.count);
+	CHECK(header.payloadSize <= AccelerometerSessionRawPayloadSize(count), "%s: payload larger than raw", what);
+	CHECK(header.firstTick == tick[0] && header.lastTick == tick[count - 1], "%s: tick range", what);
+	memset(decodedTick, 0xAB, sizeof(decodedTick));
+	CHECK(AccelerometerSessionDecodeBlock(&header, payload, scratch, decodedTick, decodedX, decodedY, decodedZ), "%s: decode failed", what);
+	for(i = 0; i < count; ++i)
+	{
+		CHECK(decodedTick[i] == tick[i] && decodedX[i] == x[i] && decodedY[i] == y[i] && decodedZ[i] == z[i],
+			  "%s: sample %u of %u decoded as %llu %d %d %d, expected %llu %d %d %d", what, i, count,
+			  (unsigned long long)decodedTick[i], decodedX[i], decodedY[i], decodedZ[i], (unsigned long long)tick[i], x[i], y[i], z[i]);
+		CHECK(x[i] >= header.min[0] && x[i] <= header.max[0] && z[i] >= header.min[2] && z[i] <= header.max[2], "%s: min/max", what);
+	}
+	return header;
+}
+
+static void CheckBitWidths(uint64_t *seed)
+{
+	unsigned bits;
+	uint32_t i;
+	
+	// Tick deltas spanning exactly bits bits, and for the axes the widest int16 swings.
+	for(bits = 0; bits <= 64; ++bits)
+	{
+		uint64_t span = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+		uint32_t count = 2 + (uint32_t)TestRandomRange(seed, 0, kBlock - 2);
+		AccelerometerSessionBlockHeader header;
+		
+		tick[0] = TestRandom(seed);
+		for(i = 1; i < count; ++i)
+			tick[i] = tick[i - 1] + (i == 1 ? 0 : (i == 2 ? span : TestRandom(seed) & span));
+		for(i = 0; i < count; ++i)
+		{
+			x[i] = (int16_t)(i & 1 ? INT16_MAX : INT16_MIN);
+			y[i] = (int16_t)TestRandomRange(seed, -(1 << (bits % 16)), 1 << (bits % 16));
+			z[i] = 5;
+		}
+		header = RoundTrip(count, "bit width");
+		if(header.encoding == AccelerometerSessionBlockPacked)
+		{
+			CHECK(header.bits[0] == bits, "tick column packed in %u bits, expected %u", header.bits[0], bits);
+			CHECK(header.bits[3] == 0, "constant column takes %u bits", header.bits[3]);
+		}
+	}
+}
+
+static void CheckBlockSizes(uint64_t *seed)
+{
+	uint32_t count;
+	int packed = 0, raw = 0;
+	
+	for(count = 1; count <= kBlock; count += 1 + count / 8)
+	{
+		AccelerometerSessionBlockHeader header;
+		
+		MakeSession(seed, tick, x, y, z, count);
+		header = RoundTrip(count, "recording");
+		packed += header.encoding == AccelerometerSessionBlockPacked;
+		
+		// Noise over the whole range does not pack and must fall back to raw.
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			tick[i] = TestRandom(seed);
+			x[i] = (int16_t)TestRandom(seed);
+			y[i] = (int16_t)TestRandom(seed);
+			z[i] = (int16_t)TestRandom(seed);
+		}
+		header = RoundTrip(count, "noise");
+		raw += header.encoding == AccelerometerSessionBlockRaw;
+	}
+	CHECK(packed > 0 && raw > 0, "%d packed and %d raw blocks, expected both", packed, raw);
+}
+
+static void CheckDamage(uint64_t *seed)
+{
+	AccelerometerSessionBlockHeader header, damaged;
+	
+	MakeSession(seed, tick, x, y, z, kBlock);
+	header = RoundTrip(kBlock, "damage");
+	CHECK(header.encoding == AccelerometerSessionBlockPacked, "recording did not pack");
+	
+	damaged = header;
+	damaged.payloadSize += 8;
+	CHECK(!AccelerometerSessionDecodeBlock(&damaged, payload, scratch, decodedTick, decodedX, decodedY, decodedZ), "wrong payload size accepted");
+	damaged = header;
+	damaged.encoding = 7;
+	CHECK(!AccelerometerSessionDecodeBlock(&damaged, payload, scratch, decodedTick, decodedX, decodedY, decodedZ), "unknown encoding accepted");
+	damaged = header;
+	damaged.bits[1] = 65;
+	CHECK(!AccelerometerSessionDecodeBlock(&damaged, payload, scratch, decodedTick, decodedX, decodedY, decodedZ), "65 bit column accepted");
+	damaged = header;
+	damaged.count = 0;
+	CHECK(!AccelerometerSessionDecodeBlock(&damaged, payload, scratch, decodedTick, decodedX, decodedY, decodedZ), "empty block accepted");
+}
+
+static void CheckSize(uint64_t *seed)
+{
+	// A minute at 800 Hz.
+	enum { kCount = 48000 };
+	static uint64_t sessionTick[kCount];
+	static int16_t sx[kCount], sy[kCount], sz[kCount];
+	size_t binary = sizeof(AccelerometerSessionHeader) + sizeof(AccelerometerSessionFooter), csv = 0, done, i;
+	char line[64];
+	double ratio;
+	
+	MakeSession(seed, sessionTick, sx, sy, sz, kCount);
+	for(done = 0; done < kCount; done += kBlock)
+	{
+		uint32_t count = (uint32_t)(kCount - done < kBlock ? kCount - done : kBlock);
+		AccelerometerSessionBlockHeader header;
+		
+		AccelerometerSessionEncodeBlock(&header, payload, scratch, sessionTick + done, sx + done, sy + done, sz + done, count);
+		binary += sizeof(header) + header.payloadSize + sizeof(AccelerometerSessionIndexEntry);
+	}
+	for(i = 0; i < kCount; ++i)
+		csv += FormatCSVLine(line, 1760000000.0, sessionTick[i], sx[i], sy[i], sz[i]);
+	ratio = (double)csv / binary;
+	printf("a minute at 800 Hz: %zu bytes of CSV, %zu bytes of session, %.1fx smaller\n", csv, binary, ratio);
+	CHECK(ratio >= 5.0 && ratio <= 10.0, "session is %.1fx smaller than CSV, expected 5 to 10", ratio);
+}
+
+int main(void)
+{
+	uint64_t seed = 11;
+	
+	CheckBitWidths(&seed);
+	printf("packed columns round trip at every bit width\n");
+	CheckBlockSizes(&seed);
+	printf("blocks of every size round trip, packed and raw\n");
+	CheckDamage(&seed);
+	printf("damaged block headers rejected\n");
+	CheckSize(&seed);
+	return 0;
+}
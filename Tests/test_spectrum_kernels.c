@@ -0,0 +1,131 @@
+/**
+ * test_spectrum_kernels.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ Checks AccelerometerSpectrumPower against a direct DFT in double precision for every supported
+ window size and circular buffer offset, and that the peak search finds a sine between two bins.
+ */
+
+#include "AccelerometerSpectrumKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+
+static const double kPi = 3.14159265358979323846;
+
+static void ReferencePower(const float *samples, size_t start, size_t n, double *power)
+{
+	double mean = 0.0, energy = 0.0;
+	size_t i, k;
+	
+	for(i = 0; i < n; ++i)
+		mean += samples[i];
+	mean /= n;
+	for(i = 0; i < n; ++i)
+	{
+		double w = 0.5 * (1.0 - cos(2.0 * kPi * i / n));
+		energy += w * w;
+	}
+	for(k = 0; k <= n / 2; ++k)
+	{
+		double re = 0.0, im = 0.0;
+		for(i = 0; i < n; ++i)
+		{
+			double v = (samples[(start + i) % n] - mean) * 0.5 * (1.0 - cos(2.0 * kPi * i / n));
+			re += v * cos(2.0 * kPi * k * i / n);
+			im -= v * sin(2.0 * kPi * k * i / n);
+		}
+		power[k] = (k == 0 || k == n / 2 ? 1.0 : 2.0) * (re * re + im * im) / energy;
+	}
+}
+
+static void CheckAgainstDFT(uint64_t *seed)
+{
+	static float samples[4096], power[2049];
+	static double reference[2049];
+	size_t n, k, start;
+	
+	for(n = kAccelerometerSpectrumMinWindow; n <= 4096; n *= 2)
+	{
+		AccelerometerSpectrumPlan *plan = AccelerometerSpectrumPlanCreate(n);
+		double total = 0.0, worst = 0.0;
+		
+		CHECK(plan, "no plan for %zu", n);
+		for(k = 0; k < n; ++k)
+			samples[k] = 1000.0f + (float)TestRandomRange(seed, -500, 500) + 300.0f * (float)sin(2.0 * kPi * 5.3 * k / n);
+		start = (size_t)TestRandomRange(seed, 0, (int)n - 1);
+		AccelerometerSpectrumPower(plan, samples, start, power);
+		ReferencePower(samples, start, n, reference);
+		for(k = 0; k <= n / 2; ++k)
+			total += reference[k];
+		for(k = 0; k <= n / 2; ++k)
+			worst = fmax(worst, fabs(power[k] - reference[k]));
+		// Single precision, so relative to the total power rather than to each bin.
+		CHECK(worst <= 1e-5 * total, "window %zu: error %g of total power %g", n, worst, total);
+		AccelerometerSpectrumPlanDestroy(plan);
+	}
+}
+
+static void CheckPeak(void)
+{
+	static float samples[1024], power[513];
+	AccelerometerSpectrumPlan *plan = AccelerometerSpectrumPlanCreate(1024);
+	double rate = 800.0, frequency, found;
+	float peakPower;
+	size_t i;
+	
+	for(frequency = 20.0; frequency < 380.0; frequency += 37.3)
+	{
+		for(i = 0; i < 1024; ++i)
+			samples[i] = (float)(500.0 * sin(2.0 * kPi * frequency * i / rate));
+		AccelerometerSpectrumPower(plan, samples, 0, power);
+		found = AccelerometerSpectrumPeak(power, 513, rate / 1024, &peakPower);
+		CHECK(fabs(found - frequency) < 0.25 * rate / 1024, "sine at %g Hz found at %g Hz", frequency, found);
+		CHECK(peakPower > 0.0f, "no peak power");
+	}
+	AccelerometerSpectrumPlanDestroy(plan);
+}
+
+int main(void)
+{
+	uint64_t seed = 7;
+	
+	CHECK(!AccelerometerSpectrumPlanCreate(8), "window below the minimum accepted");
+	CHECK(!AccelerometerSpectrumPlanCreate(100), "window that is not a power of two accepted");
+	CheckAgainstDFT(&seed);
+	printf("power spectra match a direct DFT\n");
+	CheckPeak();
+	printf("peaks found within a quarter bin\n");
+	return 0;
+}
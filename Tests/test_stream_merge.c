@@ -0,0 +1,326 @@
+/**
+ * test_stream_merge.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerStreamMergeKernels on simulated boards: each samples at 800 Hz on a clock a little fast
+ or slow, and its samples reach the phone in order with BLE jitter, fed to the merger every 10 ms the
+ way notifications arrive. Output has to be in time order and every stream in its own order, nothing
+ may stay buffered past maxLatency, and every sample has to come out or be counted late. Lost
+ samples have to be skipped over and a stalled connection must not be, and samples that only arrive
+ after the latency budget are counted in lateFrames instead of going back in time.
+ */
+
+#include "AccelerometerStreamMergeKernels.h"
+#include "TestSupport.h"
+#include <math.h>
+
+#define kRate			800.0
+#define kSeconds		20
+#define kCount			(kSeconds * 800)
+#define kMaxStreams		4
+#define kLatency		0.25
+#define kTick			0.01
+#define kMinDelay		0.005
+#define kMaxDelay		0.035
+#define kMeanDelay		((kMinDelay + kMaxDelay) / 2)
+
+typedef struct {
+	double start, ppm;
+	double arrivals[kCount];
+	int lost[kCount];
+	size_t next;
+} Board;
+
+static Board boards[kMaxStreams];
+static double times[kMaxStreams][kCount];
+static int emitted[kMaxStreams][kCount];
+static double lastEmitted;
+static size_t emittedCount;
+
+static double TrueTime(const Board *board, size_t n)
+{
+	return board->start + n / kRate * (1.0 + board->ppm * 1e-6);
+}
+
+static void MakeBoard(Board *board, double start, double ppm, uint64_t *seed)
+{
+	size_t n;
+	
+	board->start = start;
+	board->ppm = ppm;
+	board->next = 0;
+	for(n = 0; n < kCount; n++)
+	{
+		double delay = kMinDelay + (kMaxDelay - kMinDelay) * (TestRandom(seed) % 1000) / 999.0;
+		board->arrivals[n] = TrueTime(board, n) + delay;
+		// BLE delivers in order.
+		if(n && board->arrivals[n] < board->arrivals[n - 1])
+			board->arrivals[n] = board->arrivals[n - 1];
+		board->lost[n] = 0;
+	}
+}
+
+// Nothing arrives between from and to, then the backlog comes at speed times the sample rate.
+static void Stall(Board *board, double from, double to, double speed)
+{
+	double arrival = to;
+	size_t n;
+	
+	for(n = 0; n < kCount; n++)
+	{
+		if(board->arrivals[n] < from)
+			continue;
+		if(board->arrivals[n] >= arrival)
+			break;
+		board->arrivals[n] = arrival;
+		arrival += 1.0 / (speed * kRate);
+	}
+}
+
+static void TakeOutput(AccelerometerStreamMergeState *state)
+{
+	size_t i;
+	
+	for(i = 0; i < state->outputCount; i++)
+	{
+		const AccelerometerMergedFrame *frame = &state->output[i];
+		size_t n = (size_t)(uint16_t)frame->y | (size_t)(uint16_t)frame->z << 16;
+		
+		CHECK(frame->time >= lastEmitted, "frame %zu at %f after %f", emittedCount, frame->time, lastEmitted);
+		CHECK(frame->stream < kMaxStreams && frame->x == (int16_t)frame->stream, "frame %zu has stream %u", emittedCount, frame->stream);
+		CHECK(n < kCount && !emitted[frame->stream][n], "sample %zu of stream %u twice", n, frame->stream);
+		emitted[frame->stream][n] = 1;
+		times[frame->stream][n] = frame->time;
+		lastEmitted = frame->time;
+		emittedCount++;
+	}
+	state->outputCount = 0;
+}
+
+// Nothing still queued may be older than maxLatency behind the newest time.
+static void CheckLatency(const AccelerometerStreamMergeState *state)
+{
+	size_t s, i;
+	
+	for(s = 0; s < state->streamCount; s++)
+	{
+		const AccelerometerMergeStream *stream = &state->streams[s];
+		for(i = 0; i < stream->count; i++)
+		{
+			double time = stream->frames[(stream->head + i) % kAccelerometerStreamMergeCapacity].time;
+			CHECK(time > state->newestTime - state->maxLatency - 1e-9, "stream %zu holds a frame %f s behind", s, state->newestTime - time);
+		}
+		CHECK(stream->count + stream->held <= kAccelerometerStreamMergeCapacity, "stream %zu overflowed", s);
+	}
+}
+
+// Feed every board until silentAfter, in the arrival order of 10 ms ticks, then flush.
+static void Run(AccelerometerStreamMergeState *state, size_t streams, const double *silentAfter)
+{
+	int16_t x[kCount], y[kCount], z[kCount];
+	double arrivals[kCount], tick;
+	size_t s, n, count;
+	int busy = 1;
+	
+	lastEmitted = -INFINITY;
+	emittedCount = 0;
+	for(s = 0; s < streams; s++)
+	{
+		CHECK(AccelerometerStreamMergeAddStream(state) == (long)s, "stream %zu added", s);
+		for(n = 0; n < kCount; n++)
+			emitted[s][n] = 0;
+	}
+	for(tick = 0.0; busy; tick += kTick)
+	{
+		busy = 0;
+		for(s = 0; s < streams; s++)
+		{
+			Board *board = &boards[s];
+			for(count = 0; board->next < kCount && board->arrivals[board->next] <= tick; board->next++)
+			{
+				n = board->next;
+				if(board->lost[n] || (silentAfter && board->arrivals[n] > silentAfter[s]))
+					continue;
+				x[count] = (int16_t)s;
+				y[count] = (int16_t)(uint16_t)(n & 0xffff);
+				z[count] = (int16_t)(uint16_t)(n >> 16);
+				arrivals[count++] = board->arrivals[n];
+			}
+			busy |= board->next < kCount;
+			if(count)
+			{
+				CHECK(AccelerometerStreamMergeAdd(state, s, x, y, z, arrivals, count), "add %zu samples", count);
+				TakeOutput(state);
+				CheckLatency(state);
+			}
+		}
+	}
+	AccelerometerStreamMergeFlush(state);
+	TakeOutput(state);
+}
+
+// Largest error against the true time plus the mean BLE delay, past the first seconds of fitting.
+static double MaxError(size_t stream, double from, size_t *missing)
+{
+	double error = 0.0;
+	size_t n;
+	
+	*missing = 0;
+	for(n = (size_t)(from * kRate); n < kCount; n++)
+	{
+		if(!emitted[stream][n])
+		{
+			++*missing;
+			continue;
+		}
+		error = fmax(error, fabs(times[stream][n] - TrueTime(&boards[stream], n) - kMeanDelay));
+	}
+	return error;
+}
+
+static void CheckOrdering(void)
+{
+	AccelerometerStreamMergeState *state = AccelerometerStreamMergeCreate(kRate, kLatency);
+	static const double ppm[] = { -80.0, 0.0, 45.0, 120.0 };
+	uint64_t seed = 3;
+	size_t s, n, missing, delivered;
+	double error;
+	
+	CHECK(state, "out of memory");
+	for(s = 0; s < kMaxStreams; s++)
+		MakeBoard(&boards[s], 0.05 * s, ppm[s], &seed);
+	Run(state, kMaxStreams, NULL);
+	CHECK(state->mergedFrames == kMaxStreams * kCount && state->lateFrames == 0, "%llu merged, %llu late",
+		  (unsigned long long)state->mergedFrames, (unsigned long long)state->lateFrames);
+	for(s = 0; s < kMaxStreams; s++)
+	{
+		error = MaxError(s, 2.0, &missing);
+		CHECK(!missing && error < 0.012, "stream %zu off by %f s", s, error);
+		CHECK(fabs(state->streams[s].timebase.rate - (1.0 + ppm[s] * 1e-6)) < 2e-5, "stream %zu rate %.7f for %+.0f ppm",
+			  s, state->streams[s].timebase.rate, ppm[s]);
+		CHECK(state->streams[s].skippedSamples == 0, "stream %zu skipped samples", s);
+	}
+	printf("  %d streams in order within %.1f ms, latency under %.2f s, rates fitted\n", kMaxStreams, 1e3 * MaxError(0, 2.0, &missing), kLatency);
+	
+	// A stream that falls silent without ending holds the others up by maxLatency at most.
+	AccelerometerStreamMergeReset(state);
+	for(s = 0; s < 2; s++)
+		MakeBoard(&boards[s], 0.0, 0.0, &seed);
+	{
+		const double silentAfter[] = { INFINITY, 5.0 };
+		Run(state, 2, silentAfter);
+	}
+	for(n = 0, delivered = kCount; n < kCount; n++)
+		delivered += boards[1].arrivals[n] <= 5.0;
+	CHECK(state->lateFrames == 0 && state->mergedFrames == delivered, "%llu merged of %zu", (unsigned long long)state->mergedFrames, delivered);
+	CHECK(emitted[0][kCount - 1], "the live stream kept flowing");
+	printf("  a silent stream holds nobody up\n");
+	AccelerometerStreamMergeDestroy(state);
+}
+
+static void CheckGaps(void)
+{
+	AccelerometerStreamMergeState *state = AccelerometerStreamMergeCreate(kRate, kLatency);
+	uint64_t seed = 11;
+	size_t n, missing;
+	double error, step, maxStep;
+	
+	CHECK(state, "out of memory");
+	// Lost samples: half a second of them, then two shorter runs.
+	MakeBoard(&boards[0], 0.0, 60.0, &seed);
+	for(n = 4000; n < 4400; n++)
+		boards[0].lost[n] = 1;
+	for(n = 9000; n < 9300; n++)
+		boards[0].lost[n] = 1;
+	Run(state, 1, NULL);
+	CHECK(llabs((long long)state->streams[0].skippedSamples - 700) <= 8, "skipped %llu of 700 lost", (unsigned long long)state->streams[0].skippedSamples);
+	error = MaxError(0, 2.0, &missing);
+	CHECK(missing == 700 && error < 0.012, "after gaps off by %f s, %zu missing", error, missing);
+	printf("  lost samples skipped, %llu of 700, within %.1f ms\n", (unsigned long long)state->streams[0].skippedSamples, 1e3 * error);
+	
+	// Stalls that end in an instant burst and in a slow catch up lose nothing, so skip nothing.
+	AccelerometerStreamMergeReset(state);
+	MakeBoard(&boards[0], 0.0, -40.0, &seed);
+	Stall(&boards[0], 5.0, 5.5, 1000.0);
+	Stall(&boards[0], 12.0, 12.4, 1.5);
+	Run(state, 1, NULL);
+	CHECK(state->streams[0].skippedSamples == 0, "stall skipped %llu samples", (unsigned long long)state->streams[0].skippedSamples);
+	error = MaxError(0, 2.0, &missing);
+	CHECK(!missing && error < 0.012, "after stalls off by %f s", error);
+	// No sawtooth: consecutive samples stay a sample period apart.
+	maxStep = 0.0;
+	for(n = 1600; n < kCount; n++)
+	{
+		step = times[0][n] - times[0][n - 1];
+		CHECK(step >= 0.0, "time went back at %zu", n);
+		maxStep = fmax(maxStep, step);
+	}
+	CHECK(maxStep < 2.0 / kRate, "step of %f s", maxStep);
+	printf("  stalls skip nothing, within %.1f ms, steps under %.2f ms\n", 1e3 * error, 1e3 * maxStep);
+	AccelerometerStreamMergeDestroy(state);
+}
+
+static void CheckLateFrames(void)
+{
+	AccelerometerStreamMergeState *state = AccelerometerStreamMergeCreate(kRate, kLatency);
+	uint64_t seed = 29;
+	size_t n, missing, stalled = 0;
+	
+	CHECK(state, "out of memory");
+	// The second board's connection stalls for a second while the first streams on.
+	MakeBoard(&boards[0], 0.0, 0.0, &seed);
+	MakeBoard(&boards[1], 0.0, 20.0, &seed);
+	for(n = 0; n < kCount; n++)
+		stalled += boards[1].arrivals[n] >= 6.0 && boards[1].arrivals[n] < 7.0;
+	Stall(&boards[1], 6.0, 7.0, 1000.0);
+	Run(state, 2, NULL);
+	CHECK(state->mergedFrames + state->lateFrames == 2 * kCount, "%llu merged and %llu late", (unsigned long long)state->mergedFrames,
+		  (unsigned long long)state->lateFrames);
+	// Besides the stalled ones, those arriving just after the stall are behind the first board already.
+	CHECK(state->lateFrames > stalled / 2 && state->lateFrames <= stalled + kMaxDelay * kRate, "%llu late of %zu stalled", (unsigned long long)state->lateFrames, stalled);
+	MaxError(1, 2.0, &missing);
+	CHECK(missing == state->lateFrames, "late frames are the missing ones");
+	CHECK(state->streams[1].skippedSamples == 0, "the stall was not a gap");
+	printf("  %llu late around %zu stalled samples, output never went back\n", (unsigned long long)state->lateFrames, stalled);
+	AccelerometerStreamMergeDestroy(state);
+}
+
+int main(void)
+{
+	CheckOrdering();
+	CheckGaps();
+	CheckLateFrames();
+	return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * test_timebase.c
+ * MetaWearApiTest
+ *
+ * Created by MbientLab on 10/16/26.
+ * Copyright 2026 MbientLab Inc. All rights reserved.
+ *
+ * IMPORTANT: Your use of this Software is limited to those specific rights
+ * granted under the terms of a software license agreement between the user who
+ * downloaded the software, his/her employer (which must be your employer) and
+ * MbientLab Inc, (the "License").  You may not use this Software unless you
+ * agree to abide by the terms of the License which can be found at
+ * www.mbientlab.com/terms . The License limits your use, and you acknowledge,
+ * that the  Software may not be modified, copied or distributed and can be used
+ * solely and exclusively in conjunction with a MbientLab Inc, product.  Other
+ * than for the foregoing purpose, you may not use, reproduce, copy, prepare
+ * derivative works of, modify, distribute, perform, display or sell this
+ * Software and/or its documentation for any purpose.
+ *
+ * YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+ * PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+ * NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+ * MBIENTLAB OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT, NEGLIGENCE,
+ * STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER LEGAL EQUITABLE
+ * THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES INCLUDING BUT NOT LIMITED
+ * TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR CONSEQUENTIAL DAMAGES, LOST
+ * PROFITS OR LOST DATA, COST OF PROCUREMENT OF SUBSTITUTE GOODS, TECHNOLOGY,
+ * SERVICES, OR ANY CLAIMS BY THIRD PARTIES (INCLUDING BUT NOT LIMITED TO ANY
+ * DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+ *
+ * Should you have any questions regarding your right to use this Software,
+ * contact MbientLab Inc, at www.mbientlab.com.
+ */
+
+/*
+ AccelerometerTimebase: the batch fit recovers a known drift and offset, rejects what it should, and
+ the online estimator agrees with it on the same pairs and falls back to rate 1 where the fit rejects.
+ */
+
+#include "AccelerometerTimebase.h"
+#include "TestSupport.h"
+#include <math.h>
+
+#define kPairs	3600
+
+static uint64_t ticks[kPairs];
+static double times[kPairs];
+
+// One pair a second for an hour from a board running fast by ppm, with uniform noise of +-jitter.
+static void MakePairs(double ppm, double offset, double jitter, uint64_t seed)
+{
+	size_t i;
+	
+	for(i = 0; i < kPairs; i++)
+	{
+		double noise = jitter * (TestRandomRange(&seed, -1000000, 1000000) / 1000000.0);
+		ticks[i] = (uint64_t)(i * 1000000 + TestRandomRange(&seed, 0, 999));
+		times[i] = offset + ticks[i] / kAccelerometerTimebaseTicksPerSecond / (1.0 + ppm * 1e-6) + noise;
+	}
+}
+
+static void CheckFit(void)
+{
+	AccelerometerTimebase timebase = AccelerometerTimebaseIdentity;
+	double ppm;
+	
+	for(ppm = -200.0; ppm <= 200.0; ppm += 50.0)
+	{
+		MakePairs(ppm, 12.5, 0.0, 1);
+		CHECK(AccelerometerTimebaseFit(ticks, times, kPairs, &timebase), "no fit at %g ppm", ppm);
+		CHECK(fabs(timebase.rate * (1.0 + ppm * 1e-6) - 1.0) < 1e-12, "rate %.15f at %g ppm", timebase.rate, ppm);
+		CHECK(fabs(timebase.offset - 12.5) < 1e-9, "offset %.12f at %g ppm", timebase.offset, ppm);
+		CHECK(fabs(AccelerometerTimebaseSeconds(timebase, ticks[kPairs - 1]) - times[kPairs - 1]) < 1e-9, "last pair off at %g ppm", ppm);
+	}
+	
+	// 20 ms of jitter over an hour still pins the rate to a few ppm.
+	MakePairs(50.0, -3.0, 0.02, 2);
+	CHECK(AccelerometerTimebaseFit(ticks, times, kPairs, &timebase), "no fit with jitter");
+	CHECK(fabs(timebase.rate * (1.0 + 50e-6) - 1.0) < 5e-6, "rate %.9f with jitter", timebase.rate);
+	printf("  fit recovers drift and offset\n");
+}
+
+static void CheckRejects(void)
+{
+	AccelerometerTimebase timebase = { 7.0, 3.0 };
+	uint64_t same[3] = { 5, 5, 5 };
+	double when[3] = { 1.0, 2.0, 3.0 };
+	
+	CHECK(!AccelerometerTimebaseFit(ticks, times, 0, &timebase), "fit without pairs");
+	CHECK(!AccelerometerTimebaseFit(ticks, times, 1, &timebase), "fit with one pair");
+	CHECK(!AccelerometerTimebaseFit(same, when, 3, &timebase), "fit with one distinct tick");
+	// 2% is past kAccelerometerTimebaseMaxSkew.
+	MakePairs(20000.0, 0.0, 0.0, 3);
+	CHECK(!AccelerometerTimebaseFit(ticks, times, kPairs, &timebase), "fit with a 2%% skew");
+	CHECK(timebase.offset == 7.0 && timebase.rate == 3.0, "rejected fit changed the timebase");
+	printf("  degenerate and skewed references rejected\n");
+}
+
+static void CheckEstimator(void)
+{
+	AccelerometerTimebaseEstimator estimator;
+	AccelerometerTimebase batch, online;
+	double mean;
+	size_t i;
+	
+	MakePairs(-80.0, 1.0e3, 0.005, 4);
+	AccelerometerTimebaseEstimatorReset(&estimator);
+	CHECK(!AccelerometerTimebaseEstimatorGet(&estimator, &online), "estimate without pairs");
+	for(i = 0; i < kPairs; i++)
+		AccelerometerTimebaseEstimatorAdd(&estimator, ticks[i] / kAccelerometerTimebaseTicksPerSecond, times[i]);
+	CHECK(AccelerometerTimebaseFit(ticks, times, kPairs, &batch), "no batch fit");
+	CHECK(AccelerometerTimebaseEstimatorGet(&estimator, &online), "no estimate");
+	CHECK(fabs(batch.rate - online.rate) < 1e-12 && fabs(batch.offset - online.offset) < 1e-9,
+		  "estimator %.15f %.12f, batch %.15f %.12f", online.rate, online.offset, batch.rate, batch.offset);
+	
+	// A single pair gives the offset at rate 1.
+	AccelerometerTimebaseEstimatorReset(&estimator);
+	AccelerometerTimebaseEstimatorAdd(&estimator, 2.0, 5.0);
+	CHECK(AccelerometerTimebaseEstimatorGet(&estimator, &online) && online.rate == 1.0 && online.offset == 3.0,
+		  "single pair gave %g, %g", online.rate, online.offset);
+	
+	// A skew the batch fit rejects falls back to rate 1 through the means of the pairs.
+	MakePairs(20000.0, 0.0, 0.0, 3);
+	AccelerometerTimebaseEstimatorReset(&estimator);
+	for(i = 0, mean = 0.0; i < kPairs; i++)
+	{
+		AccelerometerTimebaseEstimatorAdd(&estimator, ticks[i] / kAccelerometerTimebaseTicksPerSecond, times[i]);
+		mean += (times[i] - ticks[i] / kAccelerometerTimebaseTicksPerSecond) / kPairs;
+	}
+	CHECK(AccelerometerTimebaseEstimatorGet(&estimator, &online) && online.rate == 1.0 && fabs(online.offset - mean) < 1e-9,
+		  "skewed pairs gave %.15f, %.12f against %.12f", online.rate, online.offset, mean);
+	printf("  estimator matches the batch fit, falls back to rate 1 on skew\n");
+}
+
+int main(void)
+{
+	CheckFit();
+	CheckRejects();
+	CheckEstimator();
+	return 0;
+}